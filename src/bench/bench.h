@@ -0,0 +1,45 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CL_BENCH_H
+#define CL_BENCH_H
+
+#include <stdio.h>
+#include <time.h>
+
+/* Seconds of a monotonic clock. */
+static double bench_now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Prints the result of a benchmark as a line of JSON,
+ * with the extra fields, if any, appended to it. */
+static void bench_report(const char *name, size_t n, size_t ops,
+			 double seconds, const char *extra)
+{
+	printf("{\"benchmark\": \"%s\", \"n\": %zu, \"ops\": %zu, "
+	       "\"seconds\": %.6f, \"ops_per_second\": %.1f%s%s}\n",
+	       name, n, ops, seconds, seconds > 0 ? ops / seconds : 0.0,
+	       extra ? ", " : "", extra ? extra : "");
+}
+
+#endif				/* CL_BENCH_H */
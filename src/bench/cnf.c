@@ -0,0 +1,190 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include "../clumsy.h"
+#include "../cl_cnf_rep.h"
+#include "../cl_collection_rep.h"
+#include "bench.h"
+
+#define VARS 1000
+#define CLAUSES 4260
+#define EVALS 1000
+#define BATCH 100000
+#define GENERATE 100000
+#define COUNT_VARS 20
+#define UPDATES 100000
+
+static void report_generate(const char *name, cl_cnf_t * cnf, double seconds)
+{
+	size_t clauses = cl_collection_count(cnf->_set);
+	bench_report(name, clauses, clauses, seconds, NULL);
+}
+
+int main()
+{
+	cl_object_pool_push();
+
+	/* planted 3-SAT is satisfied by the assignment left behind,
+	 * so that the evaluation has to go through all of the clauses */
+	cl_cnf_t *cnf = cl_cnf_planted(VARS, (double)CLAUSES / VARS, 3, 1, NULL);
+
+	size_t count = 0;
+	char extra[64];
+	double start = bench_now();
+	for (size_t i = 0; i < EVALS; i++) {
+		count += cl_cnf_evaluate(cnf);
+	}
+	bench_report("cnf_evaluate", CLAUSES, EVALS, bench_now() - start,
+		     NULL);
+
+	/* a batch of assignments, near the satisfying one,
+	 * on one thread and on one thread per processor */
+	cl_collection_t *vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf_planted(VARS, (double)CLAUSES / VARS, 3, 1, vars);
+
+	size_t stride = (VARS + 63) / 64;
+	uint64_t *assignments = calloc(BATCH * stride, sizeof(uint64_t));
+	for (size_t r = 0; r < BATCH; r++) {
+		for (size_t j = 0; j < VARS; j++) {
+			cl_cnf_literal_t *var = cl_collection_get(vars, j);
+			uint64_t value = cl_cnf_literal_value(var) ^
+			    (rand() % VARS == 0);
+			assignments[r * stride + j / 64] |= value << j % 64;
+		}
+	}
+
+	size_t nthreads[] = { 1, 0 };
+	for (size_t i = 0; i < 2; i++) {
+		start = bench_now();
+		size_t models = cl_cnf_evaluate_batch(cnf, vars, assignments,
+						      BATCH, NULL, NULL,
+						      nthreads[i]);
+		sprintf(extra, "\"models\": %zu", models);
+		bench_report(nthreads[i] ? "cnf_evaluate_batch_1" :
+			     "cnf_evaluate_batch", CLAUSES, BATCH,
+			     bench_now() - start, extra);
+	}
+	free(assignments);
+
+	cl_object_pool_pop();
+
+	/* model counting, bit-parallel and one assignment at a time */
+	cl_object_pool_push();
+
+	vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+			     CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf_random(COUNT_VARS, 2, 3, 1, vars);
+
+	start = bench_now();
+	uint64_t models = cl_cnf_count_models(cnf, vars, NULL);
+	sprintf(extra, "\"models\": %" PRIu64, models);
+	bench_report("cnf_count_models", COUNT_VARS, (size_t)1 << COUNT_VARS,
+		     bench_now() - start, extra);
+
+	models = 0;
+	start = bench_now();
+	for (size_t i = 0; i < (size_t)1 << COUNT_VARS; i++) {
+		for (size_t j = 0; j < COUNT_VARS; j++) {
+			cl_cnf_literal_assign(cl_collection_get(vars, j),
+					      i >> j & 1);
+		}
+		models += cl_cnf_evaluate(cnf);
+	}
+	sprintf(extra, "\"models\": %" PRIu64, models);
+	bench_report("cnf_count_models_naive", COUNT_VARS,
+		     (size_t)1 << COUNT_VARS, bench_now() - start, extra);
+
+	cl_object_pool_pop();
+
+	/* a formula kept across many updates, removing the clauses added */
+	cl_object_pool_push();
+
+	vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+			     CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf_random(VARS, (double)CLAUSES / VARS, 3, 1, vars);
+
+	start = bench_now();
+	for (size_t i = 0; i < UPDATES; i++) {
+		cl_collection_t *clause =
+		    cl_cnf_clause_new(2, cl_collection_get(vars, i % VARS),
+				      cl_collection_get(vars, (i + 1) % VARS));
+		cl_cnf_add(cnf, clause);
+		cl_cnf_remove(cnf, clause);
+		cl_object_release(clause);
+	}
+	sprintf(extra, "\"capacity\": %zu", cnf->_set->_capacity);
+	bench_report("cnf_remove", CLAUSES, UPDATES, bench_now() - start,
+		     extra);
+
+	/* adding a copy of every clause, each one found to be a duplicate */
+	cl_cnf_compact(cnf);
+	size_t clauses = cl_collection_count(cnf->_set);
+	cl_collection_t *copies = cl_collection(clauses, CL_OBJECT_TYPE_COLLECTION,
+						0);
+	for (size_t i = 0; i < clauses; i++) {
+		cl_collection_t *clause = cl_collection_get(cnf->_set, i);
+		cl_collection_t *copy = cl_collection(3, CL_OBJECT_TYPE_CNF_LITERAL,
+						      0);
+		for (size_t j = cl_collection_count(clause); j > 0; j--) {
+			cl_collection_add(copy, cl_collection_get(clause, j - 1));
+		}
+		cl_collection_add(copies, copy);
+	}
+
+	size_t added = 0;
+	start = bench_now();
+	for (size_t i = 0; i < clauses; i++) {
+		added += cl_cnf_add(cnf, cl_collection_get(copies, i));
+	}
+	sprintf(extra, "\"added\": %zu", added);
+	bench_report("cnf_add_duplicates", clauses, clauses,
+		     bench_now() - start, extra);
+
+	cl_object_pool_pop();
+
+	/* the generators, at about 10^5 clauses each */
+	cl_object_pool_push();
+
+	start = bench_now();
+	cnf = cl_cnf_random(GENERATE / 4, 4, 3, 1, NULL);
+	report_generate("cnf_generate_random", cnf, bench_now() - start);
+
+	start = bench_now();
+	cnf = cl_cnf_planted(GENERATE / 4, 4, 3, 1, NULL);
+	report_generate("cnf_generate_planted", cnf, bench_now() - start);
+
+	start = bench_now();
+	cnf = cl_cnf_pigeonhole(24, 23, NULL);
+	report_generate("cnf_generate_pigeonhole", cnf, bench_now() - start);
+
+	start = bench_now();
+	cnf = cl_cnf_coloring(GENERATE / 16, GENERATE / 4, 3, 1, NULL);
+	report_generate("cnf_generate_coloring", cnf, bench_now() - start);
+
+	start = bench_now();
+	cnf = cl_cnf_parity(GENERATE / 8, false, 1, NULL);
+	report_generate("cnf_generate_parity", cnf, bench_now() - start);
+
+	cl_object_pool_pop();
+
+	return count == EVALS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
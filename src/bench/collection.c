@@ -0,0 +1,95 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include "../clumsy.h"
+#include "../cl_object_rep.h"
+#include "bench.h"
+
+#define N 10000
+
+static cl_object_t *objects[N];
+
+/* Adds, finds and deletes all the objects in a random order. */
+static void run(const char *name, cl_collection_flags_t flags)
+{
+	char label[64];
+	cl_collection_t *collection =
+	    cl_collection_new(0, CL_OBJECT_TYPE_OBJECT,
+			      flags | CL_COLLECTION_FLAG_AUTORESIZE);
+
+	double start = bench_now();
+	for (size_t i = 0; i < N; i++) {
+		cl_collection_add(collection, objects[i]);
+	}
+	sprintf(label, "collection_add_%s", name);
+	bench_report(label, N, N, bench_now() - start, NULL);
+
+	start = bench_now();
+	size_t found = 0;
+	for (size_t i = 0; i < N; i++) {
+		found += cl_collection_find(collection, 0, objects[i]) != SIZE_MAX;
+	}
+	sprintf(label, "collection_find_%s", name);
+	bench_report(label, N, N, bench_now() - start, NULL);
+
+	/* from the front, the worst case of the arrays */
+	start = bench_now();
+	while (cl_collection_count(collection)) {
+		cl_collection_delete(collection, 0);
+	}
+	sprintf(label, "collection_delete_%s", name);
+	bench_report(label, N, N, bench_now() - start, NULL);
+
+	if (found != N) {
+		fprintf(stderr, "%s: %zu objects found out of %d\n", name, found, N);
+		exit(EXIT_FAILURE);
+	}
+
+	cl_object_release(collection);
+}
+
+int main()
+{
+	srand(1);
+	for (size_t i = 0; i < N; i++) {
+		objects[i] = cl_object_new(sizeof(cl_object_t),
+					   CL_OBJECT_TYPE_OBJECT, NULL, NULL);
+	}
+
+	/* shuffled, so the sorted collections insert in the middle */
+	for (size_t i = N - 1; i > 0; i--) {
+		size_t j = rand() % (i + 1);
+		cl_object_t *tmp = objects[i];
+		objects[i] = objects[j];
+		objects[j] = tmp;
+	}
+
+	run("array", 0);
+	run("sorted", CL_COLLECTION_FLAG_SORTED);
+	run("unique", CL_COLLECTION_FLAG_UNIQUE);
+	run("queue", CL_COLLECTION_FLAG_QUEUE);
+
+	for (size_t i = 0; i < N; i++) {
+		cl_object_release(objects[i]);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include "../clumsy.h"
+#include "../cl_object_rep.h"
+#include "bench.h"
+
+#define N 1000000
+#define POOLS 1000
+
+int main()
+{
+	double start = bench_now();
+	for (size_t i = 0; i < N; i++) {
+		cl_object_release(cl_object_new(sizeof(cl_object_t),
+						CL_OBJECT_TYPE_OBJECT, NULL,
+						NULL));
+	}
+	bench_report("object_new_release", N, N, bench_now() - start, NULL);
+
+	/* pools of autoreleased objects */
+	start = bench_now();
+	for (size_t i = 0; i < POOLS; i++) {
+		cl_object_pool_push();
+		for (size_t j = 0; j < N / POOLS; j++) {
+			cl_object(sizeof(cl_object_t), CL_OBJECT_TYPE_OBJECT,
+				  NULL, NULL);
+		}
+		cl_object_pool_pop();
+	}
+	bench_report("object_pool_autorelease", N, N, bench_now() - start,
+		     NULL);
+
+	/* objects allocated from a zone */
+	cl_object_zone_t *zone = cl_object_zone_new(0);
+	start = bench_now();
+	cl_object_zone_push(zone);
+	for (size_t i = 0; i < N; i++) {
+		cl_object_release(cl_object_new(sizeof(cl_object_t),
+						CL_OBJECT_TYPE_OBJECT, NULL,
+						NULL));
+	}
+	cl_object_zone_pop();
+	bench_report("object_zone_new_release", N, N, bench_now() - start,
+		     NULL);
+	cl_object_zone_release(zone);
+
+	return EXIT_SUCCESS;
+}
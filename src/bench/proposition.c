@@ -0,0 +1,86 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include "../clumsy.h"
+#include "bench.h"
+
+#define DEPTH 10000
+#define LEAVES (1 << 14)
+#define EVALS 1000
+
+static bool values[LEAVES];
+
+static bool atom_op(cl_proposition_t * self)
+{
+	return *(bool *)cl_proposition_get_context(self)->argv[0];
+}
+
+static void run(const char *name, cl_proposition_t * p, size_t n)
+{
+	size_t count = 0;
+	double start = bench_now();
+	for (size_t i = 0; i < EVALS; i++) {
+		values[i % LEAVES] = !values[i % LEAVES];
+		count += cl_proposition_eval(p);
+	}
+	bench_report(name, n, EVALS, bench_now() - start, NULL);
+
+	/* keep the evaluations from being optimized out */
+	if (count > EVALS) {
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main()
+{
+	cl_object_pool_push();
+
+	srand(1);
+	for (size_t i = 0; i < LEAVES; i++) {
+		values[i] = rand() % 2;
+	}
+
+	/* a chain of alternating AND and OR */
+	cl_proposition_t *deep = cl_proposition(&atom_op, &values[0]);
+	for (size_t i = 1; i < DEPTH; i++) {
+		cl_proposition_t *atom = cl_proposition(&atom_op, &values[i]);
+		deep = i % 2 ? cl_proposition_and(atom, deep) :
+		    cl_proposition_or(atom, deep);
+	}
+	run("proposition_eval_deep", deep, cl_proposition_size(deep));
+
+	/* a balanced tree of XOR, which can't be cut short */
+	cl_proposition_t **level = malloc(LEAVES * sizeof(cl_proposition_t *));
+	for (size_t i = 0; i < LEAVES; i++) {
+		level[i] = cl_proposition(&atom_op, &values[i]);
+	}
+	for (size_t n = LEAVES; n > 1; n /= 2) {
+		for (size_t i = 0; i < n / 2; i++) {
+			level[i] = cl_proposition_xor(level[2 * i],
+						      level[2 * i + 1]);
+		}
+	}
+	run("proposition_eval_wide", level[0], cl_proposition_size(level[0]));
+	free(level);
+
+	cl_object_pool_pop();
+	return EXIT_SUCCESS;
+}
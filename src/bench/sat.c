@@ -0,0 +1,100 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include "../clumsy.h"
+#include "../cl_cnf_rep.h"
+#include "bench.h"
+
+#define VARS 200
+#define INSTANCES 20
+
+/* clause to variable ratios around the satisfiability threshold (4.26) */
+static const double ratios[] = { 3.0, 3.5, 4.0, 4.26, 4.5, 5.0, 6.0 };
+
+int main()
+{
+	for (size_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+		cl_object_pool_push();
+
+		cl_cnf_t *instances[INSTANCES];
+		for (size_t i = 0; i < INSTANCES; i++) {
+			instances[i] = cl_cnf_random(VARS, ratios[r], 3, i, NULL);
+		}
+
+		size_t satisfiable = 0, conflicts = 0;
+		double start = bench_now();
+		for (size_t i = 0; i < INSTANCES; i++) {
+			cl_sat_t *sat = cl_sat();
+			satisfiable += cl_sat_solve(sat, instances[i]) != NULL;
+
+			cl_sat_stats_t stats;
+			cl_sat_stats(sat, &stats);
+			conflicts += stats.conflicts;
+		}
+		double seconds = bench_now() - start;
+
+		char name[64], extra[128];
+		sprintf(name, "sat_solve_3sat_%.2f", ratios[r]);
+		sprintf(extra, "\"ratio\": %.2f, \"satisfiable\": %zu, "
+			"\"conflicts\": %zu", ratios[r], satisfiable, conflicts);
+		bench_report(name, VARS, INSTANCES, seconds, extra);
+
+		cl_object_pool_pop();
+	}
+
+	/* a union of independent planted instances, whole and by components */
+	for (size_t split = 0; split < 2; split++) {
+		cl_object_pool_push();
+
+		cl_cnf_t *cnf = cl_cnf();
+		for (size_t i = 0; i < INSTANCES; i++) {
+			cl_cnf_t *part = cl_cnf_planted(VARS, 4.0, 3, i, NULL);
+			for (size_t j = 0; j < cl_collection_count(part->_set); j++) {
+				cl_cnf_add(cnf, cl_collection_get(part->_set, j));
+			}
+		}
+
+		/* the time of the split alone, which the components call repeats */
+		double start = bench_now();
+		size_t components = cl_collection_count(cl_cnf_components(cnf));
+		double split_seconds = bench_now() - start;
+
+		cl_sat_t *sat = cl_sat();
+		start = bench_now();
+		bool satisfiable = split ? cl_sat_solve_components(sat, cnf, 0)
+		    != NULL : cl_sat_solve(sat, cnf) != NULL;
+		double seconds = bench_now() - start;
+
+		cl_sat_stats_t stats;
+		cl_sat_stats(sat, &stats);
+
+		char extra[160];
+		sprintf(extra, "\"components\": %zu, \"split_seconds\": %f, "
+			"\"satisfiable\": %d, \"conflicts\": %zu", components,
+			split_seconds, satisfiable, stats.conflicts);
+		bench_report(split ? "sat_solve_components" : "sat_solve_union",
+			     VARS * INSTANCES, 1, seconds, extra);
+
+		cl_object_pool_pop();
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,791 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "cl_bdd.h"
+#include "cl_bdd_rep.h"
+
+/* marks the end of a chain / free list, and the variable of the terminals */
+#define NIL UINT32_MAX
+
+/* initial sizes (powers of 2) */
+#define NODES_CHUNK 1024
+#define SUBTABLE_SIZE 64
+#define CACHE_SIZE (1 << 16)
+#define GC_THRESHOLD (1 << 16)
+
+static bool is_terminal(cl_bdd_node_t node)
+{
+	return node == CL_BDD_FALSE || node == CL_BDD_TRUE;
+}
+
+static void destructor(void *self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	cl_bdd_t *bdd = (cl_bdd_t *) self;
+
+	for (size_t i = 0; i < bdd->_nvars; i++) {
+		cl_object_release(bdd->_atoms[i]);
+		free(bdd->_subtables[i].buckets);
+	}
+
+	free(bdd->_nodes);
+	free(bdd->_atoms);
+	free(bdd->_sorted);
+	free(bdd->_perm);
+	free(bdd->_invperm);
+	free(bdd->_subtables);
+	free(bdd->_cache);
+}
+
+cl_bdd_t *cl_bdd_new()
+{
+	cl_bdd_t *res = cl_object_new(sizeof(cl_bdd_t), CL_OBJECT_TYPE_BDD,
+				      &destructor, NULL);
+
+	res->_capacity = NODES_CHUNK;
+	res->_nodes = malloc(res->_capacity * sizeof(cl_bdd_entry_t));
+	assert(res->_nodes);
+
+	/* set up the terminals and the free list */
+	for (size_t i = 0; i < res->_capacity; i++) {
+		res->_nodes[i].var = NIL;
+		res->_nodes[i].ref = 0;
+		res->_nodes[i].lo = (cl_bdd_node_t) i;
+		res->_nodes[i].hi = (cl_bdd_node_t) i;
+		res->_nodes[i].next = i + 1 < res->_capacity ? i + 1 : NIL;
+	}
+	res->_free = 2;
+	res->_count = 0;
+
+	res->_nvars = 0;
+	res->_vars_capacity = 0;
+	res->_atoms = NULL;
+	res->_sorted = NULL;
+	res->_perm = NULL;
+	res->_invperm = NULL;
+	res->_subtables = NULL;
+
+	res->_cache = malloc(CACHE_SIZE * sizeof(cl_bdd_cache_t));
+	assert(res->_cache);
+	memset(res->_cache, 0, CACHE_SIZE * sizeof(cl_bdd_cache_t));
+	res->_cache_hits = 0;
+
+	res->_gc_threshold = GC_THRESHOLD;
+	res->_reorder_threshold = GC_THRESHOLD;
+	res->_autoreorder = false;
+
+	return res;
+}
+
+static uint32_t level(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	uint32_t var = self->_nodes[node].var;
+	return var == NIL ? NIL : self->_perm[var];
+}
+
+static size_t hash(cl_bdd_node_t lo, cl_bdd_node_t hi, size_t size)
+{
+	return (lo * 12582917u + hi * 4256249u) & (size - 1);
+}
+
+static void subtable_insert(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	cl_bdd_entry_t *e = &self->_nodes[node];
+	cl_bdd_subtable_t *t = &self->_subtables[e->var];
+
+	/* grow the subtable and rehash */
+	if (t->count >= 2 * t->size) {
+		size_t size = 2 * t->size;
+		uint32_t *buckets = malloc(size * sizeof(uint32_t));
+		assert(buckets);
+		memset(buckets, 0xff, size * sizeof(uint32_t));
+
+		for (size_t i = 0; i < t->size; i++) {
+			uint32_t n = t->buckets[i];
+			while (n != NIL) {
+				uint32_t next = self->_nodes[n].next;
+				size_t h = hash(self->_nodes[n].lo,
+						self->_nodes[n].hi, size);
+				self->_nodes[n].next = buckets[h];
+				buckets[h] = n;
+				n = next;
+			}
+		}
+
+		free(t->buckets);
+		t->buckets = buckets;
+		t->size = size;
+	}
+
+	size_t h = hash(e->lo, e->hi, t->size);
+	e->next = t->buckets[h];
+	t->buckets[h] = node;
+	t->count++;
+}
+
+static void subtable_remove(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	cl_bdd_entry_t *e = &self->_nodes[node];
+	cl_bdd_subtable_t *t = &self->_subtables[e->var];
+	uint32_t *link = &t->buckets[hash(e->lo, e->hi, t->size)];
+
+	while (*link != node) {
+		assert(*link != NIL);
+		link = &self->_nodes[*link].next;
+	}
+
+	*link = e->next;
+	t->count--;
+}
+
+static void node_ref(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	if (!is_terminal(node)) {
+		self->_nodes[node].ref++;
+	}
+}
+
+static void node_free(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	self->_nodes[node].var = NIL;
+	self->_nodes[node].next = self->_free;
+	self->_free = node;
+	self->_count--;
+}
+
+/* removes a node which is no longer referenced, 
+ * together with all of its descendants which become unreferenced */
+static void kill(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	cl_bdd_node_t lo = self->_nodes[node].lo;
+	cl_bdd_node_t hi = self->_nodes[node].hi;
+
+	subtable_remove(self, node);
+	node_free(self, node);
+
+	if (!is_terminal(lo) && --self->_nodes[lo].ref == 0) {
+		kill(self, lo);
+	}
+
+	if (!is_terminal(hi) && --self->_nodes[hi].ref == 0) {
+		kill(self, hi);
+	}
+}
+
+/* returns the unique, unreferenced, node for the triple */
+static cl_bdd_node_t mk(cl_bdd_t * self, uint32_t var, cl_bdd_node_t lo,
+			cl_bdd_node_t hi)
+{
+	if (lo == hi) {
+		return lo;
+	}
+
+	/* lookup the unique table */
+	cl_bdd_subtable_t *t = &self->_subtables[var];
+	uint32_t n = t->buckets[hash(lo, hi, t->size)];
+	while (n != NIL) {
+		if (self->_nodes[n].lo == lo && self->_nodes[n].hi == hi) {
+			return n;
+		}
+		n = self->_nodes[n].next;
+	}
+
+	/* grow the node table if there are no free nodes */
+	if (self->_free == NIL) {
+		size_t capacity = 2 * self->_capacity;
+		cl_bdd_entry_t *temp =
+		    realloc(self->_nodes, capacity * sizeof(cl_bdd_entry_t));
+		assert(temp);
+
+		for (size_t i = self->_capacity; i < capacity; i++) {
+			temp[i].var = NIL;
+			temp[i].next = i + 1 < capacity ? i + 1 : NIL;
+		}
+
+		self->_nodes = temp;
+		self->_free = self->_capacity;
+		self->_capacity = capacity;
+	}
+
+	n = self->_free;
+	self->_free = self->_nodes[n].next;
+	self->_count++;
+
+	self->_nodes[n].var = var;
+	self->_nodes[n].ref = 0;
+	self->_nodes[n].lo = lo;
+	self->_nodes[n].hi = hi;
+	node_ref(self, lo);
+	node_ref(self, hi);
+	subtable_insert(self, n);
+
+	return n;
+}
+
+static void cache_clear(cl_bdd_t * self)
+{
+	memset(self->_cache, 0, CACHE_SIZE * sizeof(cl_bdd_cache_t));
+}
+
+/* the cofactors of the node with respect to the variable at the provided level */
+static cl_bdd_node_t cofactor(cl_bdd_t * self, cl_bdd_node_t node,
+			      uint32_t top, bool value)
+{
+	if (level(self, node) != top) {
+		return node;
+	}
+
+	return value ? self->_nodes[node].hi : self->_nodes[node].lo;
+}
+
+static cl_bdd_node_t ite(cl_bdd_t * self, cl_bdd_node_t f, cl_bdd_node_t g,
+			 cl_bdd_node_t h)
+{
+	/* terminal cases */
+	if (f == CL_BDD_TRUE || g == h) {
+		return g;
+	}
+
+	if (f == CL_BDD_FALSE) {
+		return h;
+	}
+
+	if (g == CL_BDD_TRUE && h == CL_BDD_FALSE) {
+		return f;
+	}
+
+	/* lookup the computed cache, f telling the empty entries,
+	 * as the result may well be FALSE */
+	size_t key = (f * 12582917u + g * 4256249u + h * 741457u)
+	    & (CACHE_SIZE - 1);
+	cl_bdd_cache_t *entry = &self->_cache[key];
+	if (entry->f == f && entry->g == g && entry->h == h) {
+		self->_cache_hits++;
+		return entry->res;
+	}
+
+	/* split on the top most variable */
+	uint32_t top = level(self, f);
+	uint32_t lg = level(self, g);
+	uint32_t lh = level(self, h);
+	top = lg < top ? lg : top;
+	top = lh < top ? lh : top;
+
+	cl_bdd_node_t t = ite(self, cofactor(self, f, top, true),
+			      cofactor(self, g, top, true),
+			      cofactor(self, h, top, true));
+	cl_bdd_node_t e = ite(self, cofactor(self, f, top, false),
+			      cofactor(self, g, top, false),
+			      cofactor(self, h, top, false));
+	cl_bdd_node_t res = mk(self, self->_invperm[top], e, t);
+
+	/* the cache might have been overwritten by the recursive calls */
+	entry = &self->_cache[key];
+	entry->f = f;
+	entry->g = g;
+	entry->h = h;
+	entry->res = res;
+
+	return res;
+}
+
+/* collects the garbage and reorders the variables if needed
+ * NOTE: should only be called at the entry of the public functions,
+ * when all the nodes of interest are referenced. */
+static void maintain(cl_bdd_t * self)
+{
+	if (self->_autoreorder && self->_count >= self->_reorder_threshold) {
+		cl_bdd_reorder(self);
+		self->_reorder_threshold = 2 * self->_count > GC_THRESHOLD
+		    ? 2 * self->_count : GC_THRESHOLD;
+	}
+
+	if (self->_count >= self->_gc_threshold) {
+		cl_bdd_gc(self);
+		if (2 * self->_count > self->_gc_threshold) {
+			self->_gc_threshold *= 2;
+		}
+	}
+}
+
+cl_bdd_node_t cl_bdd_ref(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	assert(node < self->_capacity);
+
+	node_ref(self, node);
+	return node;
+}
+
+void cl_bdd_deref(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	assert(node < self->_capacity);
+
+	if (!is_terminal(node)) {
+		assert(self->_nodes[node].ref);
+		self->_nodes[node].ref--;
+	}
+}
+
+/* orders the atomic propositions by their operator and data pointers */
+static int atom_compare(cl_proposition_t * p1, cl_proposition_t * p2)
+{
+	cl_proposition_context_t *c1 = cl_proposition_get_context(p1);
+	cl_proposition_context_t *c2 = cl_proposition_get_context(p2);
+
+	if (c1->op != c2->op) {
+		return memcmp(&c1->op, &c2->op, sizeof(c1->op));
+	}
+
+	return c1->argv[0] == c2->argv[0] ? 0 : c1->argv[0] < c2->argv[0]
+	    ? -1 : 1;
+}
+
+/* returns the variable of the atom, creating a new one if needed */
+static uint32_t variable(cl_bdd_t * self, cl_proposition_t * atom)
+{
+	/* binary search the sorted variables */
+	size_t min = 0;
+	size_t max = self->_nvars;
+	while (min < max) {
+		size_t mid = (min + max) / 2;
+		int cmp = atom_compare(atom, self->_atoms[self->_sorted[mid]]);
+		if (cmp == 0) {
+			return self->_sorted[mid];
+		}
+
+		if (cmp > 0) {
+			min = mid + 1;
+		} else {
+			max = mid;
+		}
+	}
+
+	/* make room for the new variable */
+	if (self->_nvars == self->_vars_capacity) {
+		size_t capacity = self->_vars_capacity ?
+		    2 * self->_vars_capacity : 16;
+		self->_atoms =
+		    realloc(self->_atoms, capacity * sizeof(cl_proposition_t *));
+		self->_sorted =
+		    realloc(self->_sorted, capacity * sizeof(uint32_t));
+		self->_perm = realloc(self->_perm, capacity * sizeof(uint32_t));
+		self->_invperm =
+		    realloc(self->_invperm, capacity * sizeof(uint32_t));
+		self->_subtables =
+		    realloc(self->_subtables,
+			    capacity * sizeof(cl_bdd_subtable_t));
+		assert(self->_atoms && self->_sorted && self->_perm
+		       && self->_invperm && self->_subtables);
+		self->_vars_capacity = capacity;
+	}
+
+	/* append the variable at the bottom of the order */
+	uint32_t var = self->_nvars++;
+	self->_atoms[var] = cl_object_retain(atom);
+	self->_perm[var] = var;
+	self->_invperm[var] = var;
+
+	cl_bdd_subtable_t *t = &self->_subtables[var];
+	t->size = SUBTABLE_SIZE;
+	t->count = 0;
+	t->buckets = malloc(t->size * sizeof(uint32_t));
+	assert(t->buckets);
+	memset(t->buckets, 0xff, t->size * sizeof(uint32_t));
+
+	memmove(self->_sorted + min + 1, self->_sorted + min,
+		(self->_nvars - 1 - min) * sizeof(uint32_t));
+	self->_sorted[min] = var;
+
+	return var;
+}
+
+cl_bdd_node_t cl_bdd_variable(cl_bdd_t * self, cl_proposition_t * atom)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	assert(cl_object_type_check(atom, CL_OBJECT_TYPE_PROPOSITION));
+
+	maintain(self);
+	return cl_bdd_ref(self,
+			  mk(self, variable(self, atom), CL_BDD_FALSE,
+			     CL_BDD_TRUE));
+}
+
+static cl_bdd_node_t complement(cl_bdd_t * self, cl_bdd_node_t f)
+{
+	return ite(self, f, CL_BDD_FALSE, CL_BDD_TRUE);
+}
+
+static cl_bdd_node_t construct(cl_bdd_t * self, cl_proposition_t * p)
+{
+	cl_proposition_context_t *ctx = cl_proposition_get_context(p);
+	if (!ctx || !ctx->op || ctx->op == cl_proposition_false_op) {
+		return CL_BDD_FALSE;
+	}
+
+	cl_proposition_operator_t op = ctx->op;
+	if (op == cl_proposition_true_op) {
+		return CL_BDD_TRUE;
+	}
+
+	if (op == cl_proposition_not_op) {
+		return complement(self, construct(self, ctx->argv[0]));
+	}
+
+	if (op != cl_proposition_and_op
+	    && op != cl_proposition_or_op
+	    && op != cl_proposition_imply_op
+	    && op != cl_proposition_equivalent_op
+	    && op != cl_proposition_xor_op
+	    && op != cl_proposition_nand_op
+	    && op != cl_proposition_nor_op && op != cl_proposition_nimply_op) {
+		return mk(self, variable(self, p), CL_BDD_FALSE, CL_BDD_TRUE);
+	}
+
+	/* NOTE: there is no garbage collection during the construction,
+	 * so the intermediate results don't need to be referenced */
+	cl_bdd_node_t a = construct(self, ctx->argv[0]);
+	cl_bdd_node_t b = construct(self, ctx->argv[1]);
+
+	if (op == cl_proposition_and_op) {
+		return ite(self, a, b, CL_BDD_FALSE);
+	} else if (op == cl_proposition_or_op) {
+		return ite(self, a, CL_BDD_TRUE, b);
+	} else if (op == cl_proposition_imply_op) {
+		return ite(self, a, b, CL_BDD_TRUE);
+	} else if (op == cl_proposition_equivalent_op) {
+		return ite(self, a, b, complement(self, b));
+	} else if (op == cl_proposition_xor_op) {
+		return ite(self, a, complement(self, b), b);
+	} else if (op == cl_proposition_nand_op) {
+		return ite(self, a, complement(self, b), CL_BDD_TRUE);
+	} else if (op == cl_proposition_nor_op) {
+		return ite(self, a, CL_BDD_FALSE, complement(self, b));
+	}
+
+	/* nimply */
+	return ite(self, a, complement(self, b), CL_BDD_FALSE);
+}
+
+cl_bdd_node_t cl_bdd_construct(cl_bdd_t * self, cl_proposition_t * proposition)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	maintain(self);
+	return cl_bdd_ref(self, construct(self, proposition));
+}
+
+cl_bdd_node_t cl_bdd_ite(cl_bdd_t * self, cl_bdd_node_t f, cl_bdd_node_t g,
+			 cl_bdd_node_t h)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	maintain(self);
+	return cl_bdd_ref(self, ite(self, f, g, h));
+}
+
+bool cl_bdd_eval(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	while (!is_terminal(node)) {
+		cl_bdd_entry_t *e = &self->_nodes[node];
+		node = cl_proposition_eval(self->_atoms[e->var]) ? e->hi : e->lo;
+	}
+
+	return node == CL_BDD_TRUE;
+}
+
+bool cl_bdd_satisfiable(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	return node != CL_BDD_FALSE;
+}
+
+bool cl_bdd_valid(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	return node == CL_BDD_TRUE;
+}
+
+bool cl_bdd_equivalent(cl_bdd_t * self, cl_bdd_node_t f, cl_bdd_node_t g)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	return f == g;
+}
+
+/* the probability of the function being true for random assignment */
+static double density(cl_bdd_t * self, cl_bdd_node_t node, double *memo)
+{
+	if (is_terminal(node)) {
+		return node == CL_BDD_TRUE ? 1.0 : 0.0;
+	}
+
+	if (memo[node] < 0) {
+		memo[node] = (density(self, self->_nodes[node].lo, memo)
+			      + density(self, self->_nodes[node].hi, memo)) / 2;
+	}
+
+	return memo[node];
+}
+
+double cl_bdd_count(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	double *memo = malloc(self->_capacity * sizeof(double));
+	assert(memo);
+	for (size_t i = 0; i < self->_capacity; i++) {
+		memo[i] = -1;
+	}
+
+	double res = density(self, node, memo);
+	for (size_t i = 0; i < self->_nvars; i++) {
+		res *= 2;
+	}
+	free(memo);
+
+	return res;
+}
+
+static size_t size(cl_bdd_t * self, cl_bdd_node_t node, bool *visited)
+{
+	if (visited[node]) {
+		return 0;
+	}
+
+	visited[node] = true;
+	if (is_terminal(node)) {
+		return 1;
+	}
+
+	return 1 + size(self, self->_nodes[node].lo, visited)
+	    + size(self, self->_nodes[node].hi, visited);
+}
+
+size_t cl_bdd_size(cl_bdd_t * self, cl_bdd_node_t node)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	bool *visited = calloc(self->_capacity, sizeof(bool));
+	assert(visited);
+
+	size_t res = size(self, node, visited);
+	free(visited);
+
+	return res;
+}
+
+size_t cl_bdd_live(cl_bdd_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	return self->_count;
+}
+
+size_t cl_bdd_variables(cl_bdd_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	return self->_nvars;
+}
+
+void cl_bdd_gc(cl_bdd_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	/* the children are always at lower levels,
+	 * so a single top-down pass frees the complete garbage */
+	for (size_t l = 0; l < self->_nvars; l++) {
+		cl_bdd_subtable_t *t = &self->_subtables[self->_invperm[l]];
+
+		for (size_t i = 0; i < t->size; i++) {
+			uint32_t *link = &t->buckets[i];
+			while (*link != NIL) {
+				cl_bdd_node_t n = *link;
+				cl_bdd_entry_t *e = &self->_nodes[n];
+				if (e->ref) {
+					link = &e->next;
+					continue;
+				}
+
+				*link = e->next;
+				t->count--;
+
+				if (!is_terminal(e->lo)) {
+					self->_nodes[e->lo].ref--;
+				}
+				if (!is_terminal(e->hi)) {
+					self->_nodes[e->hi].ref--;
+				}
+				node_free(self, n);
+			}
+		}
+	}
+
+	cache_clear(self);
+}
+
+/* swaps the variables at levels l and l + 1, in place.
+ * All the nodes keep representing the same functions. */
+static void swap(cl_bdd_t * self, uint32_t l)
+{
+	uint32_t x = self->_invperm[l];
+	uint32_t y = self->_invperm[l + 1];
+	cl_bdd_subtable_t *t = &self->_subtables[x];
+
+	/* detach all the nodes labeled with x */
+	size_t count = t->count;
+	uint32_t *nodes = malloc((count ? count : 1) * sizeof(uint32_t));
+	assert(nodes);
+
+	size_t k = 0;
+	for (size_t i = 0; i < t->size; i++) {
+		uint32_t n = t->buckets[i];
+		while (n != NIL) {
+			nodes[k++] = n;
+			n = self->_nodes[n].next;
+		}
+		t->buckets[i] = NIL;
+	}
+	t->count = 0;
+
+	/* the nodes not depending on y remain as they are.
+	 * They must be reinserted before creating new x nodes,
+	 * in order to keep the unique table canonical */
+	size_t affected = 0;
+	for (size_t i = 0; i < count; i++) {
+		cl_bdd_entry_t *e = &self->_nodes[nodes[i]];
+		if (self->_nodes[e->lo].var == y
+		    || self->_nodes[e->hi].var == y) {
+			nodes[affected++] = nodes[i];
+		} else {
+			subtable_insert(self, nodes[i]);
+		}
+	}
+
+	/* f = x ? (y ? f11 : f10) : (y ? f01 : f00)
+	 * becomes
+	 * f = y ? (x ? f11 : f01) : (x ? f10 : f00) */
+	for (size_t i = 0; i < affected; i++) {
+		cl_bdd_node_t f = nodes[i];
+		cl_bdd_node_t f0 = self->_nodes[f].lo;
+		cl_bdd_node_t f1 = self->_nodes[f].hi;
+		bool y0 = self->_nodes[f0].var == y;
+		bool y1 = self->_nodes[f1].var == y;
+
+		cl_bdd_node_t f00 = y0 ? self->_nodes[f0].lo : f0;
+		cl_bdd_node_t f01 = y0 ? self->_nodes[f0].hi : f0;
+		cl_bdd_node_t f10 = y1 ? self->_nodes[f1].lo : f1;
+		cl_bdd_node_t f11 = y1 ? self->_nodes[f1].hi : f1;
+
+		cl_bdd_node_t lo = mk(self, x, f00, f10);
+		node_ref(self, lo);
+		cl_bdd_node_t hi = mk(self, x, f01, f11);
+		node_ref(self, hi);
+
+		self->_nodes[f].var = y;
+		self->_nodes[f].lo = lo;
+		self->_nodes[f].hi = hi;
+		subtable_insert(self, f);
+
+		/* the old children might have become garbage */
+		if (!is_terminal(f0) && --self->_nodes[f0].ref == 0) {
+			kill(self, f0);
+		}
+		if (!is_terminal(f1) && --self->_nodes[f1].ref == 0) {
+			kill(self, f1);
+		}
+	}
+
+	free(nodes);
+
+	self->_invperm[l] = y;
+	self->_invperm[l + 1] = x;
+	self->_perm[x] = l + 1;
+	self->_perm[y] = l;
+}
+
+/* moves the variable through all the levels, and leaves it at the best one */
+static void sift(cl_bdd_t * self, uint32_t var)
+{
+	uint32_t l = self->_perm[var];
+	uint32_t best_level = l;
+	size_t best = self->_count;
+
+	/* down, stopping if the diagram grows too much */
+	while (l + 1 < self->_nvars && self->_count <= 2 * best) {
+		swap(self, l++);
+		if (self->_count < best) {
+			best = self->_count;
+			best_level = l;
+		}
+	}
+
+	/* up */
+	while (l > 0 && (l > best_level || self->_count <= 2 * best)) {
+		swap(self, --l);
+		if (self->_count < best) {
+			best = self->_count;
+			best_level = l;
+		}
+	}
+
+	/* back to the best position */
+	while (l < best_level) {
+		swap(self, l++);
+	}
+}
+
+void cl_bdd_reorder(cl_bdd_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+
+	/* the swaps assume all the nodes are referenced */
+	cl_bdd_gc(self);
+
+	size_t n = self->_nvars;
+	uint32_t *vars = malloc((n ? n : 1) * sizeof(uint32_t));
+	assert(vars);
+
+	/* sift the variables with most nodes first */
+	for (size_t i = 0; i < n; i++) {
+		size_t j = i;
+		while (j > 0 && self->_subtables[vars[j - 1]].count
+		       < self->_subtables[i].count) {
+			vars[j] = vars[j - 1];
+			j--;
+		}
+		vars[j] = i;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		sift(self, vars[i]);
+	}
+
+	free(vars);
+	cache_clear(self);
+}
+
+void cl_bdd_autoreorder_set(cl_bdd_t * self, bool enable)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_BDD));
+	self->_autoreorder = enable;
+}
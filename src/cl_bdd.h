@@ -0,0 +1,112 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CL_BDD_H
+#define CL_BDD_H
+
+#include "cl_object.h"
+#include "cl_proposition.h"
+
+/** BDD manager object type flag. */
+#define CL_OBJECT_TYPE_BDD 0x20
+
+/** Object type representing a manager of reduced ordered binary decision diagrams.
+ * All diagrams created by the same manager share their nodes,
+ * so equivalent functions are always represented by the same node. */
+typedef struct cl_bdd_s cl_bdd_t;
+
+/** Handle of a BDD node, valid only within the manager which created it. */
+typedef uint32_t cl_bdd_node_t;
+
+/** The constant FALSE node. */
+#define CL_BDD_FALSE ((cl_bdd_node_t) 0)
+
+/** The constant TRUE node. */
+#define CL_BDD_TRUE ((cl_bdd_node_t) 1)
+
+/** Initializes a new BDD manager. */
+cl_bdd_t *cl_bdd_new();
+
+/** Increases the node's reference counter.
+ * Nodes which are not referenced can be garbage collected
+ * by any subsequent call to the manager (except for the queries).
+ * @return The referenced node. */
+cl_bdd_node_t cl_bdd_ref(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Decreases the node's reference counter.
+ * The node is not freed immediately, but on the next garbage collection. */
+void cl_bdd_deref(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Returns the diagram of the atomic proposition.
+ * Atomic propositions with same operator and data pointers are mapped to the same variable.
+ * New variables are placed at the bottom of the current variable order.
+ * The proposition is retained by the manager.
+ * @return The referenced node. */
+cl_bdd_node_t cl_bdd_variable(cl_bdd_t * self, cl_proposition_t * atom);
+
+/** Constructs the diagram of the provided propositional formula.
+ * @return The referenced node. */
+cl_bdd_node_t cl_bdd_construct(cl_bdd_t * self, cl_proposition_t * proposition);
+
+/** Computes IF f THEN g ELSE h.
+ * All the logic operators can be expressed by this function,
+ * e.g. f ^ g = ITE(f, g, FALSE) and ~f = ITE(f, FALSE, TRUE).
+ * @return The referenced node. */
+cl_bdd_node_t cl_bdd_ite(cl_bdd_t * self, cl_bdd_node_t f, cl_bdd_node_t g,
+			 cl_bdd_node_t h);
+
+/** Evaluates the function by evaluating the atomic propositions on a single path. */
+bool cl_bdd_eval(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Returns wether the function has at least one satisfying assignment. */
+bool cl_bdd_satisfiable(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Returns wether the function is a tautology. */
+bool cl_bdd_valid(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Returns wether the two functions are equivalent. */
+bool cl_bdd_equivalent(cl_bdd_t * self, cl_bdd_node_t f, cl_bdd_node_t g);
+
+/** Returns the number of satisfying assignments of the function,
+ * over all the variables known to the manager. */
+double cl_bdd_count(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Returns the number of nodes in the diagram, including the terminals. */
+size_t cl_bdd_size(cl_bdd_t * self, cl_bdd_node_t node);
+
+/** Returns the number of non-terminal nodes currently allocated by the manager. */
+size_t cl_bdd_live(cl_bdd_t * self);
+
+/** Returns the number of variables known to the manager. */
+size_t cl_bdd_variables(cl_bdd_t * self);
+
+/** Frees all the nodes which are no longer referenced. */
+void cl_bdd_gc(cl_bdd_t * self);
+
+/** Reorders the variables by sifting, in order to reduce the number of live nodes.
+ * Referenced nodes remain valid and represent the same functions. */
+void cl_bdd_reorder(cl_bdd_t * self);
+
+/** Enables or disables the automatic reordering,
+ * triggered each time the number of live nodes doubles. */
+void cl_bdd_autoreorder_set(cl_bdd_t * self, bool enable);
+
+/** Returns a new, autoreleased, BDD manager. */
+#define cl_bdd() cl_object_autorelease(cl_bdd_new())
+
+#endif				/* CL_BDD_H */
@@ -0,0 +1,80 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CL_BDD_REP_H
+#define CL_BDD_REP_H
+
+#include "cl_bdd.h"
+#include "cl_object_rep.h"
+
+/** Internal BDD node. */
+typedef struct cl_bdd_entry_s cl_bdd_entry_t;
+struct cl_bdd_entry_s {
+	uint32_t var;
+	uint32_t ref;
+	cl_bdd_node_t lo;
+	cl_bdd_node_t hi;
+	uint32_t next;
+};
+
+/** Per variable unique table. */
+typedef struct cl_bdd_subtable_s cl_bdd_subtable_t;
+struct cl_bdd_subtable_s {
+	uint32_t *buckets;
+	size_t size;
+	size_t count;
+};
+
+/** ITE computed-cache entry, empty while f is 0, never a terminal there. */
+typedef struct cl_bdd_cache_s cl_bdd_cache_t;
+struct cl_bdd_cache_s {
+	cl_bdd_node_t f;
+	cl_bdd_node_t g;
+	cl_bdd_node_t h;
+	cl_bdd_node_t res;
+};
+
+struct cl_bdd_s {
+	cl_object_info_t _obj_info;
+
+	/* nodes */
+	cl_bdd_entry_t *_nodes;
+	size_t _capacity;
+	size_t _count;
+	uint32_t _free;
+
+	/* variables and their order */
+	size_t _nvars;
+	size_t _vars_capacity;
+	cl_proposition_t **_atoms;
+	uint32_t *_sorted;
+	uint32_t *_perm;
+	uint32_t *_invperm;
+	cl_bdd_subtable_t *_subtables;
+
+	/* computed cache, and the lookups answered by it */
+	cl_bdd_cache_t *_cache;
+	size_t _cache_hits;
+
+	/* automatic garbage collection and reordering */
+	size_t _gc_threshold;
+	size_t _reorder_threshold;
+	bool _autoreorder;
+};
+
+#endif				/* CL_BDD_REP_H */
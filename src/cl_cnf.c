@@ -18,15 +18,392 @@
 
 #include "cl_cnf.h"
 #include "cl_cnf_rep.h"
+#include "cl_collection_rep.h"
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
+/* clauses longer than this are not considered a part of an XOR constraint */
+#define XOR_DETECT_LIMIT 6
+
+/* the initial number of slots of the occurrence index
+ * and of the tables of the clauses, a power of 2 */
+#define INDEX_CAPACITY 64
+
+/* the longest clause scanned for a literal along with its negation,
+ * instead of looking up the literals */
+#define TAUTOLOGY_SCAN 8
+
+/* Hashes the address into a table of the capacity, a power of 2. */
+static size_t hash(const void *p, size_t capacity)
+{
+	uint64_t hash = (uintptr_t) p * 0x9e3779b97f4a7c15ull;
+	return (hash >> 32) & (capacity - 1);
+}
+
+static void index_free(cl_cnf_t * self)
+{
+	for (size_t i = 0; i < self->_index_capacity; i++) {
+		free(self->_index[i].clauses);
+	}
+
+	free(self->_index);
+	cl_object_release(self->_indexed);
+	self->_index = NULL;
+	self->_index_capacity = 0;
+	self->_index_count = 0;
+	self->_indexed = NULL;
+}
+
+/* Returns the slot of the literal, or NULL if it occurs nowhere.
+ * If insert is true a new slot is taken for it instead. */
+static cl_cnf_occurrences_t *index_slot(cl_cnf_t * self,
+					cl_cnf_literal_t * literal, bool insert)
+{
+	size_t mask = self->_index_capacity - 1;
+	size_t i = hash(literal, self->_index_capacity);
+	for (; self->_index[i].literal; i = (i + 1) & mask) {
+		if (self->_index[i].literal == literal) {
+			return &self->_index[i];
+		}
+	}
+
+	if (!insert) {
+		return NULL;
+	}
+
+	/* keep the table at most half full */
+	if (2 * (self->_index_count + 1) > self->_index_capacity) {
+		cl_cnf_occurrences_t *old = self->_index;
+		size_t capacity = self->_index_capacity;
+
+		self->_index_capacity *= 2;
+		self->_index = calloc(self->_index_capacity,
+				      sizeof(cl_cnf_occurrences_t));
+		assert(self->_index);
+
+		mask = self->_index_capacity - 1;
+		for (size_t j = 0; j < capacity; j++) {
+			if (old[j].literal) {
+				size_t k = hash(old[j].literal,
+						 self->_index_capacity);
+				while (self->_index[k].literal) {
+					k = (k + 1) & mask;
+				}
+				self->_index[k] = old[j];
+			}
+		}
+		free(old);
+
+		return index_slot(self, literal, true);
+	}
+
+	self->_index_count++;
+	self->_index[i].literal = literal;
+	return &self->_index[i];
+}
+
+static void index_add(cl_cnf_t * self, cl_collection_t * clause)
+{
+	for (size_t i = 0; i < cl_collection_count(clause); i++) {
+		cl_cnf_occurrences_t *occs =
+		    index_slot(self, cl_collection_get(clause, i), true);
+
+		if (occs->count == occs->capacity) {
+			occs->capacity = occs->capacity ? 2 * occs->capacity : 4;
+			occs->clauses = realloc(occs->clauses, occs->capacity *
+						sizeof(cl_collection_t *));
+			assert(occs->clauses);
+		}
+		occs->clauses[occs->count++] = clause;
+	}
+}
+
+static void index_remove(cl_cnf_t * self, cl_collection_t * clause)
+{
+	for (size_t i = 0; i < cl_collection_count(clause); i++) {
+		cl_cnf_occurrences_t *occs =
+		    index_slot(self, cl_collection_get(clause, i), false);
+
+		for (size_t j = 0; occs && j < occs->count; j++) {
+			if (occs->clauses[j] == clause) {
+				occs->clauses[j] = occs->clauses[--occs->count];
+				break;
+			}
+		}
+	}
+}
+
+/* Hashes the clause by its address,
+ * or by its content, the literals in their sorted order. */
+static uint64_t clauses_hash(cl_collection_t * clause, bool content)
+{
+	uint64_t res = (uintptr_t) clause;
+	if (content) {
+		res = clause->_count;
+		for (size_t i = 0; i < clause->_count; i++) {
+			res = (res ^ (uintptr_t) clause->_buffer[i])
+			    * 0x100000001b3ull;
+		}
+	}
+
+	return res * 0x9e3779b97f4a7c15ull;
+}
+
+static size_t clauses_home(cl_cnf_clauses_t * table, uint64_t hash)
+{
+	return (hash >> 32) & (table->capacity - 1);
+}
+
+static bool clauses_equal(cl_collection_t * a, cl_collection_t * b)
+{
+	return a->_count == b->_count
+	    && !memcmp(a->_buffer, b->_buffer, a->_count * sizeof(void *));
+}
+
+/* Returns the slot of the clause, or of the one of the same content,
+ * or SIZE_MAX if there is none in the table. */
+static size_t clauses_find(cl_cnf_clauses_t * table, cl_collection_t * clause,
+			   bool content)
+{
+	if (!table->count) {
+		return SIZE_MAX;
+	}
+
+	uint64_t hash = clauses_hash(clause, content);
+	size_t mask = table->capacity - 1;
+	size_t i = clauses_home(table, hash);
+	for (; table->slots[i].clause; i = (i + 1) & mask) {
+		cl_cnf_bucket_t *bucket = &table->slots[i];
+		if (bucket->hash == hash && (bucket->clause == clause
+					     || (content
+						 && clauses_equal(bucket->clause,
+								  clause)))) {
+			return i;
+		}
+	}
+
+	return SIZE_MAX;
+}
+
+static void clauses_put(cl_cnf_clauses_t * table, cl_collection_t * clause,
+			uint64_t hash)
+{
+	size_t mask = table->capacity - 1;
+	size_t i = clauses_home(table, hash);
+	while (table->slots[i].clause) {
+		i = (i + 1) & mask;
+	}
+
+	table->slots[i].clause = clause;
+	table->slots[i].hash = hash;
+	table->count++;
+}
+
+static void clauses_insert(cl_cnf_clauses_t * table, cl_collection_t * clause,
+			   bool content)
+{
+	/* keep the table at most half full */
+	if (2 * (table->count + 1) > table->capacity) {
+		cl_cnf_bucket_t *old = table->slots;
+		size_t capacity = table->capacity;
+
+		table->capacity = capacity ? 2 * capacity : INDEX_CAPACITY;
+		table->slots = calloc(table->capacity, sizeof(cl_cnf_bucket_t));
+		assert(table->slots);
+
+		table->count = 0;
+		for (size_t i = 0; i < capacity; i++) {
+			if (old[i].clause) {
+				clauses_put(table, old[i].clause, old[i].hash);
+			}
+		}
+		free(old);
+	}
+
+	clauses_put(table, clause, clauses_hash(clause, content));
+}
+
+/* Takes the clause out of the table, shifting back the ones after it,
+ * so that no probe sequence gets broken. */
+static void clauses_erase(cl_cnf_clauses_t * table, size_t slot)
+{
+	size_t mask = table->capacity - 1;
+	size_t i = slot;
+
+	table->slots[i].clause = NULL;
+	table->count--;
+	for (size_t j = (i + 1) & mask; table->slots[j].clause;
+	     j = (j + 1) & mask) {
+		size_t home = clauses_home(table, table->slots[j].hash);
+
+		/* the clause at j may move to i, unless its home lies in (i, j] */
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			table->slots[i] = table->slots[j];
+			table->slots[j].clause = NULL;
+			i = j;
+		}
+	}
+}
+
+static void clauses_free(cl_cnf_clauses_t * table)
+{
+	free(table->slots);
+	table->slots = NULL;
+	table->capacity = 0;
+	table->count = 0;
+}
+
+/* Builds the table of the clauses by their content, unless it is up to date.
+ * Of the clauses of the same content only the first one is kept. */
+static void contents_build(cl_cnf_t * self)
+{
+	if (self->_hashed == self->_set) {
+		return;
+	}
+
+	cl_cnf_compact(self);
+	clauses_free(&self->_contents);
+	for (size_t i = 0; i < cl_collection_count(self->_set); i++) {
+		cl_collection_t *clause = cl_collection_get(self->_set, i);
+		if (clauses_find(&self->_contents, clause, true) == SIZE_MAX) {
+			clauses_insert(&self->_contents, clause, true);
+		}
+	}
+
+	cl_object_release(self->_hashed);
+	self->_hashed = cl_object_retain(self->_set);
+}
+
+static void list_free(cl_cnf_t * self)
+{
+	free(self->_list);
+	cl_object_release(self->_listed);
+	self->_list = NULL;
+	self->_list_count = 0;
+	self->_list_capacity = 0;
+	self->_listed = NULL;
+}
+
+/* Appends the literals of the clause to the list, ended by NULL. */
+static void list_add(cl_cnf_t * self, cl_collection_t * clause)
+{
+	size_t count = cl_collection_count(clause);
+	if (self->_list_count + count + 1 > self->_list_capacity) {
+		size_t capacity = 2 * self->_list_capacity + count + 1;
+		self->_list = realloc(self->_list,
+				      capacity * sizeof(cl_cnf_literal_t *));
+		assert(self->_list);
+		self->_list_capacity = capacity;
+	}
+
+	cl_cnf_literal_t **list = self->_list + self->_list_count;
+	memcpy(list, clause->_buffer, count * sizeof(cl_cnf_literal_t *));
+	list[count] = NULL;
+	self->_list_count += count + 1;
+}
+
+/* Lists the literals of the clauses, unless the list is up to date. */
+static void list_build(cl_cnf_t * self)
+{
+	if (self->_listed == self->_set) {
+		return;
+	}
+
+	cl_cnf_compact(self);
+	list_free(self);
+	for (size_t i = 0; i < cl_collection_count(self->_set); i++) {
+		list_add(self, cl_collection_get(self->_set, i));
+	}
+
+	self->_listed = cl_object_retain(self->_set);
+}
+
+/* Marks the clause of the formula as removed. */
+static void removed_mark(cl_cnf_t * self, cl_collection_t * clause)
+{
+	clauses_insert(&self->_removed, clause, false);
+	self->_removals++;
+
+	if (self->_hashed == self->_set) {
+		size_t slot = clauses_find(&self->_contents, clause, true);
+		if (slot != SIZE_MAX && self->_contents.slots[slot].clause == clause) {
+			clauses_erase(&self->_contents, slot);
+		}
+	}
+
+	if (self->_indexed == self->_set) {
+		index_remove(self, clause);
+	}
+
+	/* the list is rather built again */
+	list_free(self);
+}
+
+/* Checks whether the clause holds a literal along with its negation. */
+static bool tautology(cl_collection_t * clause)
+{
+	void **lits = clause->_buffer;
+	size_t count = clause->_count;
+
+	for (size_t i = 0; i < count; i++) {
+		cl_cnf_literal_t *lit = lits[i];
+		if (!lit->_negation) {
+			continue;
+		}
+
+		/* the short clauses are scanned, the long ones bisected */
+		if (count <= TAUTOLOGY_SCAN) {
+			for (size_t j = 0; j < count; j++) {
+				if (lits[j] == lit->_dual) {
+					return true;
+				}
+			}
+		} else if (bsearch(&lit->_dual, lits, count, sizeof(void *),
+				   clause->_comparator)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Builds the index, unless it is up to date. */
+static void index_build(cl_cnf_t * self)
+{
+	if (self->_indexed == self->_set) {
+		return;
+	}
+
+	cl_cnf_compact(self);
+	index_free(self);
+	self->_index_capacity = INDEX_CAPACITY;
+	self->_index = calloc(self->_index_capacity,
+			      sizeof(cl_cnf_occurrences_t));
+	assert(self->_index);
+	self->_indexed = cl_object_retain(self->_set);
+
+	for (size_t i = 0; i < cl_collection_count(self->_set); i++) {
+		index_add(self, cl_collection_get(self->_set, i));
+	}
+}
+
 static void cnf_destructor(void *self)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
 
 	cl_cnf_t *cnf = (cl_cnf_t *) self;
 	cl_object_release(cnf->_set);
+	cl_object_release(cnf->_xors);
+	cl_object_release(cnf->_cards);
+	free(cnf->_bounds);
+	cl_object_release(cnf->_eliminated);
+	cl_object_release(cnf->_witnesses);
+	index_free(cnf);
+	clauses_free(&cnf->_removed);
+	cl_object_release(cnf->_hashed);
+	clauses_free(&cnf->_contents);
+	list_free(cnf);
 }
 
 static void literal_destructor(void *self)
@@ -36,57 +413,44 @@ static void literal_destructor(void *self)
 	cl_cnf_literal_t *lit = (cl_cnf_literal_t *) self;
 	cl_object_release(lit->_proposition);
 	if (lit->_dual) {
+		/* an orphaned negation becomes a variable, keeping its value */
+		if (!lit->_negation) {
+			lit->_dual->_value = !lit->_value;
+		}
 		lit->_dual->_dual = NULL;
 		lit->_dual->_negation = false;
 	}
 }
 
-static char *cnf_printer(void *self)
+/* The value is kept by the variable only, a negation flips it. */
+static bool literal_value(cl_cnf_literal_t * lit)
+{
+	return lit->_negation ? !lit->_dual->_value : lit->_value;
+}
+
+static void cnf_printer(void *self, cl_object_stream_t * stream)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
 	cl_cnf_t *cnf = (cl_cnf_t *) self;
 
-	return cl_object_to_string(cnf->_set);
+	cl_cnf_compact(cnf);
+	cl_object_write(cnf->_set, stream);
 }
 
-static char *literal_printer(void *self)
+static void literal_printer(void *self, cl_object_stream_t * stream)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF_LITERAL));
 	cl_cnf_literal_t *lit = (cl_cnf_literal_t *) self;
 
-	char *buffer = NULL;
-
 	if (lit->_negation) {
 		assert(lit->_dual);
-		char *temp = cl_object_to_string(lit->_dual);
-		size_t len = strlen(temp) + 2;
-		buffer = malloc(sizeof(char) * len);
-		assert(buffer);
-
-		strcpy(buffer, "~");
-		strcpy(buffer + 1, temp);
-
-		free(temp);
-		return buffer;
+		cl_object_stream_puts(stream, "~");
+		cl_object_write(lit->_dual, stream);
+		return;
 	}
 
-	char *temp = cl_object_printer(lit);
-	size_t len1 = strlen(temp);
-	size_t len = len1;
-	len += lit->_value ? 10 : 11;
-	buffer = malloc(sizeof(char) * len);
-	assert(buffer);
-
-	strcpy(buffer, "[");
-	strcpy(buffer + 1, temp);
-	if (lit->_value) {
-		strcpy(buffer + len1 + 1, " : TRUE]");
-	} else {
-		strcpy(buffer + len1 + 1, " : FALSE]");
-	}
-
-	free(temp);
-	return buffer;
+	cl_object_stream_printf(stream, "[%p : %s]", (void *)lit,
+				lit->_value ? "TRUE" : "FALSE");
 }
 
 cl_cnf_t *cl_cnf_new()
@@ -98,6 +462,27 @@ cl_cnf_t *cl_cnf_new()
 	self->_set = cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
 				       CL_COLLECTION_FLAG_UNIQUE |
 				       CL_COLLECTION_FLAG_AUTORESIZE);
+	self->_xors = cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
+					CL_COLLECTION_FLAG_AUTORESIZE);
+	self->_cards = cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
+					 CL_COLLECTION_FLAG_AUTORESIZE);
+	self->_added = 0;
+	self->_removals = 0;
+	self->_bounds = NULL;
+	self->_bounds_capacity = 0;
+	self->_eliminated = NULL;
+	self->_witnesses = NULL;
+	self->_indexed = NULL;
+	self->_index = NULL;
+	self->_index_capacity = 0;
+	self->_index_count = 0;
+	memset(&self->_removed, 0, sizeof(cl_cnf_clauses_t));
+	self->_hashed = NULL;
+	memset(&self->_contents, 0, sizeof(cl_cnf_clauses_t));
+	self->_listed = NULL;
+	self->_list = NULL;
+	self->_list_count = 0;
+	self->_list_capacity = 0;
 
 	return self;
 }
@@ -150,7 +535,6 @@ cl_cnf_literal_t *cl_cnf_literal_not(cl_cnf_literal_t * literal)
 	self->_dual = literal;
 	literal->_dual = self;
 
-	self->_value = !literal->_value;
 	self->_negation = true;
 
 	return self;
@@ -162,7 +546,449 @@ bool cl_cnf_add(cl_cnf_t * self, cl_collection_t * clause)
 	assert(cl_object_type_check(clause, CL_OBJECT_TYPE_COLLECTION));
 
 	cl_collection_flag_set(clause, CL_COLLECTION_FLAG_UNIQUE);
-	return cl_collection_add(self->_set, clause) != SIZE_MAX;
+	if (tautology(clause)) {
+		return false;
+	}
+
+	contents_build(self);
+	if (clauses_find(&self->_contents, clause, true) != SIZE_MAX) {
+		return false;
+	}
+
+	/* a removed clause still in the set is just taken back */
+	size_t slot = clauses_find(&self->_removed, clause, false);
+	if (slot != SIZE_MAX) {
+		clauses_erase(&self->_removed, slot);
+	} else if (cl_collection_add(self->_set, clause) == SIZE_MAX) {
+		return false;
+	}
+
+	self->_added++;
+	clauses_insert(&self->_contents, clause, true);
+	if (self->_indexed == self->_set) {
+		index_add(self, clause);
+	}
+	if (self->_listed == self->_set) {
+		list_add(self, clause);
+	}
+
+	return true;
+}
+
+bool cl_cnf_remove(cl_cnf_t * self, cl_collection_t * clause)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+	assert(cl_object_type_check(clause, CL_OBJECT_TYPE_COLLECTION));
+
+	if (clauses_find(&self->_removed, clause, false) != SIZE_MAX
+	    || cl_collection_find(self->_set, 0, clause) == SIZE_MAX) {
+		return false;
+	}
+
+	removed_mark(self, clause);
+
+	/* compact once the removed clauses take a half of the set */
+	if (2 * self->_removed.count > cl_collection_count(self->_set)) {
+		cl_cnf_compact(self);
+	}
+
+	return true;
+}
+
+size_t cl_cnf_remove_if(cl_cnf_t * self, cl_cnf_predicate_t predicate,
+			void *data)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	size_t res = 0;
+	cl_cnf_compact(self);
+	for (size_t i = 0; i < cl_collection_count(self->_set); i++) {
+		cl_collection_t *clause = cl_collection_get(self->_set, i);
+		if (predicate(clause, data)) {
+			removed_mark(self, clause);
+			res++;
+		}
+	}
+
+	cl_cnf_compact(self);
+	return res;
+}
+
+void cl_cnf_compact(cl_cnf_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	if (!self->_removed.count) {
+		return;
+	}
+
+	/* one pass over the set, which stays sorted */
+	cl_collection_t *set = self->_set;
+	size_t count = 0;
+	for (size_t i = 0; i < set->_count; i++) {
+		cl_collection_t *clause = set->_buffer[i];
+		if (clauses_find(&self->_removed, clause, false) != SIZE_MAX) {
+			cl_object_release(clause);
+		} else {
+			set->_buffer[count++] = clause;
+		}
+	}
+	set->_count = count;
+
+	/* give back the memory, in the chunks the set grows by */
+	size_t chunk = set->_chunk_size;
+	size_t capacity = count ? (count + chunk - 1) / chunk * chunk : chunk;
+	if (capacity < set->_capacity) {
+		void **buffer = realloc(set->_buffer, capacity * sizeof(void *));
+		if (buffer) {
+			set->_buffer = buffer;
+			set->_capacity = capacity;
+		}
+	}
+
+	clauses_free(&self->_removed);
+}
+
+bool cl_cnf_add_xor(cl_cnf_t * self, cl_collection_t * literals)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+	assert(cl_object_type_check(literals, CL_OBJECT_TYPE_COLLECTION));
+
+	cl_collection_t *xor = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_UNIQUE |
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	bool parity = true;
+
+	for (size_t i = 0; i < cl_collection_count(literals); i++) {
+		cl_cnf_literal_t *lit = cl_collection_get(literals, i);
+		if (lit->_negation) {
+			lit = lit->_dual;
+			parity = !parity;
+		}
+
+		/* x + x = 0 */
+		if (!cl_collection_remove(xor, lit)) {
+			cl_collection_add(xor, lit);
+		}
+	}
+
+	if (!parity && !cl_collection_count(xor)) {
+		return false;
+	}
+
+	/* the even parity is kept by negating one of the literals */
+	if (!parity) {
+		cl_cnf_literal_t *lit = cl_collection_get(xor, 0);
+		cl_collection_add(xor, cl_cnf_literal_not(lit));
+		cl_collection_remove(xor, lit);
+	}
+
+	cl_collection_add(self->_xors, xor);
+	return true;
+}
+
+/* Appends the cardinality constraint, of which at most k literals are true. */
+static void cards_append(cl_cnf_t * self, cl_collection_t * card, size_t k)
+{
+	size_t count = cl_collection_count(self->_cards);
+	if (count == self->_bounds_capacity) {
+		self->_bounds_capacity = count ? 2 * count : 8;
+		self->_bounds = realloc(self->_bounds, self->_bounds_capacity
+					* sizeof(size_t));
+		assert(self->_bounds);
+	}
+
+	self->_bounds[count] = k;
+	cl_collection_add(self->_cards, card);
+}
+
+bool cl_cnf_add_at_most(cl_cnf_t * self, cl_collection_t * literals, size_t k)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+	assert(cl_object_type_check(literals, CL_OBJECT_TYPE_COLLECTION));
+
+	cl_collection_t *card = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_UNIQUE |
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	bool unsatisfiable = false;
+
+	for (size_t i = 0; i < cl_collection_count(literals); i++) {
+		cl_cnf_literal_t *lit = cl_collection_get(literals, i);
+
+		/* exactly one of X and ~X is true */
+		if (lit->_dual && cl_collection_remove(card, lit->_dual)) {
+			unsatisfiable |= k == 0;
+			k -= k > 0;
+		} else {
+			cl_collection_add(card, lit);
+		}
+	}
+
+	if (unsatisfiable) {
+		cl_cnf_add(self, cl_cnf_clause(0));
+		return true;
+	}
+
+	if (k >= cl_collection_count(card)) {
+		return false;
+	}
+
+	cards_append(self, card, k);
+	return true;
+}
+
+bool cl_cnf_add_at_least(cl_cnf_t * self, cl_collection_t * literals,
+			 size_t k)
+{
+	assert(cl_object_type_check(literals, CL_OBJECT_TYPE_COLLECTION));
+
+	size_t n = cl_collection_count(literals);
+	if (k > n) {
+		cl_cnf_add(self, cl_cnf_clause(0));
+		return true;
+	}
+
+	cl_collection_t *negations =
+	    cl_collection(n, CL_OBJECT_TYPE_CNF_LITERAL,
+			  CL_COLLECTION_FLAG_AUTORESIZE);
+	for (size_t i = 0; i < n; i++) {
+		cl_collection_add(negations,
+				  cl_cnf_literal_not(cl_collection_get
+						     (literals, i)));
+	}
+
+	return cl_cnf_add_at_most(self, negations, n - k);
+}
+
+/* Sequential counter: s[i][j] is true if at least j + 1 of the literals
+ * up to the i-th are true, and no more than k of them may be. */
+static size_t encode_sequential(cl_cnf_t * self, cl_collection_t * card,
+				size_t k)
+{
+	size_t n = cl_collection_count(card), res = 0;
+	cl_cnf_literal_t *prev[k], *next[k];
+
+	for (size_t i = 0; i < n; i++) {
+		cl_cnf_literal_t *x = cl_collection_get(card, i);
+		cl_cnf_literal_t *nx = cl_cnf_literal_not(x);
+
+		if (i + 1 < n) {
+			for (size_t j = 0; j < k; j++) {
+				next[j] = cl_cnf_literal();
+			}
+
+			/* X => S[i][0], S[i - 1][j] => S[i][j] */
+			res += cl_cnf_add(self, cl_cnf_clause(2, nx, next[0]));
+			for (size_t j = 0; i > 0 && j < k; j++) {
+				res += cl_cnf_add(self, cl_cnf_clause
+						  (2, cl_cnf_literal_not(prev[j]),
+						   next[j]));
+			}
+
+			/* X ^ S[i - 1][j - 1] => S[i][j] */
+			for (size_t j = 1; i > 0 && j < k; j++) {
+				res += cl_cnf_add(self, cl_cnf_clause
+						  (3, nx,
+						   cl_cnf_literal_not(prev[j - 1]),
+						   next[j]));
+			}
+		}
+
+		/* X => ~S[i - 1][k - 1] */
+		if (i > 0) {
+			res += cl_cnf_add(self, cl_cnf_clause
+					  (2, nx,
+					   cl_cnf_literal_not(prev[k - 1])));
+		}
+
+		memcpy(prev, next, k * sizeof(cl_cnf_literal_t *));
+	}
+
+	return res;
+}
+
+/* Totalizer: the outputs of a node are the unary sum of the literals below it,
+ * out[j] being true if at least j + 1 of them are true, up to the bound. */
+static cl_collection_t *totalize(cl_cnf_t * self, cl_collection_t * card,
+				 size_t from, size_t to, size_t bound,
+				 size_t *clauses)
+{
+	cl_collection_t *res = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	if (to - from == 1) {
+		cl_collection_add(res, cl_collection_get(card, from));
+		return res;
+	}
+
+	size_t middle = from + (to - from) / 2;
+	cl_collection_t *a = totalize(self, card, from, middle, bound, clauses);
+	cl_collection_t *b = totalize(self, card, middle, to, bound, clauses);
+	size_t na = cl_collection_count(a), nb = cl_collection_count(b);
+	size_t size = na + nb < bound ? na + nb : bound;
+
+	for (size_t i = 0; i < size; i++) {
+		cl_collection_add(res, cl_cnf_literal());
+	}
+
+	/* A[i - 1] ^ B[j - 1] => OUT[i + j - 1] */
+	for (size_t i = 0; i <= na; i++) {
+		for (size_t j = 0; j <= nb && i + j <= size; j++) {
+			if (i + j == 0) {
+				continue;
+			}
+
+			cl_collection_t *clause = cl_cnf_clause(0);
+			if (i > 0) {
+				cl_collection_add(clause, cl_cnf_literal_not
+						  (cl_collection_get(a, i - 1)));
+			}
+			if (j > 0) {
+				cl_collection_add(clause, cl_cnf_literal_not
+						  (cl_collection_get(b, j - 1)));
+			}
+			cl_collection_add(clause,
+					  cl_collection_get(res, i + j - 1));
+			*clauses += cl_cnf_add(self, clause);
+		}
+	}
+
+	return res;
+}
+
+size_t cl_cnf_encode_cards(cl_cnf_t * self, cl_cnf_encoding_t encoding)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	size_t res = 0;
+	for (size_t i = 0; i < cl_collection_count(self->_cards); i++) {
+		cl_collection_t *card = cl_collection_get(self->_cards, i);
+		size_t n = cl_collection_count(card), k = self->_bounds[i];
+
+		if (k == 0) {
+			for (size_t j = 0; j < n; j++) {
+				res += cl_cnf_add(self, cl_cnf_clause
+						  (1, cl_cnf_literal_not
+						   (cl_collection_get(card, j))));
+			}
+		} else if (encoding == CL_CNF_ENCODING_SEQUENTIAL) {
+			res += encode_sequential(self, card, k);
+		} else {
+			cl_collection_t *out =
+			    totalize(self, card, 0, n, k + 1, &res);
+			res += cl_cnf_add(self, cl_cnf_clause
+					  (1, cl_cnf_literal_not
+					   (cl_collection_get(out, k))));
+		}
+	}
+
+	cl_object_release(self->_cards);
+	self->_cards = cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
+					 CL_COLLECTION_FLAG_AUTORESIZE);
+	return res;
+}
+
+static bool is_atom_of(cl_cnf_literal_t * lit, cl_proposition_t * atom)
+{
+	cl_proposition_t *p = lit->_proposition;
+	if (!p || p == atom) {
+		return p != NULL;
+	}
+
+	cl_proposition_context_t *a = cl_proposition_get_context(p);
+	cl_proposition_context_t *b = cl_proposition_get_context(atom);
+	return a && b && a->op == b->op && a->argv[0] == b->argv[0];
+}
+
+bool cl_cnf_add_proposition_xor(cl_cnf_t * self,
+				cl_proposition_t * proposition,
+				cl_collection_t * atoms)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+	assert(cl_object_type_check(atoms, CL_OBJECT_TYPE_COLLECTION));
+
+	cl_collection_t *xor = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	bool parity = false;
+
+	/* the XOR chains can be long, so the tree is walked without recursion */
+	size_t size = 0, capacity = 16;
+	cl_proposition_t **stack = malloc(capacity * sizeof(void *));
+	assert(stack);
+	stack[size++] = proposition;
+
+	while (size) {
+		cl_proposition_t *p = stack[--size];
+		cl_proposition_context_t *ctx = cl_proposition_get_context(p);
+		cl_proposition_operator_t op = ctx ? ctx->op : NULL;
+
+		if (!op || op == cl_proposition_false_op) {
+			continue;
+		}
+
+		if (op == cl_proposition_true_op) {
+			parity = !parity;
+			continue;
+		}
+
+		if (op == cl_proposition_and_op || op == cl_proposition_or_op
+		    || op == cl_proposition_imply_op
+		    || op == cl_proposition_nand_op
+		    || op == cl_proposition_nor_op
+		    || op == cl_proposition_nimply_op) {
+			free(stack);
+			return false;
+		}
+
+		if (size + 2 > capacity) {
+			capacity *= 2;
+			stack = realloc(stack, capacity * sizeof(void *));
+			assert(stack);
+		}
+
+		if (op == cl_proposition_not_op) {
+			parity = !parity;
+			stack[size++] = ctx->argv[0];
+			continue;
+		}
+
+		if (op == cl_proposition_xor_op
+		    || op == cl_proposition_equivalent_op) {
+			parity ^= op == cl_proposition_equivalent_op;
+			stack[size++] = ctx->argv[0];
+			stack[size++] = ctx->argv[1];
+			continue;
+		}
+
+		/* atomic proposition */
+		cl_cnf_literal_t *lit = NULL;
+		for (size_t i = 0; !lit && i < cl_collection_count(atoms); i++) {
+			lit = cl_collection_get(atoms, i);
+			lit = is_atom_of(lit, p) ? lit : NULL;
+		}
+
+		if (!lit) {
+			lit = cl_cnf_literal();
+			lit->_proposition = cl_object_retain(p);
+			cl_collection_add(atoms, lit);
+		}
+		cl_collection_add(xor, lit);
+	}
+	free(stack);
+
+	/* the proposition holds when the atoms sum up to the opposite
+	 * of the parity collected, and a literal along with its negation
+	 * flips the parity of the constraint */
+	if (parity && cl_collection_count(xor)) {
+		cl_cnf_literal_t *lit = cl_collection_get(xor, 0);
+		cl_collection_add(xor, lit);
+		cl_collection_add(xor, cl_cnf_literal_not(lit));
+	}
+
+	if (!parity || cl_collection_count(xor)) {
+		cl_cnf_add_xor(self, xor);
+	}
+
+	return true;
 }
 
 /* TODO: */
@@ -171,6 +997,167 @@ cl_cnf_t *cl_cnf_construct(cl_proposition_t * proposition)
 	return NULL;
 }
 
+typedef struct xor_candidate_s {
+	cl_collection_t *clause;
+	size_t size;
+	uintptr_t vars[XOR_DETECT_LIMIT];
+	unsigned negations;
+} xor_candidate_t;
+
+static int xor_candidate_comparator(const void *a, const void *b)
+{
+	const xor_candidate_t *x = a;
+	const xor_candidate_t *y = b;
+
+	if (x->size != y->size) {
+		return (x->size > y->size) - (x->size < y->size);
+	}
+
+	for (size_t i = 0; i < x->size; i++) {
+		if (x->vars[i] != y->vars[i]) {
+			return (x->vars[i] > y->vars[i]) - (x->vars[i] < y->vars[i]);
+		}
+	}
+
+	return (x->negations > y->negations) - (x->negations < y->negations);
+}
+
+static unsigned parity_of(unsigned mask)
+{
+	unsigned res = 0;
+	for (; mask; mask &= mask - 1) {
+		res ^= 1;
+	}
+
+	return res;
+}
+
+size_t cl_cnf_detect_xors(cl_cnf_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	cl_cnf_compact(self);
+	cl_collection_t *set = self->_set;
+	xor_candidate_t *candidates =
+	    malloc(cl_collection_count(set) * sizeof(xor_candidate_t));
+	size_t count = 0, res = 0;
+	assert(candidates || !cl_collection_count(set));
+
+	/* the clauses are grouped by their variables, in the order of the literals */
+	for (size_t i = 0; i < cl_collection_count(set); i++) {
+		cl_collection_t *clause = cl_collection_get(set, i);
+		size_t size = cl_collection_count(clause);
+		if (size < 3 || size > XOR_DETECT_LIMIT) {
+			continue;
+		}
+
+		xor_candidate_t *c = &candidates[count++];
+		c->clause = clause;
+		c->size = size;
+		c->negations = 0;
+
+		for (size_t j = 0; j < size; j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(clause, j);
+			uintptr_t var = (uintptr_t) (lit->_negation ?
+						     lit->_dual : lit);
+			bool negation = lit->_negation;
+
+			/* insertion sort, moving the negation bits along */
+			size_t k = j;
+			for (; k > 0 && c->vars[k - 1] > var; k--) {
+				c->vars[k] = c->vars[k - 1];
+			}
+			c->vars[k] = var;
+
+			unsigned low = c->negations & ((1u << k) - 1);
+			c->negations = (c->negations & ~((1u << k) - 1)) << 1
+			    | negation << k | low;
+		}
+
+		/* a variable occurring twice makes it a tautology */
+		for (size_t k = 1; k < size; k++) {
+			if (c->vars[k - 1] == c->vars[k]) {
+				count--;
+				break;
+			}
+		}
+	}
+
+	qsort(candidates, count, sizeof(xor_candidate_t),
+	      &xor_candidate_comparator);
+
+	for (size_t i = 0, j; i < count; i = j) {
+		size_t distinct[2] = { 0, 0 };
+		for (j = i; j < count
+		     && !memcmp(candidates[j].vars, candidates[i].vars,
+				candidates[i].size * sizeof(uintptr_t))
+		     && candidates[j].size == candidates[i].size; j++) {
+			if (j == i || candidates[j].negations
+			    != candidates[j - 1].negations) {
+				distinct[parity_of(candidates[j].negations)]++;
+			}
+		}
+
+		/* a clause excludes the assignment falsifying all of its literals,
+		 * so the clauses with an even number of negations
+		 * exclude the assignments of an even parity, and vice versa */
+		size_t needed = (size_t) 1 << (candidates[i].size - 1);
+		for (unsigned parity = 0; parity < 2; parity++) {
+			if (distinct[parity] != needed) {
+				continue;
+			}
+
+			cl_collection_t *xor =
+			    cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					  CL_COLLECTION_FLAG_AUTORESIZE);
+			for (size_t k = 0; k < candidates[i].size; k++) {
+				cl_collection_add(xor,
+						  (void *)candidates[i].vars[k]);
+			}
+
+			if (parity) {
+				cl_cnf_literal_t *lit = cl_collection_get(xor, 0);
+				cl_collection_add(xor, lit);
+				cl_collection_add(xor, cl_cnf_literal_not(lit));
+			}
+
+			for (size_t k = i; k < j; k++) {
+				if (parity_of(candidates[k].negations) == parity) {
+					removed_mark(self, candidates[k].clause);
+				}
+			}
+
+			cl_cnf_add_xor(self, xor);
+			res++;
+		}
+	}
+
+	free(candidates);
+	cl_cnf_compact(self);
+	return res;
+}
+
+size_t cl_cnf_occurrences(cl_cnf_t * self, cl_cnf_literal_t * literal)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+	assert(cl_object_type_check(literal, CL_OBJECT_TYPE_CNF_LITERAL));
+
+	index_build(self);
+	cl_cnf_occurrences_t *occs = index_slot(self, literal, false);
+	return occs ? occs->count : 0;
+}
+
+cl_collection_t *cl_cnf_occurrence(cl_cnf_t * self,
+				   cl_cnf_literal_t * literal, size_t index)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+	assert(cl_object_type_check(literal, CL_OBJECT_TYPE_CNF_LITERAL));
+
+	index_build(self);
+	cl_cnf_occurrences_t *occs = index_slot(self, literal, false);
+	return occs && index < occs->count ? occs->clauses[index] : NULL;
+}
+
 cl_collection_t *cl_cnf_literals(cl_cnf_t * self)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
@@ -179,31 +1166,261 @@ cl_collection_t *cl_cnf_literals(cl_cnf_t * self)
 					     CL_COLLECTION_FLAG_UNIQUE |
 					     CL_COLLECTION_FLAG_AUTORESIZE);
 
+	cl_cnf_compact(self);
 	cl_collection_t *set = self->_set;
 	for (int i = 0; i < cl_collection_count(set); i++) {
 		cl_collection_t *clause = cl_collection_get(set, i);
 		for (int j = 0; j < cl_collection_count(clause); j++) {
 			cl_cnf_literal_t *lit = cl_collection_get(clause, j);
+			cl_collection_add(res, lit->_negation ? lit->_dual : lit);
+		}
+	}
+
+	for (size_t i = 0; i < cl_collection_count(self->_xors); i++) {
+		cl_collection_t *xor = cl_collection_get(self->_xors, i);
+		for (size_t j = 0; j < cl_collection_count(xor); j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(xor, j);
+			cl_collection_add(res, lit->_negation ? lit->_dual : lit);
+		}
+	}
+
+	for (size_t i = 0; i < cl_collection_count(self->_cards); i++) {
+		cl_collection_t *card = cl_collection_get(self->_cards, i);
+		for (size_t j = 0; j < cl_collection_count(card); j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(card, j);
+			cl_collection_add(res, lit->_negation ? lit->_dual : lit);
+		}
+	}
+
+	/* the eliminated literals are still a part of the formula */
+	for (size_t i = 0; self->_eliminated
+	     && i < cl_collection_count(self->_eliminated); i++) {
+		cl_collection_t *clause =
+		    cl_collection_get(self->_eliminated, i);
+		for (size_t j = 0; j < cl_collection_count(clause); j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(clause, j);
+			cl_collection_add(res, lit->_negation ? lit->_dual : lit);
+		}
+	}
+
+	return res;
+}
+
+/* The variables of the constraints, numbered in the order they are met
+ * through an open addressing hash table from their addresses,
+ * and the forest of the components over the numbers. */
+typedef struct components_s {
+	cl_cnf_literal_t **variables;
+	size_t *numbers;
+	size_t capacity;
+	size_t *parents;
+	size_t count;
+} components_t;
+
+/* Returns the number of the variable of the literal, numbering it if new. */
+static size_t component_variable(components_t * c, cl_cnf_literal_t * literal)
+{
+	cl_cnf_literal_t *var = literal->_negation ? literal->_dual : literal;
+	size_t mask = c->capacity - 1;
+	size_t i = hash(var, c->capacity);
+	for (; c->variables[i]; i = (i + 1) & mask) {
+		if (c->variables[i] == var) {
+			return c->numbers[i];
+		}
+	}
+
+	c->variables[i] = var;
+	c->numbers[i] = c->count;
+	c->parents[c->count] = c->count;
+	return c->count++;
+}
+
+/* Finds the root of the variable, halving the path on the way. */
+static size_t component_root(size_t *parents, size_t var)
+{
+	while (parents[var] != var) {
+		parents[var] = parents[parents[var]];
+		var = parents[var];
+	}
+
+	return var;
+}
+
+/* Joins the variables of the constraint into one component. Returns
+ * the variable of its first literal, or SIZE_MAX if there are no literals. */
+static size_t component_join(components_t * c, cl_collection_t * constraint)
+{
+	size_t res = SIZE_MAX;
+	size_t root = SIZE_MAX;
+	for (size_t i = 0; i < cl_collection_count(constraint); i++) {
+		size_t var = component_variable(c,
+						cl_collection_get(constraint,
+								  i));
+		size_t other = component_root(c->parents, var);
+
+		if (res == SIZE_MAX) {
+			res = var;
+			root = other;
+		} else if (other != root) {
+			c->parents[other] = root;
+		}
+	}
 
-			if (!lit->_negation) {
-				cl_collection_add(res, lit);
+	return res;
+}
+
+cl_collection_t *cl_cnf_components(cl_cnf_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	cl_collection_t *res = cl_collection(0, CL_OBJECT_TYPE_CNF,
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	cl_cnf_compact(self);
+	cl_collection_t *kinds[] = { self->_set, self->_xors, self->_cards };
+
+	size_t total = 0;
+	size_t occurrences = 0;
+	for (size_t k = 0; k < 3; k++) {
+		for (size_t i = 0; i < cl_collection_count(kinds[k]); i++) {
+			total++;
+			occurrences +=
+			    cl_collection_count(cl_collection_get(kinds[k], i));
+		}
+	}
+
+	components_t c = { NULL, NULL, INDEX_CAPACITY, NULL, 0 };
+	while (c.capacity < 2 * occurrences) {
+		c.capacity *= 2;
+	}
+	c.variables = calloc(c.capacity, sizeof(cl_cnf_literal_t *));
+	c.numbers = malloc(c.capacity * sizeof(size_t));
+	c.parents = malloc((occurrences + 1) * sizeof(size_t));
+	size_t *firsts = malloc((total + 1) * sizeof(size_t));
+	assert(c.variables && c.numbers && c.parents && firsts);
+
+	/* the variables are looked up once, the constraints keep the first */
+	size_t j = 0;
+	for (size_t k = 0; k < 3; k++) {
+		for (size_t i = 0; i < cl_collection_count(kinds[k]); i++) {
+			firsts[j++] =
+			    component_join(&c, cl_collection_get(kinds[k], i));
+		}
+	}
+
+	/* the constraints without literals make a component of their own,
+	 * rooted at the last number, and the first one to be solved */
+	size_t n = c.count;
+	size_t *components = malloc((n + 1) * sizeof(size_t));
+	size_t *sizes = calloc(n + 1, sizeof(size_t));
+	assert(components && sizes);
+	for (size_t i = 0; i <= n; i++) {
+		components[i] = SIZE_MAX;
+	}
+	for (j = 0; j < total; j++) {
+		if (firsts[j] == SIZE_MAX) {
+			components[n] = 0;
+			cl_collection_add(res, cl_cnf());
+			break;
+		}
+	}
+
+	/* the components are numbered in the order of the formula,
+	 * and their sets sized for the clauses they get */
+	j = 0;
+	for (size_t k = 0; k < 3; k++) {
+		for (size_t i = 0; i < cl_collection_count(kinds[k]); i++) {
+			size_t root = firsts[j] == SIZE_MAX ? n
+			    : component_root(c.parents, firsts[j]);
+			if (components[root] == SIZE_MAX) {
+				components[root] = cl_collection_count(res);
+				cl_collection_add(res, cl_cnf());
+			}
+
+			firsts[j++] = components[root];
+			sizes[components[root]] += k == 0;
+		}
+	}
+
+	for (size_t i = 0; i < cl_collection_count(res); i++) {
+		cl_cnf_t *cnf = cl_collection_get(res, i);
+		if (sizes[i]) {
+			cl_object_release(cnf->_set);
+			cnf->_set = cl_collection_new(sizes[i],
+						      CL_OBJECT_TYPE_COLLECTION,
+						      CL_COLLECTION_FLAG_UNIQUE |
+						      CL_COLLECTION_FLAG_AUTORESIZE);
+		}
+	}
+
+	/* the constraints of this formula are already checked, and the set
+	 * of each component is a subsequence of the sorted set, so they are
+	 * appended in the order of the formula */
+	j = 0;
+	for (size_t k = 0; k < 3; k++) {
+		for (size_t i = 0; i < cl_collection_count(kinds[k]); i++) {
+			cl_collection_t *constraint =
+			    cl_collection_get(kinds[k], i);
+			cl_cnf_t *cnf = cl_collection_get(res, firsts[j++]);
+
+			if (k == 0) {
+				cl_collection_insert(cnf->_set,
+						     cl_collection_count(cnf->
+									 _set),
+						     constraint);
+				cnf->_added++;
+			} else if (k == 1) {
+				cl_collection_add(cnf->_xors, constraint);
+			} else {
+				cards_append(cnf, constraint,
+					     self->_bounds[i]);
 			}
 		}
 	}
 
+	free(c.variables);
+	free(c.numbers);
+	free(c.parents);
+	free(firsts);
+	free(components);
+	free(sizes);
 	return res;
 }
 
+void cl_cnf_extend(cl_cnf_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	/* the latest eliminated clauses first */
+	for (size_t i = self->_eliminated ?
+	     cl_collection_count(self->_eliminated) : 0; i > 0; i--) {
+		cl_collection_t *clause =
+		    cl_collection_get(self->_eliminated, i - 1);
+
+		bool satisfied = false;
+		for (size_t j = 0; !satisfied && j < cl_collection_count(clause);
+		     j++) {
+			satisfied = cl_cnf_literal_value(cl_collection_get
+							 (clause, j));
+		}
+
+		if (!satisfied) {
+			cl_cnf_literal_t *witness =
+			    cl_collection_get(self->_witnesses, i - 1);
+			if (witness->_negation) {
+				cl_cnf_literal_assign(witness->_dual, false);
+			} else {
+				cl_cnf_literal_assign(witness, true);
+			}
+		}
+	}
+}
+
 bool cl_cnf_literal_assign(cl_cnf_literal_t * literal, bool value)
 {
 	assert(cl_object_type_check(literal, CL_OBJECT_TYPE_CNF_LITERAL));
 
 	if (!literal->_negation) {
 		literal->_value = value;
-		if (literal->_dual) {
-			literal->_dual->_value = !value;
-		}
-
 		return true;
 	}
 
@@ -213,7 +1430,7 @@ bool cl_cnf_literal_assign(cl_cnf_literal_t * literal, bool value)
 bool cl_cnf_literal_value(cl_cnf_literal_t * literal)
 {
 	assert(cl_object_type_check(literal, CL_OBJECT_TYPE_CNF_LITERAL));
-	return literal->_value;
+	return literal_value(literal);
 }
 
 bool cl_cnf_evaluate(cl_cnf_t * self)
@@ -225,25 +1442,46 @@ bool cl_cnf_evaluate(cl_cnf_t * self)
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
 
 	bool res = true;
-	cl_collection_t *set = self->_set;
+	list_build(self);
 
-	for (int i = 0; i < cl_collection_count(set); i++) {
+	/* the clauses one after the other, the rest of a satisfied one skipped */
+	cl_cnf_literal_t **lit = self->_list;
+	cl_cnf_literal_t **end = lit + self->_list_count;
+	while (res && lit < end) {
 		bool subres = false;
-		cl_collection_t *clause = cl_collection_get(set, i);
+		for (; *lit && !subres; lit++) {
+			subres = literal_value(*lit);
+		}
 
-		for (int j = 0; j < cl_collection_count(clause); j++) {
-			cl_cnf_literal_t *lit = cl_collection_get(clause, j);
-			subres |= lit->_value;
+		for (; *lit; lit++) ;
+		lit++;
+		res = subres;
+	}
 
-			if (subres) {
-				break;
-			}
+	cl_collection_t *xors = self->_xors;
+	for (size_t i = 0; res && i < cl_collection_count(xors); i++) {
+		cl_collection_t *xor = cl_collection_get(xors, i);
+		bool parity = false;
+
+		for (size_t j = 0; j < cl_collection_count(xor); j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(xor, j);
+			parity ^= literal_value(lit);
 		}
 
-		res &= subres;
-		if (!res) {
-			break;
+		res = parity;
+	}
+
+	cl_collection_t *cards = self->_cards;
+	for (size_t i = 0; res && i < cl_collection_count(cards); i++) {
+		cl_collection_t *card = cl_collection_get(cards, i);
+		size_t count = 0;
+
+		for (size_t j = 0; j < cl_collection_count(card); j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(card, j);
+			count += literal_value(lit);
 		}
+
+		res = count <= self->_bounds[i];
 	}
 
 	return res;
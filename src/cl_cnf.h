@@ -28,6 +28,20 @@
 /** CNF LITERAL obejct type flag. */
 #define CL_OBJECT_TYPE_CNF_LITERAL 0x08
 
+/** Encoding type of the cardinality constraints into clauses. */
+typedef uint8_t cl_cnf_encoding_t;
+
+/** SEQUENTIAL counter encoding.
+ * Introduces k auxiliary literals per literal of the constraint,
+ * counting in unary the true literals seen so far, and about 2 * n * k clauses. */
+#define CL_CNF_ENCODING_SEQUENTIAL 0x00
+
+/** TOTALIZER encoding.
+ * Sums the literals up in unary along a balanced binary tree,
+ * with the counters truncated at k + 1, which gives O(n log n)
+ * auxiliary literals and O(n * k) clauses. */
+#define CL_CNF_ENCODING_TOTALIZER 0x01
+
 /** Object type representing CNF formulas. */
 typedef struct cl_cnf_s cl_cnf_t;
 
@@ -44,6 +58,80 @@ cl_cnf_t *cl_cnf_new();
  * @return true if the clause was successfully added, or false otherwise. */
 bool cl_cnf_add(cl_cnf_t * self, cl_collection_t * clause);
 
+/** Predicate over the clauses of a CNF formula, for @ref cl_cnf_remove_if. */
+typedef bool (*cl_cnf_predicate_t) (cl_collection_t * clause, void *data);
+
+/** Removes the clause from the CNF formula.
+ * The clause is only marked as removed, and dropped from the clause storage
+ * when the formula gets compacted, once the removed clauses make a half of it.
+ * Adding it back before that just clears the mark.
+ * @return true if the clause was removed, or false if it is not in the formula. */
+bool cl_cnf_remove(cl_cnf_t * self, cl_collection_t * clause);
+
+/** Removes the clauses satisfying the predicate from the CNF formula.
+ * The predicate may not modify the formula.
+ * @param data Passed along to the predicate.
+ * @return The number of clauses removed. */
+size_t cl_cnf_remove_if(cl_cnf_t * self, cl_cnf_predicate_t predicate,
+			void *data);
+
+/** Drops the removed clauses from the clause storage of the CNF formula,
+ * giving back the memory they took. It is done implicitly whenever needed. */
+void cl_cnf_compact(cl_cnf_t * self);
+
+/** Adds a native XOR constraint to the CNF formula,
+ * satisfied when an odd number of the provided literals are true.
+ * A negated literal flips the parity, so an even parity is expressed
+ * by negating one of the literals. Literals occurring twice cancel out.
+ * @param self The CNF formula.
+ * @param literals The collection of literals, which is not modified.
+ * @return true if the constraint was added, or false if it is trivially satisfied. */
+bool cl_cnf_add_xor(cl_cnf_t * self, cl_collection_t * literals);
+
+/** Adds the proposition as a native XOR constraint.
+ * The proposition has to be built of XOR, EQUIVALENT and NOT operators
+ * over the constants and the atomic propositions only.
+ * @param self The CNF formula.
+ * @param proposition The proposition to be satisfied.
+ * @param atoms A collection of literals, each bound to an atomic proposition.
+ * For the atomic propositions not bound yet, new literals are bound
+ * and added to the collection.
+ * @return false if the proposition is not a parity constraint, true otherwise. */
+bool cl_cnf_add_proposition_xor(cl_cnf_t * self,
+				cl_proposition_t * proposition,
+				cl_collection_t * atoms);
+
+/** Adds a native cardinality constraint to the CNF formula,
+ * satisfied when at most k of the provided literals are true.
+ * A literal occurring along with its negation takes one from the bound.
+ * @param self The CNF formula.
+ * @param literals The collection of literals, which is not modified.
+ * @param k The bound.
+ * @return true if the constraint was added, or false if it is trivially satisfied.
+ * A constraint which can't be satisfied is added as an empty clause. */
+bool cl_cnf_add_at_most(cl_cnf_t * self, cl_collection_t * literals, size_t k);
+
+/** Adds a native cardinality constraint to the CNF formula,
+ * satisfied when at least k of the provided literals are true.
+ * It is kept as at most n - k of the negations being true.
+ * @see cl_cnf_add_at_most */
+bool cl_cnf_add_at_least(cl_cnf_t * self, cl_collection_t * literals,
+			 size_t k);
+
+/** Replaces the cardinality constraints of the formula by clauses,
+ * for the cases where a plain CNF is needed.
+ * @param self The CNF formula.
+ * @param encoding The encoding to be used, with new auxiliary literals.
+ * @return The number of clauses added. */
+size_t cl_cnf_encode_cards(cl_cnf_t * self, cl_cnf_encoding_t encoding);
+
+/** Finds the XOR constraints encoded by the clauses of the formula
+ * and replaces the clauses by native XOR constraints.
+ * An XOR over k variables takes all the 2^(k-1) clauses over them,
+ * with an odd or with an even number of negations.
+ * @return The number of XOR constraints found. */
+size_t cl_cnf_detect_xors(cl_cnf_t * self);
+
 /** Initializes a new clause with the literals provided.
  * @param num The number of literals to be expected.
  * @param ... A list of @ref num number of literals.
@@ -53,6 +141,57 @@ cl_collection_t *cl_cnf_clause_new(size_t num, ...);
 /** Constructs a CNF formula out of the provided propositional formula. */
 cl_cnf_t *cl_cnf_construct(cl_proposition_t * proposition);
 
+/** Generates a uniform random k-SAT formula.
+ * Every clause is over k distinct variables, each negated with probability 1/2.
+ * The generators are deterministic in the seed, and create new literals
+ * for the variables, some of which may occur only negated.
+ * @param nvars The number of variables.
+ * @param ratio The clause to variable ratio, the hardest being around 4.26 for k = 3.
+ * @param k The length of the clauses, at most nvars.
+ * @param seed The seed of the random number generator.
+ * @param variables A collection the variables are appended to, in order, or NULL.
+ * @return The new formula. */
+cl_cnf_t *cl_cnf_random_new(size_t nvars, double ratio, size_t k,
+			    uint64_t seed, cl_collection_t * variables);
+
+/** Generates a random k-SAT formula satisfied by a hidden assignment.
+ * Clauses falsified by the assignment are drawn again, and the variables
+ * are left assigned to it, so the formula evaluates to true.
+ * @see cl_cnf_random_new */
+cl_cnf_t *cl_cnf_planted_new(size_t nvars, double ratio, size_t k,
+			     uint64_t seed, cl_collection_t * variables);
+
+/** Generates the pigeonhole formula, placing the pigeons into the holes
+ * with no two pigeons sharing a hole. It is unsatisfiable for more pigeons
+ * than holes, and hard for resolution based solvers.
+ * @param variables A collection the variables are appended to,
+ * pigeon by pigeon, or NULL. */
+cl_cnf_t *cl_cnf_pigeonhole_new(size_t pigeons, size_t holes,
+				cl_collection_t * variables);
+
+/** Generates the coloring of a random graph, where each node takes
+ * exactly one of the colors, and the ends of the edges take different ones.
+ * @param nodes The number of nodes.
+ * @param edges The number of edges, drawn uniformly with repetition.
+ * @param colors The number of colors.
+ * @param seed The seed of the random number generator.
+ * @param variables A collection the variables are appended to,
+ * node by node, or NULL. */
+cl_cnf_t *cl_cnf_coloring_new(size_t nodes, size_t edges, size_t colors,
+			      uint64_t seed, cl_collection_t * variables);
+
+/** Generates two chains of XORs summing up the same variables in two random orders,
+ * with auxiliary literals for the partial sums. The chains either agree on the parity,
+ * or contradict, which is hard to find out without XOR reasoning.
+ * The formula is plain CNF, @ref cl_cnf_detect_xors recovers the XORs.
+ * @param nvars The number of variables.
+ * @param satisfiable Whether the chains agree on the parity.
+ * @param seed The seed of the random number generator.
+ * @param variables A collection the variables, without the auxiliary ones,
+ * are appended to, or NULL. */
+cl_cnf_t *cl_cnf_parity_new(size_t nvars, bool satisfiable, uint64_t seed,
+			    cl_collection_t * variables);
+
 /** Initializes a new literal */
 cl_cnf_literal_t *cl_cnf_literal_new();
 
@@ -61,10 +200,63 @@ cl_cnf_literal_t *cl_cnf_literal_new();
  * by this method becomes a non-negated literal. */
 cl_cnf_literal_t *cl_cnf_literal_not(cl_cnf_literal_t * literal);
 
+/** Returns the number of the clauses the literal occurs in.
+ * A negation is a literal of its own, with its own occurrences.
+ * The first call builds an occurrence index of the formula, which is then kept
+ * up to date as the clauses are added and removed. The clauses should not be
+ * changed after they were added to the formula, or the index goes stale.
+ * @param self The CNF formula.
+ * @param literal The literal. */
+size_t cl_cnf_occurrences(cl_cnf_t * self, cl_cnf_literal_t * literal);
+
+/** Returns the clause at the index among the ones the literal occurs in,
+ * in no particular order, or NULL if the index is out of bounds.
+ * The clauses are iterated with indices below @ref cl_cnf_occurrences. */
+cl_collection_t *cl_cnf_occurrence(cl_cnf_t * self,
+				   cl_cnf_literal_t * literal, size_t index);
+
 /** Returnes a set of literals used in the CNF formula.
- * Negations are not included. */
+ * Negations are not included, but represented by their dual (non-negated) literal.
+ * The literals of the XOR and the cardinality constraints are included.
+ * The literals eliminated by @ref cl_cnf_simplify or @ref cl_cnf_probe are included as well. */
 cl_collection_t *cl_cnf_literals(cl_cnf_t * self);
 
+/** Splits the CNF formula into the components not sharing any variables.
+ * The components are new formulas, made of the clauses and the XOR and
+ * the cardinality constraints of this one, which are shared, not copied.
+ * The constraints without any literals make a component of their own, the first one.
+ * The literals eliminated by @ref cl_cnf_simplify or @ref cl_cnf_probe are left out,
+ * to be recovered by @ref cl_cnf_extend of this formula.
+ * @return A new, autoreleased, collection of the components. */
+cl_collection_t *cl_cnf_components(cl_cnf_t * self);
+
+/** Simplifies the CNF formula in place, keeping it equisatisfiable.
+ * Runs unit propagation, forward and backward subsumption, self-subsuming resolution,
+ * pure literal elimination and bounded variable elimination.
+ * The removed clauses are kept, so that a model of the simplified formula
+ * can be extended to the original one by @ref cl_cnf_extend.
+ * No clauses over the eliminated literals should be added to the formula afterwards.
+ * @param self The CNF formula.
+ * @param frozen A collection of literals which must not be eliminated, or NULL.
+ * The literals of the XOR and the cardinality constraints are never eliminated.
+ * @return false if the formula was found unsatisfiable, true otherwise. */
+bool cl_cnf_simplify(cl_cnf_t * self, cl_collection_t * frozen);
+
+/** Simplifies the CNF formula in place using its binary implication graph.
+ * Literals found equivalent by the strongly connected components of the graph
+ * are replaced by a single representative, and failed literal probing
+ * adds the units it discovers. As with @ref cl_cnf_simplify, the substituted
+ * literals are recovered by @ref cl_cnf_extend.
+ * @param self The CNF formula.
+ * @param frozen A collection of literals which must not be substituted, or NULL.
+ * The literals of the XOR and the cardinality constraints are never substituted.
+ * @return false if the formula was found unsatisfiable, true otherwise. */
+bool cl_cnf_probe(cl_cnf_t * self, cl_collection_t * frozen);
+
+/** Extends the current assignment of the literals
+ * to the ones eliminated by @ref cl_cnf_simplify or @ref cl_cnf_probe. */
+void cl_cnf_extend(cl_cnf_t * self);
+
 /** Assigns a value to the literal.
  * @param literal The literal.
  * @param value The value to be assigned.
@@ -78,12 +270,65 @@ bool cl_cnf_literal_value(cl_cnf_literal_t * literal);
 /** Evaluates the CNF formula. */
 bool cl_cnf_evaluate(cl_cnf_t * self);
 
+/** The maximum number of variables @ref cl_cnf_count_models enumerates. */
+#define CL_CNF_COUNT_LIMIT 24
+
+/** Counts the models of a small formula by evaluating all the assignments at once.
+ * Each variable is given a fixed bit pattern over the assignments, 64 to a word,
+ * and the clauses, XORs and cardinality constraints are evaluated bitwise on them.
+ * The values of the literals are neither used nor changed.
+ * @param self The CNF formula.
+ * @param variables The variables, at most @ref CL_CNF_COUNT_LIMIT of them, including all
+ * the ones of the formula, or NULL for the ones returned by @ref cl_cnf_literals.
+ * The assignment i gives the variable j the value of the bit j of i.
+ * @param table If not NULL, the truth table is stored into it, the assignment i
+ * being the bit i % 64 of the word i / 64. It takes 2^n / 64 words, at least one.
+ * @return The number of models. */
+uint64_t cl_cnf_count_models(cl_cnf_t * self, cl_collection_t * variables,
+			     uint64_t * table);
+
+/** Evaluates a batch of assignments on a pool of threads.
+ * The values of the literals are neither used nor changed,
+ * so a single formula can be evaluated by many threads at once.
+ * @param self The CNF formula.
+ * @param variables The variables, including all the ones of the formula,
+ * or NULL for the ones returned by @ref cl_cnf_literals.
+ * @param assignments A matrix with a row of (n + 63) / 64 words for each assignment,
+ * giving the variable j the value of the bit j % 64 of the word j / 64.
+ * @param count The number of assignments.
+ * @param satisfied If not NULL, the bit r % 64 of the word r / 64 is set
+ * if the assignment r satisfies the formula, and cleared otherwise.
+ * It takes (count + 63) / 64 words.
+ * @param unsatisfied If not NULL, set to the number of the clauses, XORs
+ * and cardinality constraints falsified by each of the assignments.
+ * @param nthreads The number of threads, or 0 for one per processor.
+ * @return The number of the assignments satisfying the formula. */
+size_t cl_cnf_evaluate_batch(cl_cnf_t * self, cl_collection_t * variables,
+			     const uint64_t * assignments, size_t count,
+			     uint64_t * satisfied, size_t * unsatisfied,
+			     size_t nthreads);
+
 /** Returns a new, autoreleased, CNF formula. */
 #define cl_cnf() cl_object_autorelease(cl_cnf_new())
 
 /** Returns a new, autoreleased, literal. */
 #define cl_cnf_literal() cl_object_autorelease(cl_cnf_literal_new())
 
+/** Returns a new, autoreleased, random k-SAT formula. */
+#define cl_cnf_random(...) cl_object_autorelease(cl_cnf_random_new(__VA_ARGS__))
+
+/** Returns a new, autoreleased, planted k-SAT formula. */
+#define cl_cnf_planted(...) cl_object_autorelease(cl_cnf_planted_new(__VA_ARGS__))
+
+/** Returns a new, autoreleased, pigeonhole formula. */
+#define cl_cnf_pigeonhole(...) cl_object_autorelease(cl_cnf_pigeonhole_new(__VA_ARGS__))
+
+/** Returns a new, autoreleased, graph coloring formula. */
+#define cl_cnf_coloring(...) cl_object_autorelease(cl_cnf_coloring_new(__VA_ARGS__))
+
+/** Returns a new, autoreleased, parity chains formula. */
+#define cl_cnf_parity(...) cl_object_autorelease(cl_cnf_parity_new(__VA_ARGS__))
+
 /** returns a new, autoreleased, clause. */
 #define cl_cnf_clause(...) cl_object_autorelease(cl_cnf_clause_new(__VA_ARGS__))
 
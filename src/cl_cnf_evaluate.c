@@ -0,0 +1,432 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "cl_cnf.h"
+#include "cl_cnf_rep.h"
+#include "cl_thread.h"
+
+/* The truth table is evaluated a block of words at a time.
+ * Within a block the first 6 variables vary along the bits of a word
+ * and the next 6 along the words, so the rest are constant. */
+#define BLOCK_BITS 6
+#define BLOCK (1 << BLOCK_BITS)
+#define VARYING (6 + BLOCK_BITS)
+
+/* The assignments of a batch evaluated by a single task, a multiple of 64,
+ * so that the tasks write different words of the bitmap. */
+#define BATCH_CHUNK 1024
+
+/* A flat copy of the formula, with the variables numbered by their index
+ * in the collection of variables, and a literal encoded as 2 * variable + 1
+ * if negated. The clauses, the XORs and the cardinality constraints follow
+ * each other, the constraint i taking the literals from start[i] to start[i + 1]. */
+typedef struct flat_s {
+	size_t nvars;
+	size_t nclauses;
+	size_t nxors;
+	size_t ncards;
+	size_t *bounds;
+	size_t *start;
+	uint32_t *lits;
+} flat_t;
+
+static size_t flat_count(cl_collection_t * constraints)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < cl_collection_count(constraints); i++) {
+		count += cl_collection_count(cl_collection_get(constraints, i));
+	}
+
+	return count;
+}
+
+/* The variables sorted by address, to find their index by binary search. */
+typedef struct entry_s {
+	uintptr_t var;
+	size_t index;
+} entry_t;
+
+static int entry_comparator(const void *p1, const void *p2)
+{
+	uintptr_t v1 = ((const entry_t *)p1)->var;
+	uintptr_t v2 = ((const entry_t *)p2)->var;
+
+	return (v1 > v2) - (v1 < v2);
+}
+
+static size_t flat_add(flat_t * flat, size_t index, size_t size,
+		       cl_collection_t * constraints, entry_t * entries)
+{
+	for (size_t i = 0; i < cl_collection_count(constraints); i++) {
+		cl_collection_t *constraint = cl_collection_get(constraints, i);
+
+		for (size_t j = 0; j < cl_collection_count(constraint); j++) {
+			cl_cnf_literal_t *lit = cl_collection_get(constraint, j);
+			entry_t key;
+			key.var = (uintptr_t) (lit->_negation ? lit->_dual : lit);
+
+			entry_t *entry = bsearch(&key, entries, flat->nvars,
+						 sizeof(entry_t),
+						 &entry_comparator);
+			assert(entry);
+
+			flat->lits[size++] = 2 * entry->index + lit->_negation;
+		}
+		flat->start[++index] = size;
+	}
+
+	return size;
+}
+
+static void flatten(cl_cnf_t * self, cl_collection_t * variables,
+		    flat_t * flat)
+{
+	cl_cnf_compact(self);
+	flat->nvars = cl_collection_count(variables);
+	flat->nclauses = cl_collection_count(self->_set);
+	flat->nxors = cl_collection_count(self->_xors);
+	flat->ncards = cl_collection_count(self->_cards);
+	flat->bounds = self->_bounds;
+
+	size_t n = flat->nclauses + flat->nxors + flat->ncards;
+	flat->start = malloc((n + 1) * sizeof(size_t));
+	flat->lits = malloc((flat_count(self->_set) + flat_count(self->_xors) +
+			     flat_count(self->_cards) + 1) * sizeof(uint32_t));
+	entry_t *entries = malloc((flat->nvars + 1) * sizeof(entry_t));
+	assert(flat->start && flat->lits && entries);
+
+	for (size_t i = 0; i < flat->nvars; i++) {
+		entries[i].var = (uintptr_t) cl_collection_get(variables, i);
+		entries[i].index = i;
+	}
+	qsort(entries, flat->nvars, sizeof(entry_t), &entry_comparator);
+
+	size_t size = 0;
+	flat->start[0] = 0;
+	size = flat_add(flat, 0, size, self->_set, entries);
+	size = flat_add(flat, flat->nclauses, size, self->_xors, entries);
+	flat_add(flat, flat->nclauses + flat->nxors, size, self->_cards,
+		 entries);
+
+	free(entries);
+}
+
+static void flat_free(flat_t * flat)
+{
+	free(flat->start);
+	free(flat->lits);
+}
+
+static uint64_t popcount(uint64_t x)
+{
+	x = x - ((x >> 1) & 0x5555555555555555ull);
+	x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return (x * 0x0101010101010101ull) >> 56;
+}
+
+/* Evaluates the block of words of the truth table,
+ * given the bit patterns of the varying variables. */
+static void table_block(flat_t * flat, size_t block, size_t words,
+			uint64_t patterns[VARYING][BLOCK], uint64_t * res,
+			uint64_t * counters)
+{
+	uint64_t word[BLOCK];
+
+	for (size_t w = 0; w < words; w++) {
+		res[w] = ~0ull;
+	}
+
+	/* the constant literals either satisfy the clause, or are left out */
+	for (size_t i = 0; i < flat->nclauses; i++) {
+		bool satisfied = false;
+
+		memset(word, 0, sizeof(word));
+		for (size_t j = flat->start[i];
+		     !satisfied && j < flat->start[i + 1]; j++) {
+			uint32_t var = flat->lits[j] >> 1;
+			uint64_t negation = flat->lits[j] & 1 ? ~0ull : 0;
+
+			if (var >= VARYING) {
+				satisfied = (block >> (var - VARYING) & 1) ^
+				    (negation & 1);
+				continue;
+			}
+
+			for (size_t w = 0; w < words; w++) {
+				word[w] |= patterns[var][w] ^ negation;
+			}
+		}
+
+		for (size_t w = 0; !satisfied && w < words; w++) {
+			res[w] &= word[w];
+		}
+	}
+
+	for (size_t i = flat->nclauses; i < flat->nclauses + flat->nxors; i++) {
+		uint64_t parity = 0;
+
+		memset(word, 0, sizeof(word));
+		for (size_t j = flat->start[i]; j < flat->start[i + 1]; j++) {
+			uint32_t var = flat->lits[j] >> 1;
+			uint64_t negation = flat->lits[j] & 1 ? ~0ull : 0;
+
+			if (var >= VARYING) {
+				parity ^= (block >> (var - VARYING) & 1 ? ~0ull :
+					   0) ^ negation;
+				continue;
+			}
+
+			for (size_t w = 0; w < words; w++) {
+				word[w] ^= patterns[var][w] ^ negation;
+			}
+		}
+
+		for (size_t w = 0; w < words; w++) {
+			res[w] &= word[w] ^ parity;
+		}
+	}
+
+	/* counters[c] holds the assignments with more than c literals true */
+	for (size_t i = flat->nclauses + flat->nxors;
+	     i < flat->nclauses + flat->nxors + flat->ncards; i++) {
+		size_t bound = flat->bounds[i - flat->nclauses - flat->nxors];
+		size_t seen = 0;
+
+		memset(counters, 0, (bound + 1) * BLOCK * sizeof(uint64_t));
+		for (size_t j = flat->start[i]; j < flat->start[i + 1]; j++) {
+			uint32_t var = flat->lits[j] >> 1;
+			uint64_t negation = flat->lits[j] & 1 ? ~0ull : 0;
+
+			if (var < VARYING) {
+				for (size_t w = 0; w < words; w++) {
+					word[w] = patterns[var][w] ^ negation;
+				}
+			} else {
+				uint64_t value = (block >> (var - VARYING) & 1 ?
+						  ~0ull : 0) ^ negation;
+				for (size_t w = 0; w < words; w++) {
+					word[w] = value;
+				}
+			}
+
+			seen += seen <= bound;
+			for (size_t c = seen - 1; c > 0; c--) {
+				uint64_t *counter = counters + c * BLOCK;
+				uint64_t *below = counter - BLOCK;
+				for (size_t w = 0; w < words; w++) {
+					counter[w] |= below[w] & word[w];
+				}
+			}
+			for (size_t w = 0; w < words; w++) {
+				counters[w] |= word[w];
+			}
+		}
+
+		uint64_t *exceeded = counters + bound * BLOCK;
+		for (size_t w = 0; w < words; w++) {
+			res[w] &= ~exceeded[w];
+		}
+	}
+}
+
+uint64_t cl_cnf_count_models(cl_cnf_t * self, cl_collection_t * variables,
+			     uint64_t * table)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	variables = variables ? variables : cl_cnf_literals(self);
+	assert(cl_collection_count(variables) <= CL_CNF_COUNT_LIMIT);
+
+	flat_t flat;
+	flatten(self, variables, &flat);
+
+	static const uint64_t masks[6] = {
+		0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull,
+		0xf0f0f0f0f0f0f0f0ull, 0xff00ff00ff00ff00ull,
+		0xffff0000ffff0000ull, 0xffffffff00000000ull
+	};
+	uint64_t patterns[VARYING][BLOCK];
+	for (size_t v = 0; v < VARYING; v++) {
+		for (size_t w = 0; w < BLOCK; w++) {
+			patterns[v][w] = v < 6 ? masks[v] :
+			    (w >> (v - 6) & 1 ? ~0ull : 0);
+		}
+	}
+
+	/* the sequential counters of the largest cardinality constraint */
+	size_t bound = 0;
+	for (size_t i = 0; i < flat.ncards; i++) {
+		bound = flat.bounds[i] > bound ? flat.bounds[i] : bound;
+	}
+	uint64_t *counters = malloc((bound + 1) * BLOCK * sizeof(uint64_t));
+	assert(counters);
+
+	/* with less than 6 variables only the lowest bits are used */
+	size_t nwords = flat.nvars > 6 ? (size_t)1 << (flat.nvars - 6) : 1;
+	uint64_t mask = flat.nvars >= 6 ? ~0ull :
+	    ((uint64_t) 1 << (1 << flat.nvars)) - 1;
+
+	uint64_t count = 0;
+	uint64_t res[BLOCK];
+	for (size_t block = 0; block * BLOCK < nwords; block++) {
+		size_t words = nwords < BLOCK ? nwords : BLOCK;
+		table_block(&flat, block, words, patterns, res, counters);
+
+		for (size_t w = 0; w < words; w++) {
+			res[w] &= mask;
+			count += popcount(res[w]);
+		}
+		if (table) {
+			memcpy(table + block * BLOCK, res,
+			       words * sizeof(uint64_t));
+		}
+	}
+
+	free(counters);
+	flat_free(&flat);
+	return count;
+}
+
+typedef struct batch_s {
+	flat_t *flat;
+	const uint64_t *assignments;
+	size_t stride;
+	size_t count;
+	uint64_t *satisfied;
+	size_t *unsatisfied;
+	size_t *models;
+} batch_t;
+
+/* Returns the number of the constraints falsified by the assignment,
+ * stopping at the first one unless all of them are counted. */
+static size_t falsified(flat_t * flat, const uint64_t * row, bool all)
+{
+	size_t count = 0;
+	size_t i = 0;
+
+	for (; i < flat->nclauses; i++) {
+		bool value = false;
+		for (size_t j = flat->start[i]; !value && j < flat->start[i + 1];
+		     j++) {
+			uint32_t lit = flat->lits[j];
+			value = (row[lit >> 7] >> (lit >> 1 & 63) & 1) ^ (lit & 1);
+		}
+
+		if (!value && (count++, !all)) {
+			return count;
+		}
+	}
+
+	for (; i < flat->nclauses + flat->nxors; i++) {
+		bool value = false;
+		for (size_t j = flat->start[i]; j < flat->start[i + 1]; j++) {
+			uint32_t lit = flat->lits[j];
+			value ^= (row[lit >> 7] >> (lit >> 1 & 63) & 1) ^ (lit & 1);
+		}
+
+		if (!value && (count++, !all)) {
+			return count;
+		}
+	}
+
+	for (; i < flat->nclauses + flat->nxors + flat->ncards; i++) {
+		size_t bound = flat->bounds[i - flat->nclauses - flat->nxors];
+		size_t value = 0;
+		for (size_t j = flat->start[i]; j < flat->start[i + 1]; j++) {
+			uint32_t lit = flat->lits[j];
+			value += (row[lit >> 7] >> (lit >> 1 & 63) & 1) ^ (lit & 1);
+		}
+
+		if (value > bound && (count++, !all)) {
+			return count;
+		}
+	}
+
+	return count;
+}
+
+static void batch_task(void *data, size_t index)
+{
+	batch_t *batch = (batch_t *) data;
+	size_t first = index * BATCH_CHUNK;
+	size_t last = first + BATCH_CHUNK < batch->count ?
+	    first + BATCH_CHUNK : batch->count;
+	size_t models = 0;
+
+	for (size_t r = first; r < last; r += 64) {
+		uint64_t word = 0;
+		size_t end = r + 64 < last ? r + 64 : last;
+
+		for (size_t a = r; a < end; a++) {
+			const uint64_t *row = batch->assignments + a * batch->stride;
+			size_t count = falsified(batch->flat, row,
+						 batch->unsatisfied != NULL);
+
+			if (batch->unsatisfied) {
+				batch->unsatisfied[a] = count;
+			}
+			word |= (uint64_t) !count << (a - r);
+			models += !count;
+		}
+
+		if (batch->satisfied) {
+			batch->satisfied[r / 64] = word;
+		}
+	}
+
+	batch->models[index] = models;
+}
+
+size_t cl_cnf_evaluate_batch(cl_cnf_t * self, cl_collection_t * variables,
+			     const uint64_t * assignments, size_t count,
+			     uint64_t * satisfied, size_t * unsatisfied,
+			     size_t nthreads)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	variables = variables ? variables : cl_cnf_literals(self);
+
+	flat_t flat;
+	flatten(self, variables, &flat);
+
+	size_t ntasks = (count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+	batch_t batch;
+	batch.flat = &flat;
+	batch.assignments = assignments;
+	batch.stride = (flat.nvars + 63) / 64;
+	batch.count = count;
+	batch.satisfied = satisfied;
+	batch.unsatisfied = unsatisfied;
+	batch.models = malloc((ntasks + 1) * sizeof(size_t));
+	assert(batch.models);
+
+	cl_thread_run(nthreads, ntasks, &batch_task, &batch);
+
+	size_t models = 0;
+	for (size_t i = 0; i < ntasks; i++) {
+		models += batch.models[i];
+	}
+
+	free(batch.models);
+	flat_free(&flat);
+	return models;
+}
@@ -0,0 +1,317 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include "cl_cnf.h"
+
+/* The generators draw from splitmix64, which is enough for instances
+ * and keeps them independent of rand() and of the solver's generator. */
+
+static uint64_t random_next(uint64_t * state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+static size_t random_below(uint64_t * state, size_t n)
+{
+	return random_next(state) % n;
+}
+
+static bool random_bool(uint64_t * state)
+{
+	return random_next(state) >> 63;
+}
+
+/* Creates the variables of a generated formula,
+ * appending them to the collection provided by the caller, if any. */
+static cl_cnf_literal_t **variables_new(size_t nvars,
+					cl_collection_t * variables)
+{
+	cl_cnf_literal_t **vars = malloc(nvars * sizeof(cl_cnf_literal_t *));
+	assert(vars || !nvars);
+
+	for (size_t i = 0; i < nvars; i++) {
+		vars[i] = cl_cnf_literal_new();
+		if (variables) {
+			cl_collection_add(variables, vars[i]);
+		}
+	}
+
+	return vars;
+}
+
+static void variables_release(cl_cnf_literal_t ** vars, size_t nvars)
+{
+	for (size_t i = 0; i < nvars; i++) {
+		cl_object_release(vars[i]);
+	}
+	free(vars);
+}
+
+static cl_cnf_literal_t *literal(cl_cnf_literal_t * var, bool positive)
+{
+	return positive ? var : cl_cnf_literal_not(var);
+}
+
+static cl_collection_t *clause_new(size_t size)
+{
+	return cl_collection_new(size, CL_OBJECT_TYPE_CNF_LITERAL,
+				 CL_COLLECTION_FLAG_UNIQUE |
+				 CL_COLLECTION_FLAG_AUTORESIZE);
+}
+
+static void add(cl_cnf_t * self, cl_collection_t * clause)
+{
+	cl_cnf_add(self, clause);
+	cl_object_release(clause);
+}
+
+static void add_binary(cl_cnf_t * self, cl_cnf_literal_t * a,
+		       cl_cnf_literal_t * b)
+{
+	cl_collection_t *clause = clause_new(2);
+	cl_collection_add(clause, a);
+	cl_collection_add(clause, b);
+	add(self, clause);
+}
+
+/* Draws k distinct variables, each negated with probability 1/2.
+ * When hidden is not NULL, clauses falsified by it are drawn again. */
+static cl_collection_t *random_clause(cl_cnf_literal_t ** vars, size_t nvars,
+				      size_t k, const bool *hidden,
+				      uint64_t * state, size_t *picks)
+{
+	bool satisfied;
+	do {
+		satisfied = !hidden;
+		for (size_t i = 0; i < k; i++) {
+			size_t j;
+			do {
+				picks[i] = random_below(state, nvars);
+				for (j = 0; j < i && picks[j] != picks[i]; j++) ;
+			} while (j < i);
+		}
+
+		cl_collection_t *clause = clause_new(k);
+		for (size_t i = 0; i < k; i++) {
+			bool positive = random_bool(state);
+			satisfied |= hidden && hidden[picks[i]] == positive;
+			cl_collection_add(clause, literal(vars[picks[i]], positive));
+		}
+
+		if (satisfied) {
+			return clause;
+		}
+		cl_object_release(clause);
+	} while (true);
+}
+
+static cl_cnf_t *random_cnf(size_t nvars, double ratio, size_t k,
+			    bool planted, uint64_t seed,
+			    cl_collection_t * variables)
+{
+	assert(k > 0 && k <= nvars);
+	assert(ratio >= 0);
+
+	uint64_t state = seed;
+	cl_cnf_t *self = cl_cnf_new();
+	cl_cnf_literal_t **vars = variables_new(nvars, variables);
+	size_t *picks = malloc(k * sizeof(size_t));
+	bool *hidden = NULL;
+	assert(picks);
+
+	if (planted) {
+		hidden = malloc(nvars * sizeof(bool));
+		assert(hidden);
+		for (size_t i = 0; i < nvars; i++) {
+			hidden[i] = random_bool(&state);
+			cl_cnf_literal_assign(vars[i], hidden[i]);
+		}
+	}
+
+	size_t nclauses = ratio * nvars + 0.5;
+	for (size_t i = 0; i < nclauses; i++) {
+		add(self, random_clause(vars, nvars, k, hidden, &state, picks));
+	}
+
+	free(hidden);
+	free(picks);
+	variables_release(vars, nvars);
+	return self;
+}
+
+cl_cnf_t *cl_cnf_random_new(size_t nvars, double ratio, size_t k,
+			    uint64_t seed, cl_collection_t * variables)
+{
+	return random_cnf(nvars, ratio, k, false, seed, variables);
+}
+
+cl_cnf_t *cl_cnf_planted_new(size_t nvars, double ratio, size_t k,
+			     uint64_t seed, cl_collection_t * variables)
+{
+	return random_cnf(nvars, ratio, k, true, seed, variables);
+}
+
+cl_cnf_t *cl_cnf_pigeonhole_new(size_t pigeons, size_t holes,
+				cl_collection_t * variables)
+{
+	cl_cnf_t *self = cl_cnf_new();
+	cl_cnf_literal_t **vars = variables_new(pigeons * holes, variables);
+
+	/* every pigeon sits in a hole */
+	for (size_t p = 0; p < pigeons; p++) {
+		cl_collection_t *clause = clause_new(holes);
+		for (size_t h = 0; h < holes; h++) {
+			cl_collection_add(clause, vars[p * holes + h]);
+		}
+		add(self, clause);
+	}
+
+	/* no two pigeons share a hole */
+	for (size_t h = 0; h < holes; h++) {
+		for (size_t p = 0; p < pigeons; p++) {
+			for (size_t q = p + 1; q < pigeons; q++) {
+				add_binary(self,
+					   cl_cnf_literal_not(vars
+							      [p * holes + h]),
+					   cl_cnf_literal_not(vars
+							      [q * holes + h]));
+			}
+		}
+	}
+
+	variables_release(vars, pigeons * holes);
+	return self;
+}
+
+cl_cnf_t *cl_cnf_coloring_new(size_t nodes, size_t edges, size_t colors,
+			      uint64_t seed, cl_collection_t * variables)
+{
+	assert(nodes > 1 || !edges);
+
+	uint64_t state = seed;
+	cl_cnf_t *self = cl_cnf_new();
+	cl_cnf_literal_t **vars = variables_new(nodes * colors, variables);
+
+	/* every node takes exactly one color */
+	for (size_t n = 0; n < nodes; n++) {
+		cl_cnf_literal_t **node = vars + n * colors;
+
+		cl_collection_t *clause = clause_new(colors);
+		for (size_t c = 0; c < colors; c++) {
+			cl_collection_add(clause, node[c]);
+		}
+		add(self, clause);
+
+		for (size_t c = 0; c < colors; c++) {
+			for (size_t d = c + 1; d < colors; d++) {
+				add_binary(self, cl_cnf_literal_not(node[c]),
+					   cl_cnf_literal_not(node[d]));
+			}
+		}
+	}
+
+	/* the ends of an edge take different colors */
+	for (size_t e = 0; e < edges; e++) {
+		size_t u = random_below(&state, nodes);
+		size_t v = random_below(&state, nodes - 1);
+		v += v >= u;
+
+		for (size_t c = 0; c < colors; c++) {
+			add_binary(self,
+				   cl_cnf_literal_not(vars[u * colors + c]),
+				   cl_cnf_literal_not(vars[v * colors + c]));
+		}
+	}
+
+	variables_release(vars, nodes * colors);
+	return self;
+}
+
+/* Adds the clauses of (a + b = c) */
+static void add_xor(cl_cnf_t * self, cl_cnf_literal_t * a,
+		    cl_cnf_literal_t * b, cl_cnf_literal_t * c)
+{
+	for (size_t signs = 0; signs < 8; signs++) {
+		/* the clauses with an odd number of negations */
+		if (!((signs ^ (signs >> 1) ^ (signs >> 2)) & 1)) {
+			continue;
+		}
+
+		cl_collection_t *clause = clause_new(3);
+		cl_collection_add(clause, literal(a, !(signs & 1)));
+		cl_collection_add(clause, literal(b, !(signs & 2)));
+		cl_collection_add(clause, literal(c, !(signs & 4)));
+		add(self, clause);
+	}
+}
+
+/* Adds a chain of auxiliary literals summing up the variables,
+ * in a random order, with the last one fixed to the parity. */
+static void add_chain(cl_cnf_t * self, cl_cnf_literal_t ** vars,
+		      size_t nvars, bool parity, uint64_t * state)
+{
+	cl_cnf_literal_t **order = malloc(nvars * sizeof(cl_cnf_literal_t *));
+	assert(order);
+
+	for (size_t i = 0; i < nvars; i++) {
+		order[i] = vars[i];
+	}
+	for (size_t i = nvars - 1; i > 0; i--) {
+		size_t j = random_below(state, i + 1);
+		cl_cnf_literal_t *temp = order[i];
+		order[i] = order[j];
+		order[j] = temp;
+	}
+
+	cl_cnf_literal_t *sum = order[0];
+	for (size_t i = 1; i < nvars; i++) {
+		/* retained by the clauses */
+		cl_cnf_literal_t *next = cl_cnf_literal_new();
+		add_xor(self, sum, order[i], next);
+		cl_object_release(next);
+		sum = next;
+	}
+
+	cl_collection_t *clause = clause_new(1);
+	cl_collection_add(clause, literal(sum, parity));
+	add(self, clause);
+
+	free(order);
+}
+
+cl_cnf_t *cl_cnf_parity_new(size_t nvars, bool satisfiable, uint64_t seed,
+			    cl_collection_t * variables)
+{
+	assert(nvars > 0);
+
+	uint64_t state = seed;
+	cl_cnf_t *self = cl_cnf_new();
+	cl_cnf_literal_t **vars = variables_new(nvars, variables);
+	bool parity = random_bool(&state);
+
+	add_chain(self, vars, nvars, parity, &state);
+	add_chain(self, vars, nvars, satisfiable ? parity : !parity, &state);
+
+	variables_release(vars, nvars);
+	return self;
+}
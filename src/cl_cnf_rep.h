@@ -21,11 +21,78 @@
 
 #include "cl_object_rep.h"
 
+/* The clauses a literal occurs in, an entry of the occurrence index. */
+typedef struct cl_cnf_occurrences_s {
+	cl_cnf_literal_t *literal;
+	cl_collection_t **clauses;
+	size_t count;
+	size_t capacity;
+} cl_cnf_occurrences_t;
+
+/* An open addressing hash table of clauses, keeping the hash of each one. */
+typedef struct cl_cnf_bucket_s {
+	cl_collection_t *clause;
+	uint64_t hash;
+} cl_cnf_bucket_t;
+
+typedef struct cl_cnf_clauses_s {
+	cl_cnf_bucket_t *slots;
+	size_t capacity;
+	size_t count;
+} cl_cnf_clauses_t;
+
+/* The clauses are kept in the _set, and the other constraints aside.
+ * The occurrence index and the table of the contents are built anew
+ * when cl_cnf_simplify or cl_cnf_probe replace the set. */
 struct cl_cnf_s {
 	cl_object_info_t _obj_info;
 	cl_collection_t *_set;
+
+	/* the clauses added to the set and the ones removed from it so far,
+	 * telling the solvers whether it changed since they loaded it */
+	size_t _added;
+	size_t _removals;
+
+	/* the XOR constraints, collections of literals of which an odd number
+	 * is true, and the cardinality ones, of which at most _bounds[i] are */
+	cl_collection_t *_xors;
+	cl_collection_t *_cards;
+	size_t *_bounds;
+	size_t _bounds_capacity;
+
+	/* the reconstruction stack of the clauses removed by cl_cnf_simplify,
+	 * each with the witness literal to be made true if it is falsified */
+	cl_collection_t *_eliminated;
+	cl_collection_t *_witnesses;
+
+	/* the occurrence index of the set in _indexed, an open addressing
+	 * hash table from the addresses of the literals to their clauses */
+	cl_collection_t *_indexed;
+	cl_cnf_occurrences_t *_index;
+	size_t _index_capacity;
+	size_t _index_count;
+
+	/* the clauses removed by cl_cnf_remove, by address, which stay
+	 * in the set until it gets compacted, as it does before it is replaced */
+	cl_cnf_clauses_t _removed;
+
+	/* the clauses of the set in _hashed by content, telling the duplicates */
+	cl_collection_t *_hashed;
+	cl_cnf_clauses_t _contents;
+
+	/* the literals of the clauses of the set in _listed, one clause after
+	 * the other, each ended by NULL, as read by cl_cnf_evaluate. The list
+	 * costs a pointer per occurrence on top of the clauses, as a negation
+	 * stays an object of its own, the literals being the objects held
+	 * by the clauses and returned by cl_cnf_literal_not */
+	cl_collection_t *_listed;
+	cl_cnf_literal_t **_list;
+	size_t _list_count;
+	size_t _list_capacity;
 };
 
+/* A negated literal is linked to its variable through _dual,
+ * and the value is kept by the variable only. */
 struct cl_cnf_literal_s {
 	cl_object_info_t _obj_info;
 	cl_proposition_t *_proposition;
@@ -0,0 +1,1067 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "cl_cnf.h"
+#include "cl_cnf_rep.h"
+
+#define NIL UINT32_MAX
+
+#define VALUE_FALSE 0
+#define VALUE_TRUE 1
+#define VALUE_UNDEF 2
+
+/* variables occurring more often on both sides are not eliminated */
+#define ELIMINATE_OCCURRENCE_LIMIT 16
+
+/* elimination is not allowed to produce clauses longer than this */
+#define ELIMINATE_RESOLVENT_LIMIT 24
+
+#define SIMPLIFY_ROUNDS 8
+
+/* the number of clause visits failed literal probing may spend */
+#define PROBE_BUDGET 1000000
+
+/* Internally the variables are numbered by their index in the set of
+ * literals of the formula and a literal is encoded as 2 * variable + 1 if negated. */
+
+typedef struct vector_s {
+	uint32_t *data;
+	size_t size;
+	size_t capacity;
+} vector_t;
+
+typedef struct clause_s {
+	uint32_t *lits;
+	uint32_t size;
+	bool removed;
+	bool queued;
+	uint64_t signature;
+	cl_collection_t *origin;
+} clause_t;
+
+typedef struct simplifier_s {
+	cl_cnf_t *cnf;
+	cl_collection_t *literals;
+	size_t nvars;
+
+	clause_t *clauses;
+	size_t nclauses;
+	size_t capacity;
+
+	vector_t *occs;
+	size_t *counts;
+	uint8_t *values;
+	bool *frozen;
+	bool *eliminated;
+
+	vector_t queue;
+	vector_t units;
+	vector_t buffer;
+	bool unsat;
+} simplifier_t;
+
+static void vector_push(vector_t * vector, uint32_t value)
+{
+	if (vector->size == vector->capacity) {
+		vector->capacity = vector->capacity ? 2 * vector->capacity : 8;
+		vector->data =
+		    realloc(vector->data, vector->capacity * sizeof(uint32_t));
+		assert(vector->data);
+	}
+
+	vector->data[vector->size++] = value;
+}
+
+static int lit_comparator(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static uint32_t lit_of(simplifier_t * s, cl_cnf_literal_t * lit)
+{
+	cl_cnf_literal_t *pos = lit->_negation ? lit->_dual : lit;
+	size_t var = cl_collection_find(s->literals, 0, pos);
+
+	assert(var != SIZE_MAX);
+	return 2 * var + lit->_negation;
+}
+
+static cl_cnf_literal_t *object_of(simplifier_t * s, uint32_t lit)
+{
+	cl_cnf_literal_t *pos = cl_collection_get(s->literals, lit >> 1);
+	return lit & 1 ? cl_cnf_literal_not(pos) : pos;
+}
+
+static uint8_t value(simplifier_t * s, uint32_t lit)
+{
+	uint8_t val = s->values[lit >> 1];
+	return val == VALUE_UNDEF ? val : val ^ (lit & 1);
+}
+
+/* Sorts the literals and drops the duplicates.
+ * Returns false for a tautology. */
+static bool normalize(uint32_t * lits, uint32_t * size)
+{
+	if (*size > 1) {
+		qsort(lits, *size, sizeof(uint32_t), &lit_comparator);
+	}
+
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < *size; i++) {
+		if (j && lits[j - 1] == lits[i]) {
+			continue;
+		}
+
+		if (j && lits[j - 1] == (lits[i] ^ 1)) {
+			return false;
+		}
+
+		lits[j++] = lits[i];
+	}
+
+	*size = j;
+	return true;
+}
+
+static uint64_t signature(uint32_t * lits, uint32_t size)
+{
+	uint64_t res = 0;
+	for (uint32_t i = 0; i < size; i++) {
+		res |= (uint64_t) 1 << ((lits[i] >> 1) & 63);
+	}
+
+	return res;
+}
+
+static void enqueue(simplifier_t * s, uint32_t c)
+{
+	clause_t *clause = &s->clauses[c];
+
+	if (clause->size == 0) {
+		s->unsat = true;
+	} else if (clause->size == 1) {
+		vector_push(&s->units, c);
+	}
+
+	if (!clause->queued) {
+		clause->queued = true;
+		vector_push(&s->queue, c);
+	}
+}
+
+/* Adds a normalized clause. */
+static void clause_add(simplifier_t * s, uint32_t * lits, uint32_t size,
+		       cl_collection_t * origin)
+{
+	if (s->nclauses == s->capacity) {
+		s->capacity = s->capacity ? 2 * s->capacity : 64;
+		s->clauses = realloc(s->clauses, s->capacity * sizeof(clause_t));
+		assert(s->clauses);
+	}
+
+	uint32_t c = s->nclauses++;
+	clause_t *clause = &s->clauses[c];
+
+	clause->lits = malloc((size ? size : 1) * sizeof(uint32_t));
+	assert(clause->lits);
+	if (size) {
+		memcpy(clause->lits, lits, size * sizeof(uint32_t));
+	}
+	clause->size = size;
+	clause->removed = false;
+	clause->queued = false;
+	clause->signature = signature(lits, size);
+	clause->origin = origin;
+
+	for (uint32_t i = 0; i < size; i++) {
+		vector_push(&s->occs[lits[i]], c);
+		s->counts[lits[i]]++;
+	}
+
+	enqueue(s, c);
+}
+
+static void clause_remove(simplifier_t * s, uint32_t c)
+{
+	clause_t *clause = &s->clauses[c];
+	assert(!clause->removed);
+
+	clause->removed = true;
+	for (uint32_t i = 0; i < clause->size; i++) {
+		s->counts[clause->lits[i]]--;
+	}
+}
+
+/* Removes the literal from the clause. */
+static void strengthen(simplifier_t * s, uint32_t c, uint32_t lit)
+{
+	clause_t *clause = &s->clauses[c];
+
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < clause->size; i++) {
+		if (clause->lits[i] != lit) {
+			clause->lits[j++] = clause->lits[i];
+		}
+	}
+	assert(j + 1 == clause->size);
+
+	clause->size = j;
+	clause->signature = signature(clause->lits, j);
+	clause->origin = NULL;
+	s->counts[lit]--;
+
+	vector_t *occ = &s->occs[lit];
+	for (size_t i = 0; i < occ->size; i++) {
+		if (occ->data[i] == c) {
+			occ->data[i] = occ->data[--occ->size];
+			break;
+		}
+	}
+
+	enqueue(s, c);
+}
+
+/* Copies the live clauses containing the literal into the buffer,
+ * dropping the removed ones from the occurrence list on the way. */
+static vector_t *occurrences(simplifier_t * s, uint32_t lit)
+{
+	vector_t *occ = &s->occs[lit];
+	size_t j = 0;
+
+	s->buffer.size = 0;
+	for (size_t i = 0; i < occ->size; i++) {
+		if (!s->clauses[occ->data[i]].removed) {
+			occ->data[j++] = occ->data[i];
+			vector_push(&s->buffer, occ->data[i]);
+		}
+	}
+
+	occ->size = j;
+	return &s->buffer;
+}
+
+static cl_collection_t *collection_of(simplifier_t * s, uint32_t * lits,
+				      uint32_t size)
+{
+	cl_collection_t *res = cl_collection(size, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_UNIQUE |
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	for (uint32_t i = 0; i < size; i++) {
+		cl_collection_add(res, object_of(s, lits[i]));
+	}
+
+	return res;
+}
+
+static cl_collection_t *materialize(simplifier_t * s, uint32_t c)
+{
+	clause_t *clause = &s->clauses[c];
+	if (!clause->origin) {
+		clause->origin = collection_of(s, clause->lits, clause->size);
+	}
+
+	return clause->origin;
+}
+
+/* Moves the clause to the reconstruction stack. */
+static void eliminate_clause(simplifier_t * s, uint32_t c, uint32_t witness)
+{
+	cl_collection_add(s->cnf->_eliminated, materialize(s, c));
+	cl_collection_add(s->cnf->_witnesses, object_of(s, witness));
+	clause_remove(s, c);
+}
+
+static void propagate(simplifier_t * s)
+{
+	while (!s->unsat && s->units.size) {
+		uint32_t c = s->units.data[--s->units.size];
+		clause_t *clause = &s->clauses[c];
+		if (clause->removed || clause->size != 1) {
+			continue;
+		}
+
+		uint32_t lit = clause->lits[0];
+		if (value(s, lit) == VALUE_FALSE) {
+			s->unsat = true;
+			return;
+		}
+
+		if (value(s, lit) == VALUE_TRUE) {
+			clause_remove(s, c);
+			continue;
+		}
+
+		s->values[lit >> 1] = !(lit & 1);
+
+		/* the unit clause itself stays in the formula */
+		vector_t *occ = occurrences(s, lit);
+		for (size_t i = 0; i < occ->size; i++) {
+			if (occ->data[i] != c) {
+				clause_remove(s, occ->data[i]);
+			}
+		}
+
+		occ = occurrences(s, lit ^ 1);
+		for (size_t i = 0; i < occ->size && !s->unsat; i++) {
+			strengthen(s, occ->data[i], lit ^ 1);
+		}
+	}
+}
+
+/* Checks whether the clause c subsumes d, possibly after flipping one literal.
+ * In the latter case, flip is set to the literal which can be removed from d. */
+static bool subsumes(clause_t * c, clause_t * d, uint32_t * flip)
+{
+	*flip = NIL;
+	if (c->size > d->size || (c->signature & ~d->signature)) {
+		return false;
+	}
+
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < c->size; i++) {
+		uint32_t lit = c->lits[i];
+		while (j < d->size && d->lits[j] < (lit & ~1u)) {
+			j++;
+		}
+
+		if (j < d->size && d->lits[j] == lit) {
+			j++;
+		} else if (j < d->size && d->lits[j] == (lit ^ 1)
+			   && *flip == NIL) {
+			*flip = d->lits[j++];
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Forward subsumption and strengthening of the clause by the others,
+ * followed by backward subsumption and strengthening of the others. */
+static void subsume(simplifier_t * s, uint32_t c)
+{
+	uint32_t flip;
+
+	for (uint32_t i = 0; i < s->clauses[c].size; i++) {
+		vector_t *occ = occurrences(s, s->clauses[c].lits[i]);
+		for (size_t k = 0; k < occ->size; k++) {
+			uint32_t d = occ->data[k];
+			if (d == c || !subsumes(&s->clauses[d], &s->clauses[c],
+						&flip)) {
+				continue;
+			}
+
+			/* the strengthened clause gets queued again */
+			if (flip != NIL) {
+				strengthen(s, c, flip);
+			} else {
+				clause_remove(s, c);
+			}
+			return;
+		}
+	}
+
+	clause_t *clause = &s->clauses[c];
+	if (!clause->size) {
+		return;
+	}
+
+	/* the literal with the fewest occurrences */
+	uint32_t best = clause->lits[0];
+	for (uint32_t i = 1; i < clause->size; i++) {
+		uint32_t lit = clause->lits[i];
+		if (s->counts[lit] + s->counts[lit ^ 1] <
+		    s->counts[best] + s->counts[best ^ 1]) {
+			best = lit;
+		}
+	}
+
+	for (uint32_t side = 0; side < 2 && !s->unsat; side++) {
+		vector_t *occ = occurrences(s, best ^ side);
+		for (size_t k = 0; k < occ->size && !s->unsat; k++) {
+			uint32_t d = occ->data[k];
+			if (d == c || s->clauses[d].removed
+			    || !subsumes(clause, &s->clauses[d], &flip)) {
+				continue;
+			}
+
+			if (flip != NIL) {
+				strengthen(s, d, flip);
+			} else {
+				clause_remove(s, d);
+			}
+		}
+	}
+}
+
+static void process_queue(simplifier_t * s)
+{
+	while (!s->unsat && (s->queue.size || s->units.size)) {
+		propagate(s);
+
+		if (s->queue.size) {
+			uint32_t c = s->queue.data[--s->queue.size];
+			s->clauses[c].queued = false;
+			if (!s->clauses[c].removed) {
+				subsume(s, c);
+			}
+		}
+	}
+}
+
+/* Resolves the two clauses on the variable into the buffer.
+ * Returns false if the resolvent is a tautology. */
+static bool resolve(simplifier_t * s, clause_t * a, clause_t * b, uint32_t var)
+{
+	vector_t *res = &s->buffer;
+	res->size = 0;
+
+	uint32_t i = 0, j = 0;
+	while (i < a->size || j < b->size) {
+		uint32_t x = i < a->size ? a->lits[i] : NIL;
+		uint32_t y = j < b->size ? b->lits[j] : NIL;
+		uint32_t lit;
+
+		if (x <= y) {
+			lit = x;
+			i++;
+			j += x == y;
+		} else {
+			lit = y;
+			j++;
+		}
+
+		if ((lit >> 1) == var) {
+			continue;
+		}
+
+		if (res->size && res->data[res->size - 1] == (lit ^ 1)) {
+			return false;
+		}
+
+		vector_push(res, lit);
+	}
+
+	return true;
+}
+
+/* Tries to eliminate the variable by clause distribution,
+ * which must not increase the number of clauses. */
+static bool eliminate(simplifier_t * s, uint32_t var)
+{
+	vector_t pos = { NULL, 0, 0 }, neg = { NULL, 0, 0 };
+	bool res = false;
+
+	vector_t *occ = occurrences(s, 2 * var);
+	for (size_t i = 0; i < occ->size; i++) {
+		vector_push(&pos, occ->data[i]);
+	}
+
+	occ = occurrences(s, 2 * var + 1);
+	for (size_t i = 0; i < occ->size; i++) {
+		vector_push(&neg, occ->data[i]);
+	}
+
+	if (pos.size + neg.size == 0 || (pos.size > ELIMINATE_OCCURRENCE_LIMIT
+					 && neg.size >
+					 ELIMINATE_OCCURRENCE_LIMIT)) {
+		goto done;
+	}
+
+	/* count the resolvents first */
+	size_t resolvents = 0;
+	for (size_t i = 0; i < pos.size; i++) {
+		for (size_t j = 0; j < neg.size; j++) {
+			if (!resolve(s, &s->clauses[pos.data[i]],
+				     &s->clauses[neg.data[j]], var)) {
+				continue;
+			}
+
+			if (++resolvents > pos.size + neg.size
+			    || s->buffer.size > ELIMINATE_RESOLVENT_LIMIT) {
+				goto done;
+			}
+		}
+	}
+
+	/* the clauses go to the stack before the resolvents are added,
+	 * as adding a clause may move the clauses array */
+	vector_t resolved = { NULL, 0, 0 };
+	vector_t bounds = { NULL, 0, 0 };
+	for (size_t i = 0; i < pos.size; i++) {
+		for (size_t j = 0; j < neg.size; j++) {
+			if (resolve(s, &s->clauses[pos.data[i]],
+				    &s->clauses[neg.data[j]], var)) {
+				for (size_t k = 0; k < s->buffer.size; k++) {
+					vector_push(&resolved, s->buffer.data[k]);
+				}
+				vector_push(&bounds, resolved.size);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < pos.size; i++) {
+		eliminate_clause(s, pos.data[i], 2 * var);
+	}
+
+	for (size_t i = 0; i < neg.size; i++) {
+		eliminate_clause(s, neg.data[i], 2 * var + 1);
+	}
+
+	for (size_t i = 0, start = 0; i < bounds.size; i++) {
+		clause_add(s, resolved.data + start, bounds.data[i] - start,
+			   NULL);
+		start = bounds.data[i];
+	}
+
+	free(resolved.data);
+	free(bounds.data);
+	s->eliminated[var] = true;
+	res = true;
+
+ done:
+	free(pos.data);
+	free(neg.data);
+	return res;
+}
+
+static int candidate_comparator(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* One round of variable elimination, the cheapest variables first.
+ * Pure literals are eliminated the same way, without any resolvents. */
+static bool eliminate_all(simplifier_t * s)
+{
+	uint64_t *candidates = malloc(s->nvars * sizeof(uint64_t));
+	size_t count = 0;
+	bool res = false;
+	assert(candidates || !s->nvars);
+
+	for (uint32_t var = 0; var < s->nvars; var++) {
+		if (!s->frozen[var] && !s->eliminated[var]
+		    && s->values[var] == VALUE_UNDEF) {
+			uint64_t cost = (uint64_t) s->counts[2 * var]
+			    * s->counts[2 * var + 1];
+			candidates[count++] = cost << 32 | var;
+		}
+	}
+
+	qsort(candidates, count, sizeof(uint64_t), &candidate_comparator);
+	for (size_t i = 0; i < count && !s->unsat; i++) {
+		uint32_t var = (uint32_t) candidates[i];
+		if (s->values[var] == VALUE_UNDEF && eliminate(s, var)) {
+			res = true;
+			process_queue(s);
+		}
+	}
+
+	free(candidates);
+	return res;
+}
+
+/* Assigns the representatives to a strongly connected component
+ * of the binary implication graph, found on top of the stack. */
+static void component(simplifier_t * s, uint32_t * repr, uint32_t * comp,
+		      vector_t * stack, uint32_t root)
+{
+	size_t start = stack->size;
+	do {
+		start--;
+	} while (stack->data[start] != root);
+
+	uint32_t *members = stack->data + start;
+	size_t size = stack->size - start;
+	stack->size = start;
+
+	for (size_t i = 0; i < size; i++) {
+		comp[members[i]] = root;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		if (comp[members[i] ^ 1] == root) {
+			s->unsat = true;
+			return;
+		}
+	}
+
+	/* the complementary component has been done already */
+	if (repr[members[0] ^ 1] != NIL) {
+		for (size_t i = 0; i < size; i++) {
+			repr[members[i]] = repr[members[i] ^ 1] ^ 1;
+		}
+		return;
+	}
+
+	/* frozen literals are kept, one of them can be the representative */
+	uint32_t best = members[0];
+	for (size_t i = 1; i < size; i++) {
+		uint32_t lit = members[i];
+		if (s->frozen[lit >> 1] > s->frozen[best >> 1]
+		    || (s->frozen[lit >> 1] == s->frozen[best >> 1]
+			&& lit < best)) {
+			best = lit;
+		}
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		uint32_t lit = members[i];
+		repr[lit] = s->frozen[lit >> 1] ? lit : best;
+	}
+}
+
+/* Finds the strongly connected components of the binary implication graph
+ * with Tarjan's algorithm and maps every literal to the representative
+ * of its component. Returns NULL if a literal is equivalent to its negation. */
+static uint32_t *equivalences(simplifier_t * s)
+{
+	size_t nlits = 2 * s->nvars;
+	uint32_t *offsets = calloc(nlits + 1, sizeof(uint32_t));
+	assert(offsets);
+
+	/* a binary clause (a v b) gives the edges ~a -> b and ~b -> a */
+	for (uint32_t c = 0; c < s->nclauses; c++) {
+		clause_t *clause = &s->clauses[c];
+		if (!clause->removed && clause->size == 2) {
+			offsets[(clause->lits[0] ^ 1) + 1]++;
+			offsets[(clause->lits[1] ^ 1) + 1]++;
+		}
+	}
+
+	for (size_t i = 0; i < nlits; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	uint32_t *edges = malloc((offsets[nlits] + 1) * sizeof(uint32_t));
+	uint32_t *next = malloc((nlits + 1) * sizeof(uint32_t));
+	uint32_t *index = malloc((nlits + 1) * sizeof(uint32_t));
+	uint32_t *low = malloc((nlits + 1) * sizeof(uint32_t));
+	uint32_t *comp = malloc((nlits + 1) * sizeof(uint32_t));
+	uint32_t *repr = malloc((nlits + 1) * sizeof(uint32_t));
+	assert(edges && next && index && low && comp && repr);
+
+	if (nlits) {
+		memcpy(next, offsets, nlits * sizeof(uint32_t));
+	}
+
+	for (uint32_t c = 0; c < s->nclauses; c++) {
+		clause_t *clause = &s->clauses[c];
+		if (!clause->removed && clause->size == 2) {
+			edges[next[clause->lits[0] ^ 1]++] = clause->lits[1];
+			edges[next[clause->lits[1] ^ 1]++] = clause->lits[0];
+		}
+	}
+
+	for (size_t i = 0; i < nlits; i++) {
+		next[i] = offsets[i];
+		index[i] = low[i] = comp[i] = repr[i] = NIL;
+	}
+
+	/* the recursion is unrolled, as the chains can be long */
+	vector_t stack = { NULL, 0, 0 }, calls = { NULL, 0, 0 };
+	uint32_t counter = 0;
+	for (uint32_t root = 0; root < nlits && !s->unsat; root++) {
+		if (index[root] != NIL || offsets[root] == offsets[root + 1]) {
+			continue;
+		}
+
+		index[root] = low[root] = counter++;
+		vector_push(&stack, root);
+		vector_push(&calls, root);
+
+		while (calls.size && !s->unsat) {
+			uint32_t v = calls.data[calls.size - 1];
+
+			if (next[v] < offsets[v + 1]) {
+				uint32_t w = edges[next[v]++];
+				if (index[w] == NIL) {
+					index[w] = low[w] = counter++;
+					vector_push(&stack, w);
+					vector_push(&calls, w);
+				} else if (comp[w] == NIL && index[w] < low[v]) {
+					low[v] = index[w];
+				}
+				continue;
+			}
+
+			calls.size--;
+			if (calls.size) {
+				uint32_t u = calls.data[calls.size - 1];
+				if (low[v] < low[u]) {
+					low[u] = low[v];
+				}
+			}
+
+			if (low[v] == index[v]) {
+				component(s, repr, comp, &stack, v);
+			}
+		}
+	}
+
+	free(stack.data);
+	free(calls.data);
+	free(offsets);
+	free(edges);
+	free(next);
+	free(index);
+	free(low);
+	free(comp);
+
+	if (s->unsat) {
+		free(repr);
+		return NULL;
+	}
+
+	return repr;
+}
+
+/* Replaces every literal by the representative of its equivalence class.
+ * The equivalences of the substituted literals go to the reconstruction stack.
+ * Returns true if any literal has been substituted. */
+static bool substitute(simplifier_t * s)
+{
+	uint32_t *repr = equivalences(s);
+	bool res = false;
+	if (!repr) {
+		return false;
+	}
+
+	for (uint32_t var = 0; var < s->nvars; var++) {
+		uint32_t lit = 2 * var;
+		if (repr[lit] == NIL || repr[lit] == lit) {
+			continue;
+		}
+
+		uint32_t pos[2] = { lit, repr[lit] ^ 1 };
+		uint32_t neg[2] = { lit ^ 1, repr[lit] };
+		cl_collection_add(s->cnf->_eliminated, collection_of(s, pos, 2));
+		cl_collection_add(s->cnf->_witnesses, object_of(s, lit));
+		cl_collection_add(s->cnf->_eliminated, collection_of(s, neg, 2));
+		cl_collection_add(s->cnf->_witnesses, object_of(s, lit ^ 1));
+
+		s->eliminated[var] = true;
+		res = true;
+	}
+
+	for (uint32_t c = 0, n = s->nclauses; res && c < n && !s->unsat; c++) {
+		clause_t *clause = &s->clauses[c];
+		uint32_t i = 0;
+		while (i < clause->size && !s->eliminated[clause->lits[i] >> 1]) {
+			i++;
+		}
+
+		if (clause->removed || i == clause->size) {
+			continue;
+		}
+
+		s->buffer.size = 0;
+		for (i = 0; i < clause->size; i++) {
+			uint32_t lit = clause->lits[i];
+			vector_push(&s->buffer, repr[lit] == NIL ? lit : repr[lit]);
+		}
+
+		uint32_t size = clause->size;
+		clause_remove(s, c);
+		if (normalize(s->buffer.data, &size)) {
+			clause_add(s, s->buffer.data, size, NULL);
+		}
+	}
+
+	free(repr);
+	process_queue(s);
+	return res;
+}
+
+/* Propagates the literal over the clauses without changing them.
+ * The assigned literals are recorded on the trail and have to be
+ * unassigned by the caller. Returns false on a conflict. */
+static bool probe_propagate(simplifier_t * s, uint32_t lit, vector_t * trail,
+			    size_t * budget)
+{
+	trail->size = 0;
+	s->values[lit >> 1] = !(lit & 1);
+	vector_push(trail, lit);
+
+	for (size_t head = 0; head < trail->size; head++) {
+		vector_t *occ = &s->occs[trail->data[head] ^ 1];
+		for (size_t i = 0; i < occ->size; i++) {
+			clause_t *clause = &s->clauses[occ->data[i]];
+			if (clause->removed) {
+				continue;
+			}
+
+			*budget -= *budget > 0;
+
+			uint32_t unit = NIL, undef = 0;
+			bool satisfied = false;
+			for (uint32_t j = 0; j < clause->size && !satisfied; j++) {
+				uint8_t val = value(s, clause->lits[j]);
+				if (val == VALUE_TRUE) {
+					satisfied = true;
+				} else if (val == VALUE_UNDEF) {
+					unit = clause->lits[j];
+					undef++;
+				}
+			}
+
+			if (satisfied || undef > 1) {
+				continue;
+			}
+
+			if (!undef) {
+				return false;
+			}
+
+			s->values[unit >> 1] = !(unit & 1);
+			vector_push(trail, unit);
+		}
+	}
+
+	return true;
+}
+
+static void unassign(simplifier_t * s, vector_t * trail)
+{
+	for (size_t i = 0; i < trail->size; i++) {
+		s->values[trail->data[i] >> 1] = VALUE_UNDEF;
+	}
+}
+
+/* Failed literal probing: a literal whose propagation leads to a conflict
+ * is false, and a literal implied by both phases of a variable is true.
+ * Returns true if any units have been found. */
+static bool probe(simplifier_t * s)
+{
+	vector_t trail = { NULL, 0, 0 }, units = { NULL, 0, 0 };
+	bool *implied = calloc(2 * s->nvars, sizeof(bool));
+	size_t budget = PROBE_BUDGET;
+	bool res = false;
+	assert(implied || !s->nvars);
+
+	for (uint32_t var = 0; var < s->nvars && budget && !s->unsat; var++) {
+		uint32_t lit = 2 * var;
+		if (s->values[var] != VALUE_UNDEF || s->eliminated[var]
+		    || !s->counts[lit] || !s->counts[lit ^ 1]) {
+			continue;
+		}
+
+		units.size = 0;
+		bool ok = probe_propagate(s, lit, &trail, &budget);
+		unassign(s, &trail);
+
+		if (!ok) {
+			vector_push(&units, lit ^ 1);
+		} else {
+			for (size_t i = 1; i < trail.size; i++) {
+				implied[trail.data[i]] = true;
+			}
+
+			vector_t first = trail;
+			memset(&trail, 0, sizeof(vector_t));
+
+			ok = probe_propagate(s, lit ^ 1, &trail, &budget);
+			unassign(s, &trail);
+
+			if (!ok) {
+				vector_push(&units, lit);
+			} else {
+				for (size_t i = 1; i < trail.size; i++) {
+					if (implied[trail.data[i]]) {
+						vector_push(&units,
+							    trail.data[i]);
+					}
+				}
+			}
+
+			for (size_t i = 1; i < first.size; i++) {
+				implied[first.data[i]] = false;
+			}
+			free(first.data);
+		}
+
+		for (size_t i = 0; i < units.size; i++) {
+			clause_add(s, &units.data[i], 1, NULL);
+			res = true;
+		}
+		process_queue(s);
+	}
+
+	free(trail.data);
+	free(units.data);
+	free(implied);
+	return res;
+}
+
+static void setup(simplifier_t * s, cl_cnf_t * self, cl_collection_t * frozen)
+{
+	memset(s, 0, sizeof(simplifier_t));
+	cl_cnf_compact(self);
+	s->cnf = self;
+	s->literals = cl_object_retain(cl_cnf_literals(self));
+	s->nvars = cl_collection_count(s->literals);
+
+	s->occs = calloc(2 * s->nvars, sizeof(vector_t));
+	s->counts = calloc(2 * s->nvars, sizeof(size_t));
+	s->values = malloc(s->nvars * sizeof(uint8_t));
+	s->frozen = calloc(s->nvars, sizeof(bool));
+	s->eliminated = calloc(s->nvars, sizeof(bool));
+	assert(!s->nvars || (s->occs && s->counts && s->values && s->frozen
+			     && s->eliminated));
+	memset(s->values, VALUE_UNDEF, s->nvars * sizeof(uint8_t));
+
+	if (!self->_eliminated) {
+		self->_eliminated =
+		    cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
+				      CL_COLLECTION_FLAG_AUTORESIZE);
+		self->_witnesses =
+		    cl_collection_new(0, CL_OBJECT_TYPE_CNF_LITERAL,
+				      CL_COLLECTION_FLAG_AUTORESIZE);
+	}
+
+	for (size_t i = 0; frozen && i < cl_collection_count(frozen); i++) {
+		cl_cnf_literal_t *lit = cl_collection_get(frozen, i);
+		size_t var = cl_collection_find(s->literals, 0,
+						lit->_negation ? lit->_dual : lit);
+		if (var != SIZE_MAX) {
+			s->frozen[var] = true;
+		}
+	}
+
+	/* the clauses alone don't tell what the other constraints need */
+	for (size_t i = 0; i < cl_collection_count(self->_xors); i++) {
+		cl_collection_t *xor = cl_collection_get(self->_xors, i);
+		for (size_t j = 0; j < cl_collection_count(xor); j++) {
+			s->frozen[lit_of(s, cl_collection_get(xor, j)) >> 1] = true;
+		}
+	}
+
+	for (size_t i = 0; i < cl_collection_count(self->_cards); i++) {
+		cl_collection_t *card = cl_collection_get(self->_cards, i);
+		for (size_t j = 0; j < cl_collection_count(card); j++) {
+			s->frozen[lit_of(s, cl_collection_get(card, j)) >> 1] =
+			    true;
+		}
+	}
+
+	/* translate the clauses */
+	cl_collection_t *set = self->_set;
+	for (size_t i = 0; i < cl_collection_count(set); i++) {
+		cl_collection_t *clause = cl_collection_get(set, i);
+		uint32_t size = cl_collection_count(clause);
+
+		s->buffer.size = 0;
+		for (uint32_t j = 0; j < size; j++) {
+			vector_push(&s->buffer,
+				    lit_of(s, cl_collection_get(clause, j)));
+		}
+
+		if (normalize(s->buffer.data, &size)) {
+			clause_add(s, s->buffer.data, size,
+				   size == cl_collection_count(clause) ?
+				   clause : NULL);
+		}
+	}
+
+	process_queue(s);
+}
+
+/* Writes the remaining clauses back to the formula and frees the simplifier. */
+static bool finish(simplifier_t * s)
+{
+	cl_collection_t *res = cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
+						 CL_COLLECTION_FLAG_UNIQUE |
+						 CL_COLLECTION_FLAG_AUTORESIZE);
+	if (s->unsat) {
+		cl_collection_add(res, cl_cnf_clause(0));
+	} else {
+		for (uint32_t c = 0; c < s->nclauses; c++) {
+			if (!s->clauses[c].removed) {
+				cl_collection_add(res, materialize(s, c));
+			}
+		}
+	}
+
+	cl_object_release(s->cnf->_set);
+	s->cnf->_set = res;
+
+	for (uint32_t c = 0; c < s->nclauses; c++) {
+		free(s->clauses[c].lits);
+	}
+
+	for (size_t i = 0; i < 2 * s->nvars; i++) {
+		free(s->occs[i].data);
+	}
+
+	free(s->clauses);
+	free(s->occs);
+	free(s->counts);
+	free(s->values);
+	free(s->frozen);
+	free(s->eliminated);
+	free(s->queue.data);
+	free(s->units.data);
+	free(s->buffer.data);
+	cl_object_release(s->literals);
+
+	return !s->unsat;
+}
+
+bool cl_cnf_simplify(cl_cnf_t * self, cl_collection_t * frozen)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	simplifier_t s;
+	setup(&s, self, frozen);
+
+	for (int round = 0; round < SIMPLIFY_ROUNDS && !s.unsat; round++) {
+		if (!eliminate_all(&s)) {
+			break;
+		}
+	}
+
+	return finish(&s);
+}
+
+bool cl_cnf_probe(cl_cnf_t * self, cl_collection_t * frozen)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_CNF));
+
+	simplifier_t s;
+	setup(&s, self, frozen);
+
+	/* new units may turn longer clauses into binary ones */
+	for (int round = 0; round < SIMPLIFY_ROUNDS && !s.unsat; round++) {
+		bool substituted = substitute(&s);
+		if (!probe(&s) && !substituted) {
+			break;
+		}
+	}
+
+	return finish(&s);
+}
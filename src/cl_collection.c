@@ -35,50 +35,20 @@ static void destructor(void *self)
 	}
 }
 
-static char *collection_printer(void *self)
+static void collection_printer(void *self, cl_object_stream_t * stream)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_COLLECTION));
 	cl_collection_t *c = (cl_collection_t *) self;
 
-	size_t len = 0;
-	size_t count = cl_collection_count(c);
-	char **temp = malloc(sizeof(char *) * count);
-	size_t *lens = malloc(sizeof(size_t) * count);
-	assert(temp);
-	assert(lens);
-
-	/* print all objects and sum their string lengths */
-	for (int i = 0; i < count; i++) {
-		temp[i] = cl_object_to_string(cl_collection_get(c, i));
-		lens[i] = strlen(temp[i]);
-		len += lens[i];
-	}
-
-	/* extra lenght for the spearators, brackets and the terminator */
-	len += count ? 2 * (count - 1) : 0;
-	len += 3;
-
-	/* build the string */
-	char *buffer = malloc(sizeof(char) * len);
-	assert(buffer);
-
-	strcpy(buffer, "{");
-	size_t offset = 1;
-	for (int i = 0; i < count; i++) {
-		strcpy(buffer + offset, temp[i]);
-		offset += lens[i];
-		buffer[offset++] = ',';
-		buffer[offset++] = ' ';
+	cl_object_stream_puts(stream, "{");
+	for (int i = 0; i < c->_count; i++) {
+		if (i) {
+			cl_object_stream_puts(stream, ", ");
+		}
 
-		free(temp[i]);
+		cl_object_write(c->_buffer[i], stream);
 	}
-	offset -= count ? 2 : 0;
-	strcpy(buffer + offset, "}");
-
-	free(temp);
-	free(lens);
-
-	return buffer;
+	cl_object_stream_puts(stream, "}");
 }
 
 cl_collection_t *cl_collection_new(size_t nmemb, cl_object_type_t type,
@@ -293,6 +263,13 @@ size_t cl_collection_remove(cl_collection_t * self, void *object)
 	size_t i = index(self, 0, object);
 	void *obj = cl_collection_get(self, i);
 
+	/* the collection may hold the last reference to the object,
+	 * which is still needed to look for the duplicates */
+	if (!obj || self->_comparator(&obj, &object) != 0) {
+		return 0;
+	}
+	cl_object_retain(object);
+
 	while (obj && (self->_comparator(&obj, &object) == 0)) {
 		cl_collection_delete(self, i);
 		count++;
@@ -301,6 +278,7 @@ size_t cl_collection_remove(cl_collection_t * self, void *object)
 		obj = cl_collection_get(self, i);
 	}
 
+	cl_object_release(object);
 	return count;
 }
 
@@ -18,25 +18,113 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include "cl_object.h"
 #include "cl_object_rep.h"
 #include "cl_collection.h"
 
 static const size_t MAGIC = 0x0b7ecdL;
 static cl_collection_t *pool_stack = NULL;
+static cl_object_zone_t *zone_stack = NULL;
 
-char *cl_object_printer(void *self)
+/* alignment of the objects allocated from zones */
+#define ZONE_ALIGN 16
+#define ZONE_DEFAULT_CHUNK (64 * 1024)
+
+void cl_object_stream_buffer(cl_object_stream_t * stream)
+{
+	stream->file = NULL;
+	stream->length = 0;
+	stream->capacity = 64;
+	stream->buffer = malloc(sizeof(char) * stream->capacity);
+	assert(stream->buffer);
+	stream->buffer[0] = '\0';
+}
+
+void cl_object_stream_file(cl_object_stream_t * stream, FILE * file)
+{
+	assert(file);
+	stream->file = file;
+	stream->buffer = NULL;
+	stream->length = 0;
+	stream->capacity = 0;
+}
+
+char *cl_object_stream_finish(cl_object_stream_t * stream)
+{
+	char *res = stream->buffer;
+	stream->buffer = NULL;
+	stream->length = 0;
+	stream->capacity = 0;
+
+	return res;
+}
+
+/* makes room for len more characters, plus the terminator */
+static void reserve(cl_object_stream_t * stream, size_t len)
 {
-	/* '0x' = 2 chars
-	 * 64-bits = 8 bytes = 16 chars
-	 * '\0' = 1 char
-	 * ----------------
-	 *  MAX 19 chars would be needed */
-	char *buffer = malloc(sizeof(char) * 19);
-	assert(buffer);
+	if (stream->length + len < stream->capacity) {
+		return;
+	}
+
+	size_t capacity = stream->capacity;
+	while (stream->length + len >= capacity) {
+		capacity *= 2;
+	}
+
+	char *temp = realloc(stream->buffer, sizeof(char) * capacity);
+	assert(temp);
 
-	sprintf(buffer, "%p", self);
-	return buffer;
+	stream->buffer = temp;
+	stream->capacity = capacity;
+}
+
+void cl_object_stream_puts(cl_object_stream_t * stream, const char *str)
+{
+	if (stream->file) {
+		fputs(str, stream->file);
+		return;
+	}
+
+	size_t len = strlen(str);
+	reserve(stream, len);
+	memcpy(stream->buffer + stream->length, str, len + 1);
+	stream->length += len;
+}
+
+void cl_object_stream_printf(cl_object_stream_t * stream, const char *format,
+			     ...)
+{
+	va_list ap;
+
+	if (stream->file) {
+		va_start(ap, format);
+		vfprintf(stream->file, format, ap);
+		va_end(ap);
+		return;
+	}
+
+	/* try to fit in the available space first */
+	size_t available = stream->capacity - stream->length;
+	va_start(ap, format);
+	int len = vsnprintf(stream->buffer + stream->length, available,
+			    format, ap);
+	va_end(ap);
+	assert(len >= 0);
+
+	if ((size_t) len >= available) {
+		reserve(stream, len);
+		va_start(ap, format);
+		vsnprintf(stream->buffer + stream->length, len + 1, format, ap);
+		va_end(ap);
+	}
+
+	stream->length += len;
+}
+
+void cl_object_printer(void *self, cl_object_stream_t * stream)
+{
+	cl_object_stream_printf(stream, "%p", self);
 }
 
 void *cl_object_new(size_t size, cl_object_type_t type,
@@ -45,7 +133,13 @@ void *cl_object_new(size_t size, cl_object_type_t type,
 	/* the size provided shuold at least fit the abstract object */
 	assert(size >= sizeof(cl_object_t));
 
-	cl_object_t *res = malloc(size);
+	cl_object_t *res = NULL;
+	if (zone_stack) {
+		res = cl_object_zone_alloc(zone_stack, size);
+		zone_stack->_ref++;
+	} else {
+		res = malloc(size);
+	}
 	assert(res);
 
 	res->_obj_info._MAGIC = MAGIC;
@@ -53,6 +147,7 @@ void *cl_object_new(size_t size, cl_object_type_t type,
 	res->_obj_info._ref = 1;
 	res->_obj_info._dest = dest;
 	res->_obj_info._to_str = to_str ? to_str : &cl_object_printer;
+	res->_obj_info._zone = zone_stack;
 
 	return res;
 }
@@ -79,10 +174,26 @@ void *cl_object_retain(void *object)
 	return object;
 }
 
-char *cl_object_to_string(void *self)
+void cl_object_write(void *self, cl_object_stream_t * stream)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_OBJECT));
-	return ((cl_object_t *) self)->_obj_info._to_str(self);
+	((cl_object_t *) self)->_obj_info._to_str(self, stream);
+}
+
+void cl_object_print(void *self, FILE * file)
+{
+	cl_object_stream_t stream;
+	cl_object_stream_file(&stream, file);
+	cl_object_write(self, &stream);
+}
+
+char *cl_object_to_string(void *self)
+{
+	cl_object_stream_t stream;
+	cl_object_stream_buffer(&stream);
+	cl_object_write(self, &stream);
+
+	return cl_object_stream_finish(&stream);
 }
 
 void *cl_object_release(void *object)
@@ -107,7 +218,13 @@ void *cl_object_release(void *object)
 		obj->_obj_info._dest(object);
 	}
 
-	free(obj);
+	/* the memory of zone objects is freed together with the zone */
+	if (obj->_obj_info._zone) {
+		cl_object_zone_release(obj->_obj_info._zone);
+	} else {
+		free(obj);
+	}
+
 	return NULL;
 }
 
@@ -160,6 +277,84 @@ void cl_object_pool_pop()
 	}
 }
 
+cl_object_zone_t *cl_object_zone_new(size_t chunk)
+{
+	cl_object_zone_t *zone = malloc(sizeof(cl_object_zone_t));
+	assert(zone);
+
+	zone->_ref = 1;
+	zone->_chunk_size = chunk ? chunk : ZONE_DEFAULT_CHUNK;
+	zone->_available = 0;
+	zone->_next = NULL;
+	zone->_chunks = NULL;
+	zone->_outer = NULL;
+
+	return zone;
+}
+
+void cl_object_zone_release(cl_object_zone_t * zone)
+{
+	if (!zone || --zone->_ref) {
+		return;
+	}
+
+	/* the first bytes of each chunk point to the previous one */
+	void *chunk = zone->_chunks;
+	while (chunk) {
+		void *prev = *((void **)chunk);
+		free(chunk);
+		chunk = prev;
+	}
+
+	free(zone);
+}
+
+void *cl_object_zone_alloc(cl_object_zone_t * zone, size_t size)
+{
+	assert(zone);
+	size = (size + ZONE_ALIGN - 1) & ~((size_t) ZONE_ALIGN - 1);
+
+	if (size > zone->_available) {
+		/* allocations larger than the chunk get a chunk of their own */
+		size_t len = size > zone->_chunk_size ? size : zone->_chunk_size;
+		char *chunk = malloc(ZONE_ALIGN + len);
+		if (!chunk) {
+			return NULL;
+		}
+
+		*((void **)chunk) = zone->_chunks;
+		zone->_chunks = chunk;
+		zone->_next = chunk + ZONE_ALIGN;
+		zone->_available = len;
+	}
+
+	void *res = zone->_next;
+	zone->_next += size;
+	zone->_available -= size;
+
+	return res;
+}
+
+void cl_object_zone_push(cl_object_zone_t * zone)
+{
+	assert(zone);
+	assert(!zone->_outer && zone != zone_stack);
+
+	zone->_outer = zone_stack;
+	zone_stack = zone;
+}
+
+void cl_object_zone_pop()
+{
+	if (!zone_stack) {
+		return;
+	}
+
+	cl_object_zone_t *zone = zone_stack;
+	zone_stack = zone->_outer;
+	zone->_outer = NULL;
+}
+
 int cl_object_comparator(const void *p1, const void *p2)
 {
 	void *o1 = *((void **)p1);
@@ -23,6 +23,7 @@
 #include <stdbool.h>
 #include <inttypes.h>
 #include <stdarg.h>
+#include <stdio.h>
 
 /** Dummy definiton of the object type flag.
  * Used for convenince with the @ref cl_object_type_check function. */
@@ -37,11 +38,27 @@ typedef struct cl_object_info_s cl_object_info_t;
 /** Abstract object type. */
 typedef struct cl_object_s cl_object_t;
 
+/** Memory zone (arena) objects can be allocated from. */
+typedef struct cl_object_zone_s cl_object_zone_t;
+
 /** Object's destructor type. */
 typedef void (*cl_object_destructor_t) (void *self);
 
-/** Object's printer type. */
-typedef char *(*cl_object_printer_t) (void *self);
+/** Output stream the object printers write into.
+ * The stream either appends to a growable buffer, or writes directly to a file.
+ * It is meant to be allocated on the stack, and initialized with
+ * @ref cl_object_stream_buffer or @ref cl_object_stream_file. */
+typedef struct cl_object_stream_s cl_object_stream_t;
+struct cl_object_stream_s {
+	FILE *file;
+	char *buffer;
+	size_t length;
+	size_t capacity;
+};
+
+/** Object's printer type.
+ * The printer writes the object into the provided stream. */
+typedef void (*cl_object_printer_t) (void *self, cl_object_stream_t * stream);
 
 /** Initializes a new object. 
  * @param size The size of the object to be created.
@@ -58,12 +75,37 @@ void *cl_object_new(size_t size, cl_object_type_t type,
  * @return true If only the bits provided in the mask are set, false otherwise. */
 bool cl_object_type_check(void *object, cl_object_type_t typeMask);
 
+/** Initializes a stream writing into a growable buffer.
+ * The buffer is obtained by @ref cl_object_stream_finish. */
+void cl_object_stream_buffer(cl_object_stream_t * stream);
+
+/** Initializes a stream writing directly into the provided file. */
+void cl_object_stream_file(cl_object_stream_t * stream, FILE * file);
+
+/** Finishes the stream.
+ * @return The string written into the buffer, which needs to be freed by the caller,
+ * or NULL for file streams. */
+char *cl_object_stream_finish(cl_object_stream_t * stream);
+
+/** Writes the string into the stream. */
+void cl_object_stream_puts(cl_object_stream_t * stream, const char *str);
+
+/** Writes the formatted string into the stream. */
+void cl_object_stream_printf(cl_object_stream_t * stream, const char *format,
+			     ...);
+
+/** Writes the object into the stream, using the object's printer. */
+void cl_object_write(void *self, cl_object_stream_t * stream);
+
+/** Writes the object into the file. */
+void cl_object_print(void *self, FILE * file);
+
 /* Returns a string reperesenting the object.
  * The returned string needs to be freed by the caller. */
 char *cl_object_to_string(void *self);
 
 /* Default object printer. */
-char *cl_object_printer(void *self);
+void cl_object_printer(void *self, cl_object_stream_t * stream);
 
 /** Increases the object's referece counter. 
  * @param object The object to be retained.
@@ -89,6 +131,28 @@ void cl_object_pool_push();
  * will be released. */
 void cl_object_pool_pop();
 
+/** Initializes a new memory zone, with retain count 1.
+ * The zone allocates memory in large chunks, and frees it all at once,
+ * when the zone and all the objects allocated from it are released.
+ * @param chunk The size of the chunks in bytes. If 0 is provided, a default size is used. */
+cl_object_zone_t *cl_object_zone_new(size_t chunk);
+
+/** Releases the zone.
+ * The memory is freed only after all the objects allocated from the zone are deallocated. */
+void cl_object_zone_release(cl_object_zone_t * zone);
+
+/** Allocates raw memory from the zone.
+ * The memory lives as long as the zone does. */
+void *cl_object_zone_alloc(cl_object_zone_t * zone, size_t size);
+
+/** Pushes the zone on the zone stack.
+ * Until the zone is popped, all new objects are allocated from it.
+ * Each object allocated from the zone retains it. */
+void cl_object_zone_push(cl_object_zone_t * zone);
+
+/** Pops the top-most zone from the zone stack. */
+void cl_object_zone_pop();
+
 /** Default object comparator. 
  * Compares the object by memory address. */
 int cl_object_comparator(const void *p1, const void *p2);
@@ -28,6 +28,16 @@ struct cl_object_info_s {
 	size_t _ref;
 	cl_object_destructor_t _dest;
 	cl_object_printer_t _to_str;
+	cl_object_zone_t *_zone;
+};
+
+struct cl_object_zone_s {
+	size_t _ref;
+	size_t _chunk_size;
+	size_t _available;
+	char *_next;
+	void *_chunks;
+	cl_object_zone_t *_outer;
 };
 
 struct cl_object_s {
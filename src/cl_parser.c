@@ -0,0 +1,487 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "cl_parser.h"
+#include "cl_parser_rep.h"
+#include "cl_proposition_rep.h"
+
+#define SYMBOLS_SIZE 256
+
+typedef enum {
+	TOKEN_END,
+	TOKEN_SEPARATOR,
+	TOKEN_ERROR,
+	TOKEN_OPEN,
+	TOKEN_CLOSE,
+	TOKEN_NOT,
+	TOKEN_AND,
+	TOKEN_OR,
+	TOKEN_XOR,
+	TOKEN_IMPLY,
+	TOKEN_EQUIVALENT,
+	TOKEN_TRUE,
+	TOKEN_FALSE,
+	TOKEN_NAME
+} token_t;
+
+/* binary operators from the loosest to the tightest */
+static const token_t levels[] = {
+	TOKEN_EQUIVALENT, TOKEN_IMPLY, TOKEN_XOR, TOKEN_OR, TOKEN_AND
+};
+
+#define LEVELS (sizeof(levels) / sizeof(levels[0]))
+
+static void destructor(void *self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+	cl_parser_t *parser = (cl_parser_t *) self;
+
+	for (size_t i = 0; i < parser->_size; i++) {
+		if (parser->_symbols[i]) {
+			cl_object_release(parser->_symbols[i]->proposition);
+		}
+	}
+
+	free(parser->_symbols);
+	cl_object_zone_release(parser->_zone);
+}
+
+cl_parser_t *cl_parser_new()
+{
+	cl_parser_t *res =
+	    cl_object_new(sizeof(cl_parser_t), CL_OBJECT_TYPE_PARSER,
+			  &destructor, NULL);
+
+	res->_zone = cl_object_zone_new(0);
+	res->_size = SYMBOLS_SIZE;
+	res->_count = 0;
+	res->_symbols = calloc(res->_size, sizeof(cl_parser_symbol_t *));
+	assert(res->_symbols);
+
+	res->_text = NULL;
+	res->_pos = NULL;
+	res->_nesting = 0;
+	res->_lines = false;
+	res->_error = SIZE_MAX;
+
+	return res;
+}
+
+bool cl_parser_symbol_op(cl_proposition_t * self)
+{
+	cl_proposition_context_t *ctx = cl_proposition_get_context(self);
+	return ((cl_parser_symbol_t *) ctx->argv[0])->value;
+}
+
+static void symbol_printer(void *self, cl_object_stream_t * stream)
+{
+	cl_proposition_context_t *ctx = cl_proposition_get_context(self);
+	cl_object_stream_puts(stream, ((cl_parser_symbol_t *) ctx->argv[0])->name);
+}
+
+/* FNV-1a */
+static size_t hash(const char *name, size_t len)
+{
+	size_t h = 2166136261u;
+	for (size_t i = 0; i < len; i++) {
+		h ^= (unsigned char)name[i];
+		h *= 16777619u;
+	}
+
+	return h;
+}
+
+/* returns the slot of the symbol, or the empty slot where it should be inserted */
+static size_t slot(cl_parser_t * self, const char *name, size_t len, size_t h)
+{
+	size_t i = h & (self->_size - 1);
+	while (self->_symbols[i]) {
+		cl_parser_symbol_t *s = self->_symbols[i];
+		if (s->hash == h && s->len == len
+		    && memcmp(s->name, name, len) == 0) {
+			break;
+		}
+
+		i = (i + 1) & (self->_size - 1);
+	}
+
+	return i;
+}
+
+/* inserts a new symbol, bound to the provided proposition (retained),
+ * or to a new atomic proposition if NULL is provided */
+static cl_parser_symbol_t *insert(cl_parser_t * self, const char *name,
+				  size_t len, size_t h,
+				  cl_proposition_t * proposition)
+{
+	/* keep the load factor under 1/2 */
+	if (2 * (self->_count + 1) > self->_size) {
+		cl_parser_symbol_t **old = self->_symbols;
+		size_t size = self->_size;
+
+		self->_size *= 2;
+		self->_symbols =
+		    calloc(self->_size, sizeof(cl_parser_symbol_t *));
+		assert(self->_symbols);
+
+		for (size_t i = 0; i < size; i++) {
+			if (old[i]) {
+				self->_symbols[slot(self, old[i]->name,
+						    old[i]->len,
+						    old[i]->hash)] = old[i];
+			}
+		}
+
+		free(old);
+	}
+
+	cl_parser_symbol_t *s =
+	    cl_object_zone_alloc(self->_zone,
+				 sizeof(cl_parser_symbol_t) + len + 1);
+	assert(s);
+
+	s->hash = h;
+	s->len = len;
+	s->value = false;
+	memcpy(s->name, name, len);
+	s->name[len] = '\0';
+
+	/* NOTE: the public functions push the zone,
+	 * so the new atomic propositions are allocated from it */
+	if (proposition) {
+		s->proposition = cl_object_retain(proposition);
+	} else {
+		s->proposition = cl_proposition_new(&cl_parser_symbol_op, s);
+		s->proposition->_obj_info._to_str = &symbol_printer;
+	}
+
+	self->_symbols[slot(self, name, len, h)] = s;
+	self->_count++;
+
+	return s;
+}
+
+static cl_parser_symbol_t *lookup(cl_parser_t * self, const char *name,
+				  size_t len)
+{
+	size_t h = hash(name, len);
+	cl_parser_symbol_t *s = self->_symbols[slot(self, name, len, h)];
+
+	return s ? s : insert(self, name, len, h, NULL);
+}
+
+bool cl_parser_bind(cl_parser_t * self, const char *name,
+		    cl_proposition_t * proposition)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+	assert(cl_object_type_check(proposition, CL_OBJECT_TYPE_PROPOSITION));
+
+	size_t len = strlen(name);
+	size_t h = hash(name, len);
+	if (self->_symbols[slot(self, name, len, h)]) {
+		return false;
+	}
+
+	insert(self, name, len, h, proposition);
+	return true;
+}
+
+cl_proposition_t *cl_parser_symbol(cl_parser_t * self, const char *name)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+
+	cl_object_zone_push(self->_zone);
+	cl_parser_symbol_t *s = lookup(self, name, strlen(name));
+	cl_object_zone_pop();
+
+	return s->proposition;
+}
+
+bool cl_parser_assign(cl_parser_t * self, const char *name, bool value)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+
+	cl_object_zone_push(self->_zone);
+	cl_parser_symbol_t *s = lookup(self, name, strlen(name));
+	cl_object_zone_pop();
+
+	cl_proposition_context_t *ctx =
+	    cl_proposition_get_context(s->proposition);
+	if (ctx->op != &cl_parser_symbol_op || ctx->argv[0] != s) {
+		return false;
+	}
+
+	s->value = value;
+	return true;
+}
+
+static bool is_name_char(char c, bool first)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'
+	    || (!first && c >= '0' && c <= '9');
+}
+
+/* returns the next token without consuming it, and sets its length */
+static token_t peek(cl_parser_t * self, size_t *len)
+{
+	const char *p = self->_pos;
+	while (*p == ' ' || *p == '\t' || *p == '\r'
+	       || (*p == '\n' && (!self->_lines || self->_nesting))) {
+		p++;
+	}
+	self->_pos = p;
+	*len = 1;
+
+	switch (*p) {
+	case '\0':
+		*len = 0;
+		return TOKEN_END;
+	case '\n':
+	case ';':
+		return TOKEN_SEPARATOR;
+	case '(':
+		return TOKEN_OPEN;
+	case ')':
+		return TOKEN_CLOSE;
+	case '~':
+		return TOKEN_NOT;
+	case '^':
+		return TOKEN_AND;
+	case '+':
+		return TOKEN_XOR;
+	case '=':
+		*len = 2;
+		return p[1] == '>' ? TOKEN_IMPLY : TOKEN_ERROR;
+	case '<':
+		*len = 3;
+		return p[1] == '=' && p[2] == '>' ? TOKEN_EQUIVALENT :
+		    TOKEN_ERROR;
+	}
+
+	if (!is_name_char(*p, true)) {
+		return TOKEN_ERROR;
+	}
+
+	size_t n = 1;
+	while (is_name_char(p[n], false)) {
+		n++;
+	}
+	*len = n;
+
+	if (n == 1 && *p == 'v') {
+		return TOKEN_OR;
+	} else if (n == 4 && memcmp(p, "TRUE", 4) == 0) {
+		return TOKEN_TRUE;
+	} else if (n == 5 && memcmp(p, "FALSE", 5) == 0) {
+		return TOKEN_FALSE;
+	}
+
+	return TOKEN_NAME;
+}
+
+static cl_proposition_operator_t operator(token_t token)
+{
+	switch (token) {
+	case TOKEN_AND:
+		return &cl_proposition_and_op;
+	case TOKEN_OR:
+		return &cl_proposition_or_op;
+	case TOKEN_XOR:
+		return &cl_proposition_xor_op;
+	case TOKEN_IMPLY:
+		return &cl_proposition_imply_op;
+	default:
+		return &cl_proposition_equivalent_op;
+	}
+}
+
+static cl_proposition_t *error(cl_parser_t * self)
+{
+	if (self->_error == SIZE_MAX) {
+		self->_error = self->_pos - self->_text;
+	}
+
+	return NULL;
+}
+
+static cl_proposition_t *parse_level(cl_parser_t * self, size_t level);
+
+/* all the parsing functions return retained propositions, or NULL on error */
+static cl_proposition_t *parse_unary(cl_parser_t * self)
+{
+	size_t len = 0;
+	token_t token = peek(self, &len);
+	const char *start = self->_pos;
+	self->_pos += len;
+
+	switch (token) {
+	case TOKEN_NOT:{
+			cl_proposition_t *p = parse_unary(self);
+			if (!p) {
+				return NULL;
+			}
+
+			cl_proposition_t *res =
+			    cl_proposition_new(&cl_proposition_not_op, p);
+			cl_object_release(p);
+			return res;
+		}
+	case TOKEN_OPEN:{
+			self->_nesting++;
+			cl_proposition_t *p = parse_level(self, 0);
+			self->_nesting--;
+			if (!p) {
+				return NULL;
+			}
+
+			if (peek(self, &len) != TOKEN_CLOSE) {
+				cl_object_release(p);
+				return error(self);
+			}
+
+			self->_pos += len;
+			return p;
+		}
+	case TOKEN_TRUE:
+		return cl_proposition_new(&cl_proposition_true_op);
+	case TOKEN_FALSE:
+		return cl_proposition_new(&cl_proposition_false_op);
+	case TOKEN_NAME:
+		return cl_object_retain(lookup(self, start, len)->proposition);
+	default:
+		self->_pos = start;
+		return error(self);
+	}
+}
+
+static cl_proposition_t *parse_level(cl_parser_t * self, size_t level)
+{
+	if (level == LEVELS) {
+		return parse_unary(self);
+	}
+
+	cl_proposition_t *res = parse_level(self, level + 1);
+	size_t len = 0;
+
+	while (res && peek(self, &len) == levels[level]) {
+		self->_pos += len;
+
+		/* IMPLY is right associative */
+		cl_proposition_t *p = levels[level] == TOKEN_IMPLY
+		    ? parse_level(self, level)
+		    : parse_level(self, level + 1);
+		if (!p) {
+			cl_object_release(res);
+			return NULL;
+		}
+
+		cl_proposition_t *temp =
+		    cl_proposition_new(operator(levels[level]), res, p);
+		cl_object_release(res);
+		cl_object_release(p);
+		res = temp;
+	}
+
+	return res;
+}
+
+/* parses one formula, followed by a separator or the end of the input */
+static cl_proposition_t *parse(cl_parser_t * self)
+{
+	cl_proposition_t *res = parse_level(self, 0);
+
+	size_t len = 0;
+	token_t token = peek(self, &len);
+	if (res && token != TOKEN_END && token != TOKEN_SEPARATOR) {
+		cl_object_release(res);
+		return error(self);
+	}
+
+	return res;
+}
+
+static void reset(cl_parser_t * self, const char *text, bool lines)
+{
+	self->_text = text;
+	self->_pos = text;
+	self->_nesting = 0;
+	self->_lines = lines;
+	self->_error = SIZE_MAX;
+}
+
+cl_proposition_t *cl_parser_parse(cl_parser_t * self, const char *text)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+
+	reset(self, text, false);
+	cl_object_zone_push(self->_zone);
+	cl_proposition_t *res = parse(self);
+	cl_object_zone_pop();
+
+	/* only one formula is expected */
+	size_t len = 0;
+	if (res && peek(self, &len) != TOKEN_END) {
+		cl_object_release(res);
+		res = error(self);
+	}
+
+	return cl_object_autorelease(res);
+}
+
+cl_collection_t *cl_parser_parse_all(cl_parser_t * self, const char *text)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+
+	cl_collection_t *res = cl_collection_new(0, CL_OBJECT_TYPE_PROPOSITION,
+						 CL_COLLECTION_FLAG_AUTORESIZE);
+	reset(self, text, true);
+	cl_object_zone_push(self->_zone);
+
+	size_t len = 0;
+	token_t token = peek(self, &len);
+	while (token != TOKEN_END) {
+		if (token == TOKEN_SEPARATOR) {
+			self->_pos += len;
+			token = peek(self, &len);
+			continue;
+		}
+
+		cl_proposition_t *p = parse(self);
+		if (!p) {
+			cl_object_release(res);
+			res = NULL;
+			break;
+		}
+
+		cl_collection_add(res, p);
+		cl_object_release(p);
+		token = peek(self, &len);
+	}
+
+	cl_object_zone_pop();
+	return cl_object_autorelease(res);
+}
+
+size_t cl_parser_error(cl_parser_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PARSER));
+	return self->_error;
+}
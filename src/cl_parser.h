@@ -0,0 +1,76 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CL_PARSER_H
+#define CL_PARSER_H
+
+#include "cl_object.h"
+#include "cl_proposition.h"
+#include "cl_collection.h"
+
+/** Parser object type flag. */
+#define CL_OBJECT_TYPE_PARSER 0x40
+
+/** Object type representing a parser of propositional formulas.
+ * The syntax is the one used by the proposition printer:
+ * TRUE, FALSE, ~P, (P ^ Q), (P v Q), (P => Q), (P <=> Q) and (P + Q).
+ * The parentheses may be omitted, in which case the operators bind,
+ * from the tightest to the loosest: ~, ^, v, +, => (right associative) and <=>.<BR>
+ * Names are made of letters, digits and underscores, and can't start with a digit.
+ * The name 'v' is reserved for the OR operator.<BR>
+ * All the propositions are allocated from a single memory zone owned by the parser,
+ * and all the occurrences of a name, in all the parsed formulas, share the same atomic proposition. */
+typedef struct cl_parser_s cl_parser_t;
+
+/** Initializes a new parser. */
+cl_parser_t *cl_parser_new();
+
+/** The operator of the atomic propositions created by the parser.
+ * Evaluates to the value assigned with @ref cl_parser_assign, FALSE by default. */
+bool cl_parser_symbol_op(cl_proposition_t * self);
+
+/** Binds the name to the provided proposition.
+ * All further occurrences of the name will be replaced by the proposition.
+ * @return false if the name is already in use, true otherwise. */
+bool cl_parser_bind(cl_parser_t * self, const char *name,
+		    cl_proposition_t * proposition);
+
+/** Returns the proposition the name refers to, creating a new atomic proposition if needed. 
+ * The atomic propositions created by the parser are printed by their names. */
+cl_proposition_t *cl_parser_symbol(cl_parser_t * self, const char *name);
+
+/** Assigns a value to the atomic proposition created by the parser.
+ * @return false if the name is bound to a proposition not created by the parser, true otherwise. */
+bool cl_parser_assign(cl_parser_t * self, const char *name, bool value);
+
+/** Parses a single formula.
+ * @return The new, autoreleased, proposition, or NULL in a case of a syntax error. */
+cl_proposition_t *cl_parser_parse(cl_parser_t * self, const char *text);
+
+/** Parses a list of formulas, separated by new lines or semicolons.
+ * Empty formulas are skipped.
+ * @return A new, autoreleased, collection of the propositions, or NULL in a case of a syntax error. */
+cl_collection_t *cl_parser_parse_all(cl_parser_t * self, const char *text);
+
+/** Returns the offset of the last syntax error in the parsed text, or SIZE_MAX if there was none. */
+size_t cl_parser_error(cl_parser_t * self);
+
+/** Returns a new, autoreleased, parser. */
+#define cl_parser() cl_object_autorelease(cl_parser_new())
+
+#endif				/* CL_PARSER_H */
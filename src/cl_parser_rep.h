@@ -0,0 +1,54 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CL_PARSER_REP_H
+#define CL_PARSER_REP_H
+
+#include "cl_parser.h"
+#include "cl_object_rep.h"
+
+/** Symbol table entry.
+ * Allocated from the parser's zone, so it outlives the parser
+ * as long as the propositions referring to it are alive. */
+typedef struct cl_parser_symbol_s cl_parser_symbol_t;
+struct cl_parser_symbol_s {
+	cl_proposition_t *proposition;
+	size_t hash;
+	size_t len;
+	bool value;
+	char name[];
+};
+
+struct cl_parser_s {
+	cl_object_info_t _obj_info;
+	cl_object_zone_t *_zone;
+
+	/* open addressing hash table of symbols */
+	cl_parser_symbol_t **_symbols;
+	size_t _size;
+	size_t _count;
+
+	/* current input */
+	const char *_text;
+	const char *_pos;
+	size_t _nesting;
+	bool _lines;
+	size_t _error;
+};
+
+#endif				/* CL_PARSER_REP_H */
@@ -34,123 +34,92 @@ static void destructor(void *self)
 	}
 }
 
-static char *print_complex_proposition(cl_proposition_t * p, char *op)
+static void print_complex_proposition(cl_proposition_t * p, const char *op,
+				      cl_object_stream_t * stream)
 {
-	char *prop1 = cl_object_to_string(p->_context.argv[0]);
-	char *prop2 = cl_object_to_string(p->_context.argv[1]);
-	size_t len1 = strlen(prop1);
-	size_t len2 = strlen(prop2);
-	size_t lenop = strlen(op);
-	size_t len = len1 + len2 + lenop + 5;
-	char *buffer = malloc(sizeof(char) * len);
-	assert(buffer);
-
-	strcpy(buffer, "(");
-	strcpy(buffer + 1, prop1);
-	strcpy(buffer + len1 + 1, " ");
-	strcpy(buffer + len1 + 2, op);
-	strcpy(buffer + len1 + lenop + 2, " ");
-	strcpy(buffer + len1 + lenop + 3, prop2);
-	strcpy(buffer + len1 + lenop + len2 + 3, ")");
-
-	free(prop1);
-	free(prop2);
-
-	return buffer;
+	cl_object_stream_puts(stream, "(");
+	cl_object_write(p->_context.argv[0], stream);
+	cl_object_stream_puts(stream, " ");
+	cl_object_stream_puts(stream, op);
+	cl_object_stream_puts(stream, " ");
+	cl_object_write(p->_context.argv[1], stream);
+	cl_object_stream_puts(stream, ")");
 }
 
-static char *print_negation(char *prop)
-{
-	size_t len = strlen(prop) + 2;
-	char *buffer = malloc(sizeof(char) * len);
-	assert(buffer);
-
-	strcpy(buffer, "~");
-	strcpy(buffer + 1, prop);
-
-	return buffer;
-}
-
-static char *proposition_printer(void *self)
+static void proposition_printer(void *self, cl_object_stream_t * stream)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_PROPOSITION));
 	cl_proposition_t *p = (cl_proposition_t *) self;
 
-	char *buffer = NULL;
 	if (p->_context.op == cl_proposition_true_op) {
-		buffer = malloc(sizeof(char) * 5);
-		assert(buffer);
-		strcpy(buffer, "TRUE");
+		cl_object_stream_puts(stream, "TRUE");
 	} else if (p->_context.op == cl_proposition_false_op) {
-		buffer = malloc(sizeof(char) * 6);
-		assert(buffer);
-		strcpy(buffer, "FALSE");
+		cl_object_stream_puts(stream, "FALSE");
 	} else if (p->_context.op == cl_proposition_not_op) {
-		char *temp = cl_object_to_string(p->_context.argv[0]);
-		buffer = print_negation(temp);
-		free(temp);
+		cl_object_stream_puts(stream, "~");
+		cl_object_write(p->_context.argv[0], stream);
 	} else if (p->_context.op == cl_proposition_and_op) {
-		buffer = print_complex_proposition(p, "^");
+		print_complex_proposition(p, "^", stream);
 	} else if (p->_context.op == cl_proposition_or_op) {
-		buffer = print_complex_proposition(p, "v");
+		print_complex_proposition(p, "v", stream);
 	} else if (p->_context.op == cl_proposition_imply_op) {
-		buffer = print_complex_proposition(p, "=>");
+		print_complex_proposition(p, "=>", stream);
 	} else if (p->_context.op == cl_proposition_equivalent_op) {
-		buffer = print_complex_proposition(p, "<=>");
+		print_complex_proposition(p, "<=>", stream);
 	} else if (p->_context.op == cl_proposition_xor_op) {
-		buffer = print_complex_proposition(p, "+");
+		print_complex_proposition(p, "+", stream);
 	} else if (p->_context.op == cl_proposition_nand_op) {
-		char *temp = print_complex_proposition(p, "^");
-		buffer = print_negation(temp);
-		free(temp);
+		cl_object_stream_puts(stream, "~");
+		print_complex_proposition(p, "^", stream);
 	} else if (p->_context.op == cl_proposition_nor_op) {
-		char *temp = print_complex_proposition(p, "v");
-		buffer = print_negation(temp);
-		free(temp);
+		cl_object_stream_puts(stream, "~");
+		print_complex_proposition(p, "v", stream);
 	} else if (p->_context.op == cl_proposition_nimply_op) {
-		char *temp = print_complex_proposition(p, "=>");
-		buffer = print_negation(temp);
-		free(temp);
+		cl_object_stream_puts(stream, "~");
+		print_complex_proposition(p, "=>", stream);
 	} else {
-		buffer = cl_object_printer(self);
+		cl_object_printer(self, stream);
 	}
-
-	return buffer;
 }
 
-cl_proposition_t *cl_proposition_new(cl_proposition_operator_t op, ...)
+/* returns the number of arguments the operator expects,
+ * or -1 if the operator is not one of the logic operators (atomic proposition) */
+static int arity(cl_proposition_operator_t op)
 {
-	va_list ap;
-	size_t argc = 1;
-	bool formula = true;
-
-	/* find the right number of arguments we are expecting */
 	if (op == cl_proposition_true_op) {
-		argc = 0;
+		return 0;
 	} else if (op == cl_proposition_false_op) {
-		argc = 0;
+		return 0;
 	} else if (op == cl_proposition_not_op) {
-		argc = 1;
+		return 1;
 	} else if (op == cl_proposition_and_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_or_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_imply_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_equivalent_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_xor_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_nand_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_nor_op) {
-		argc = 2;
+		return 2;
 	} else if (op == cl_proposition_nimply_op) {
-		argc = 2;
-	} else {
-		formula = false;
+		return 2;
 	}
 
+	return -1;
+}
+
+cl_proposition_t *cl_proposition_new(cl_proposition_operator_t op, ...)
+{
+	va_list ap;
+	int n = arity(op);
+	bool formula = n >= 0;
+	size_t argc = formula ? n : 1;
+
 	/* initialize the object */
 	cl_proposition_t *res =
 	    cl_object_new(sizeof(cl_proposition_t), CL_OBJECT_TYPE_PROPOSITION,
@@ -306,3 +275,400 @@ bool cl_proposition_nimply_op(cl_proposition_t * self)
 
 	return r1 && !r2;
 }
+
+size_t cl_proposition_size(cl_proposition_t * p)
+{
+	if (!p) {
+		return 0;
+	}
+
+	assert(cl_object_type_check(p, CL_OBJECT_TYPE_PROPOSITION));
+
+	size_t size = 1;
+	int n = arity(p->_context.op);
+	for (int i = 0; i < n; i++) {
+		size += cl_proposition_size(p->_context.argv[i]);
+	}
+
+	return size;
+}
+
+/* NULL operator (and NULL proposition) always evaluates to FALSE */
+static bool is_constant(cl_proposition_t * p, bool value)
+{
+	if (!p || !p->_context.op) {
+		return !value;
+	}
+
+	return p->_context.op ==
+	    (value ? cl_proposition_true_op : cl_proposition_false_op);
+}
+
+static bool is_commutative(cl_proposition_operator_t op)
+{
+	return op == cl_proposition_and_op
+	    || op == cl_proposition_or_op
+	    || op == cl_proposition_equivalent_op
+	    || op == cl_proposition_xor_op
+	    || op == cl_proposition_nand_op || op == cl_proposition_nor_op;
+}
+
+/* structural equality.
+ * Atomic propositions with same operator and data pointers are considered equal. */
+static bool is_equal(cl_proposition_t * p1, cl_proposition_t * p2)
+{
+	if (p1 == p2) {
+		return true;
+	}
+
+	if (!p1 || !p2 || p1->_context.op != p2->_context.op) {
+		return false;
+	}
+
+	int n = arity(p1->_context.op);
+	if (n < 0) {
+		return p1->_context.argv[0] == p2->_context.argv[0];
+	}
+
+	if (p1->_depth != p2->_depth) {
+		return false;
+	}
+
+	if (is_equal(p1->_context.argv[0], p2->_context.argv[0])
+	    && is_equal(p1->_context.argv[1], p2->_context.argv[1])) {
+		return true;
+	}
+
+	return is_commutative(p1->_context.op)
+	    && is_equal(p1->_context.argv[0], p2->_context.argv[1])
+	    && is_equal(p1->_context.argv[1], p2->_context.argv[0]);
+}
+
+/* checks if one of the propositions is the negation of the other */
+static bool is_complement(cl_proposition_t * p1, cl_proposition_t * p2)
+{
+	if (p1 && p1->_context.op == cl_proposition_not_op
+	    && is_equal(p1->_context.argv[0], p2)) {
+		return true;
+	}
+
+	return p2 && p2->_context.op == cl_proposition_not_op
+	    && is_equal(p2->_context.argv[0], p1);
+}
+
+/* checks if p1 absorbs p2, i.e. p2 is of the form (p1 op x) */
+static bool is_absorbing(cl_proposition_t * p1, cl_proposition_t * p2,
+			 cl_proposition_operator_t op)
+{
+	return p2->_context.op == op
+	    && (is_equal(p1, p2->_context.argv[0])
+		|| is_equal(p1, p2->_context.argv[1]));
+}
+
+static cl_proposition_t *constant(bool value)
+{
+	return cl_proposition_new(value ? &cl_proposition_true_op :
+				  &cl_proposition_false_op);
+}
+
+static cl_proposition_t *simplify(cl_proposition_t * p, bool negate);
+
+/* same as simplify, but consumes the provided reference */
+static cl_proposition_t *negation(cl_proposition_t * p)
+{
+	cl_proposition_t *res = simplify(p, true);
+	cl_object_release(p);
+
+	return res;
+}
+
+/* Combines two already simplified propositions with the provided operator.
+ * Both references are consumed, and the returned proposition is retained. */
+static cl_proposition_t *combine(cl_proposition_operator_t op,
+				 cl_proposition_t * p1, cl_proposition_t * p2)
+{
+	cl_proposition_t *res = NULL;
+	bool conj = op == cl_proposition_and_op;
+	bool xor = op == cl_proposition_xor_op;
+
+	if (op == cl_proposition_and_op || op == cl_proposition_or_op) {
+		/* the dominating constant: FALSE for AND, TRUE for OR */
+		if (is_constant(p1, !conj) || is_constant(p2, !conj)
+		    || is_complement(p1, p2)) {
+			res = constant(!conj);
+		} else if (is_constant(p1, conj)) {
+			res = cl_object_retain(p2);
+		} else if (is_constant(p2, conj)) {
+			res = cl_object_retain(p1);
+		} else if (is_equal(p1, p2)
+			   || is_absorbing(p1, p2,
+					   conj ? cl_proposition_or_op :
+					   cl_proposition_and_op)) {
+			res = cl_object_retain(p1);
+		} else if (is_absorbing(p2, p1,
+					conj ? cl_proposition_or_op :
+					cl_proposition_and_op)) {
+			res = cl_object_retain(p2);
+		}
+	} else {
+		/* XOR or EQUIVALENT: the neutral constant is FALSE for XOR and TRUE for EQUIVALENT */
+		if (is_equal(p1, p2)) {
+			res = constant(!xor);
+		} else if (is_complement(p1, p2)) {
+			res = constant(xor);
+		} else if (is_constant(p1, !xor)) {
+			res = cl_object_retain(p2);
+		} else if (is_constant(p2, !xor)) {
+			res = cl_object_retain(p1);
+		} else if (is_constant(p1, xor)) {
+			res = negation(cl_object_retain(p2));
+		} else if (is_constant(p2, xor)) {
+			res = negation(cl_object_retain(p1));
+		}
+	}
+
+	if (!res) {
+		res = cl_proposition_new(op, p1, p2);
+	}
+
+	cl_object_release(p1);
+	cl_object_release(p2);
+
+	return res;
+}
+
+/* Returns a retained, simplified, proposition equivalent to p (or ~p if negate is set).
+ * The result is in negation normal form, except for the EQUIVALENT and XOR
+ * operators which are kept (with simplified operands) to avoid exponential growth. */
+static cl_proposition_t *simplify(cl_proposition_t * p, bool negate)
+{
+	if (is_constant(p, true) || is_constant(p, false)) {
+		return constant(is_constant(p, true) != negate);
+	}
+
+	cl_proposition_operator_t op = p->_context.op;
+	cl_proposition_t *a = p->_context.argv[0];
+	cl_proposition_t *b = p->_context.argv[1];
+
+	/* atomic proposition */
+	if (arity(op) < 0) {
+		return negate ? cl_proposition_new(&cl_proposition_not_op, p)
+		    : cl_object_retain(p);
+	}
+
+	/* negation: double negations are removed by flipping the flag */
+	if (op == cl_proposition_not_op) {
+		return simplify(a, !negate);
+	}
+
+	/* lower NAND, NOR and NIMPLY to AND/OR, and push negations (De Morgan) */
+	if (op == cl_proposition_and_op || op == cl_proposition_nand_op) {
+		negate ^= op == cl_proposition_nand_op;
+		return combine(negate ? &cl_proposition_or_op :
+			       &cl_proposition_and_op, simplify(a, negate),
+			       simplify(b, negate));
+	}
+
+	if (op == cl_proposition_or_op || op == cl_proposition_nor_op) {
+		negate ^= op == cl_proposition_nor_op;
+		return combine(negate ? &cl_proposition_and_op :
+			       &cl_proposition_or_op, simplify(a, negate),
+			       simplify(b, negate));
+	}
+
+	/* a => b == ~a v b, and a =/=> b == a ^ ~b */
+	if (op == cl_proposition_imply_op || op == cl_proposition_nimply_op) {
+		negate ^= op == cl_proposition_nimply_op;
+		return combine(negate ? &cl_proposition_and_op :
+			       &cl_proposition_or_op, simplify(a, !negate),
+			       simplify(b, negate));
+	}
+
+	/* ~(a <=> b) == a + b */
+	if (op == cl_proposition_equivalent_op || op == cl_proposition_xor_op) {
+		negate ^= op == cl_proposition_xor_op;
+		return combine(negate ? &cl_proposition_xor_op :
+			       &cl_proposition_equivalent_op, simplify(a,
+								       false),
+			       simplify(b, false));
+	}
+
+	/* should not be reached */
+	assert(false);
+	return NULL;
+}
+
+cl_proposition_t *cl_proposition_simplify(cl_proposition_t * p,
+					  size_t *before, size_t *after)
+{
+	assert(!p || cl_object_type_check(p, CL_OBJECT_TYPE_PROPOSITION));
+
+	cl_proposition_t *res = simplify(p, false);
+
+	if (before) {
+		*before = cl_proposition_size(p);
+	}
+
+	if (after) {
+		*after = cl_proposition_size(res);
+	}
+
+	return cl_object_autorelease(res);
+}
+
+static bool is_associative(cl_proposition_operator_t op)
+{
+	return op == cl_proposition_and_op
+	    || op == cl_proposition_or_op
+	    || op == cl_proposition_equivalent_op
+	    || op == cl_proposition_xor_op;
+}
+
+/* builds a balanced tree out of the operands in the range [min, max) */
+static cl_proposition_t *build_balanced(cl_proposition_operator_t op,
+					cl_proposition_t ** operands,
+					size_t min, size_t max)
+{
+	if (max - min == 1) {
+		return cl_object_retain(operands[min]);
+	}
+
+	size_t mid = min + (max - min) / 2;
+	cl_proposition_t *a = build_balanced(op, operands, min, mid);
+	cl_proposition_t *b = build_balanced(op, operands, mid, max);
+	cl_proposition_t *res = cl_proposition_new(op, a, b);
+	cl_object_release(a);
+	cl_object_release(b);
+
+	return res;
+}
+
+/* Returns a retained, balanced, proposition equivalent to p.
+ * The recursion depth is bounded by the number of operator alternations,
+ * not by the length of the chains. */
+static cl_proposition_t *balance(cl_proposition_t * p)
+{
+	if (!p) {
+		return NULL;
+	}
+
+	cl_proposition_operator_t op = p->_context.op;
+	if (arity(op) <= 0) {
+		return cl_object_retain(p);
+	}
+
+	/* collapse runs of negations */
+	if (op == cl_proposition_not_op) {
+		bool odd = false;
+		cl_proposition_t *q = p;
+		while (q && q->_context.op == cl_proposition_not_op) {
+			odd = !odd;
+			q = q->_context.argv[0];
+		}
+
+		cl_proposition_t *inner = balance(q);
+		if (!odd) {
+			return inner;
+		}
+
+		if (inner == p->_context.argv[0]) {
+			cl_object_release(inner);
+			return cl_object_retain(p);
+		}
+
+		cl_proposition_t *res = cl_proposition_new(op, inner);
+		cl_object_release(inner);
+		return res;
+	}
+
+	/* non associative operators only get their operands balanced */
+	if (!is_associative(op)) {
+		cl_proposition_t *a = balance(p->_context.argv[0]);
+		cl_proposition_t *b = balance(p->_context.argv[1]);
+		cl_proposition_t *res =
+		    a == p->_context.argv[0] && b == p->_context.argv[1]
+		    ? cl_object_retain(p) : cl_proposition_new(op, a, b);
+		cl_object_release(a);
+		cl_object_release(b);
+
+		return res;
+	}
+
+	/* flatten the chain of the same operator, preserving the operands order */
+	size_t count = 0, capacity = 16;
+	size_t top = 0, stack_capacity = 16;
+	cl_proposition_t **operands = malloc(capacity * sizeof(void *));
+	cl_proposition_t **stack = malloc(stack_capacity * sizeof(void *));
+	assert(operands);
+	assert(stack);
+
+	stack[top++] = p;
+	while (top) {
+		cl_proposition_t *q = stack[--top];
+		if (q && q->_context.op == op) {
+			if (top + 2 > stack_capacity) {
+				stack_capacity *= 2;
+				stack = realloc(stack,
+						stack_capacity * sizeof(void *));
+				assert(stack);
+			}
+
+			stack[top++] = q->_context.argv[1];
+			stack[top++] = q->_context.argv[0];
+			continue;
+		}
+
+		if (count == capacity) {
+			capacity *= 2;
+			operands = realloc(operands, capacity * sizeof(void *));
+			assert(operands);
+		}
+		operands[count++] = q;
+	}
+	free(stack);
+
+	/* balance the operands, and build a balanced tree out of them,
+	 * unless the chain is already as shallow as the balanced tree would be */
+	bool changed = false;
+	size_t depth = 0;
+	for (size_t i = 0; i < count; i++) {
+		cl_proposition_t *q = balance(operands[i]);
+		changed |= q != operands[i];
+		operands[i] = q;
+
+		if (q && q->_depth > depth) {
+			depth = q->_depth;
+		}
+	}
+
+	for (size_t n = 1; n < count; n *= 2) {
+		depth++;
+	}
+	changed |= p->_depth > depth;
+
+	cl_proposition_t *res = changed
+	    ? build_balanced(op, operands, 0, count) : cl_object_retain(p);
+
+	for (size_t i = 0; i < count; i++) {
+		cl_object_release(operands[i]);
+	}
+	free(operands);
+
+	return res;
+}
+
+cl_proposition_t *cl_proposition_balance(cl_proposition_t * p)
+{
+	assert(!p || cl_object_type_check(p, CL_OBJECT_TYPE_PROPOSITION));
+	return cl_object_autorelease(balance(p));
+}
+
+size_t cl_proposition_depth(cl_proposition_t * p)
+{
+	if (!p) {
+		return 0;
+	}
+
+	assert(cl_object_type_check(p, CL_OBJECT_TYPE_PROPOSITION));
+	return p->_depth;
+}
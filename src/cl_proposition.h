@@ -53,6 +53,38 @@ cl_proposition_context_t *cl_proposition_get_context(cl_proposition_t * p);
 /** Evaluates the proposition. */
 bool cl_proposition_eval(cl_proposition_t * p);
 
+/** Returns the number of nodes (operators and atomic propositions) in the proposition.
+ * Shared sub-formulas are counted once for every occurrence. */
+size_t cl_proposition_size(cl_proposition_t * p);
+
+/** Rewrites the proposition into a smaller, equivalent, one.
+ * Constants are propagated, double negations removed,
+ * idempotent and absorbed sub-formulas eliminated,
+ * NAND, NOR and NOT IMPLY lowered to AND / OR,
+ * and negations pushed to the atomic propositions (De Morgan).
+ * EQUIVALENT and XOR operators are kept, since expanding them
+ * would grow the formula exponentially.<BR>
+ * Atomic propositions with same operator and data pointers are considered equal.
+ * @param p The proposition to be simplified. It is not modified.
+ * @param before If not NULL, set to the number of nodes in the original proposition.
+ * @param after If not NULL, set to the number of nodes in the simplified proposition.
+ * @return A new, autoreleased, proposition. Atomic propositions are shared with the original. */
+cl_proposition_t *cl_proposition_simplify(cl_proposition_t * p,
+					  size_t *before, size_t *after);
+
+/** Returns the depth of the proposition, 0 for the atomic propositions. */
+size_t cl_proposition_depth(cl_proposition_t * p);
+
+/** Rebalances the chains of associative operators (AND, OR, XOR, EQUIVALENT).
+ * A chain of N operands built by folding, with depth N - 1,
+ * is replaced with a balanced tree of depth log2(N).
+ * Runs of negations are collapsed as well.
+ * The evaluation and the printers are recursive,
+ * so deep chains should be balanced before being used.
+ * @param p The proposition to be balanced. It is not modified.
+ * @return A new, autoreleased, proposition, sharing the unchanged sub-formulas with the original. */
+cl_proposition_t *cl_proposition_balance(cl_proposition_t * p);
+
 /** The CONSTANT TRUE operator - tautology. */
 bool cl_proposition_true_op(cl_proposition_t * self);
 /** The CONSTANT FALSE operator - contradiction. */
@@ -16,18 +16,89 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+/* for clock_gettime */
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <time.h>
 #include "cl_sat.h"
 #include "cl_sat_rep.h"
+#include "cl_cnf_rep.h"
+#include "cl_thread.h"
+
+/* the statistics the search doesn't need can be compiled out */
+#ifdef CL_SAT_NO_STATISTICS
+#define STAT(statement)
+#else
+#define STAT(statement) statement
+#endif
+
+/** Marks a missing clause reference or heap index. */
+#define NIL UINT32_MAX
+
+#define VALUE_FALSE 0
+#define VALUE_TRUE 1
+#define VALUE_UNDEF 2
+
+/* clause layout in the arena: size, flags, LBD, literals ...
+ * The two highest flag bits count the reductions a used clause survives. */
+#define CLAUSE_HEADER 3
+#define CLAUSE_LEARNT 0x01
+#define CLAUSE_DELETED 0x02
+#define CLAUSE_MOVED 0x04
+#define CLAUSE_USED_SHIFT 6
+
+#define DEFAULT_VAR_DECAY 0.95
+#define RESCALE_LIMIT 1e100
+
+/* the polarity tried first when nothing is known about a variable */
+#define DEFAULT_PHASE VALUE_FALSE
+#define DEFAULT_REPHASE_INTERVAL 1000
+#define DEFAULT_WALK_FLIPS 10000
+
+#define DEFAULT_LUBY_UNIT 100
+#define DEFAULT_RESTART_MARGIN 1.25
+#define DEFAULT_TIER1_LBD 2
+#define DEFAULT_TIER2_LBD 6
+#define DEFAULT_REDUCE_INTERVAL 2000
+#define REDUCE_INCREMENT 300
+
+/* conflicts to wait after a restart before the averages are trusted */
+#define GLUCOSE_MIN_CONFLICTS 50
+#define GLUCOSE_FAST_ALPHA (1.0 / 32)
+
+/* seed of the random number generator unless set otherwise */
+#define DEFAULT_SEED 0x636c756d7379ull
+
+/* the time and the memory held, which take longer to find out than the
+ * counters, are checked every so many conflicts, decisions or flips,
+ * and every so many time checks respectively */
+#define BUDGET_CHECK_INTERVAL 16
+#define MEMORY_CHECK_INTERVAL 64
+
+/* probability, in percents, of a random step in the local search */
+#define WALK_NOISE 50
+
+/* a conflict of the XOR or the cardinality constraints at the root level,
+ * not explained by a clause */
+#define ROOT_CONFLICT (NIL - 1)
+
+/* marks a reason or a conflict referring to a cardinality constraint,
+ * whose literals are read off the constraint when needed */
+#define REASON_CARD 0x80000000u
+
+static void clear(cl_sat_t * self);
+static void unload(cl_sat_t * self);
 
 static void destructor(void *self)
 {
 	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
 	cl_sat_t *sat = (cl_sat_t *) self;
 
-	/* TODO: destory the object */
+	unload(sat);
+	cl_object_release(sat->_failed);
 }
 
 cl_sat_t *cl_sat_new()
@@ -35,59 +106,2340 @@ cl_sat_t *cl_sat_new()
 	cl_sat_t *res =
 	    cl_object_new(sizeof(cl_sat_t), CL_OBJECT_TYPE_SAT, &destructor,
 			  NULL);
+
+	res->_maxflips = 0;
+	res->_heuristic = CL_SAT_HEURISTIC_VSIDS;
+	res->_var_decay = DEFAULT_VAR_DECAY;
+	res->_var_inc = 1.0;
+	res->_rephase_interval = DEFAULT_REPHASE_INTERVAL;
+	res->_restart = CL_SAT_RESTART_GLUCOSE;
+	res->_luby_unit = DEFAULT_LUBY_UNIT;
+	res->_restart_margin = DEFAULT_RESTART_MARGIN;
+	res->_tier1_lbd = DEFAULT_TIER1_LBD;
+	res->_tier2_lbd = DEFAULT_TIER2_LBD;
+	res->_reduce_interval = DEFAULT_REDUCE_INTERVAL;
+	cl_sat_seed(res, DEFAULT_SEED, 0);
+	memset(&res->_stats, 0, sizeof(cl_sat_stats_t));
+	memset(res->_limits, 0, sizeof(res->_limits));
+	res->_progress = NULL;
+	res->_progress_data = NULL;
+	res->_progress_period = 0;
+	res->_exhausted = CL_SAT_BUDGET_NONE;
+	res->_interrupted = 0;
+	res->_parent = NULL;
+
+	/* the solver state is set up by the first call to cl_sat_solve */
+	clear(res);
+	res->_failed = NULL;
+
+	return res;
+}
+
+void cl_sat_heuristic_set(cl_sat_t * self, cl_sat_heuristic_t heuristic)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+	assert(heuristic == CL_SAT_HEURISTIC_RANDOM
+	       || heuristic == CL_SAT_HEURISTIC_VSIDS);
+
+	self->_heuristic = heuristic;
+}
+
+void cl_sat_restart_set(cl_sat_t * self, cl_sat_restart_t restart)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+	assert(restart == CL_SAT_RESTART_NONE
+	       || restart == CL_SAT_RESTART_LUBY
+	       || restart == CL_SAT_RESTART_GLUCOSE);
+
+	self->_restart = restart;
+}
+
+void cl_sat_budget_set(cl_sat_t * self, cl_sat_budget_t budget, size_t limit)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+	assert(budget > CL_SAT_BUDGET_NONE && budget < CL_SAT_BUDGET_INTERRUPT);
+
+	self->_limits[budget] = limit;
+}
+
+void cl_sat_progress_set(cl_sat_t * self, cl_sat_progress_callback_t callback,
+			 void *data, size_t period)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+
+	self->_progress = callback;
+	self->_progress_data = data;
+	self->_progress_period = period;
+}
+
+void cl_sat_interrupt(cl_sat_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+
+	self->_interrupted = 1;
+}
+
+cl_sat_budget_t cl_sat_exhausted(cl_sat_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+
+	return self->_exhausted;
+}
+
+void cl_sat_stats(cl_sat_t * self, cl_sat_stats_t * stats)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+
+	*stats = self->_stats;
+	stats->decisions += self->_decisions;
+	stats->propagations += self->_propagations;
+	stats->conflicts += self->_conflicts;
+	stats->restarts += self->_restarts;
+	stats->reductions += self->_reductions;
+}
+
+void cl_sat_stats_write(cl_sat_t * self, cl_object_stream_t * stream)
+{
+	cl_sat_stats_t stats;
+	cl_sat_stats(self, &stats);
+
+	cl_object_stream_printf(stream,
+				"{\"solves\": %zu, \"decisions\": %zu, "
+				"\"propagations\": %zu, \"conflicts\": %zu, "
+				"\"flips\": %zu, \"restarts\": %zu, "
+				"\"reductions\": %zu, \"learnt\": %zu, "
+				"\"deleted\": %zu, \"peak_memory\": %zu, "
+				"\"load_time\": %zu, \"walk_time\": %zu, "
+				"\"search_time\": %zu}",
+				stats.solves, stats.decisions,
+				stats.propagations, stats.conflicts,
+				stats.flips, stats.restarts, stats.reductions,
+				stats.learnt, stats.deleted, stats.peak_memory,
+				stats.load_time, stats.walk_time,
+				stats.search_time);
+}
+
+/* xoshiro256** generator, 64 bits of output per step */
+static uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t random_next(cl_sat_t * self)
+{
+	uint64_t *state = self->_random;
+	uint64_t res = rotl(state[1] * 5, 7) * 9;
+	uint64_t t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl(state[3], 45);
+
 	return res;
 }
 
-static void randomize()
+/* A random number in 0 .. n - 1, by multiplying instead of dividing. */
+static uint32_t random_below(cl_sat_t * self, uint32_t n)
+{
+	return (uint32_t) (((random_next(self) >> 32) * n) >> 32);
+}
+
+/* Advances the generator by 2^128 steps. */
+static void random_jump(cl_sat_t * self)
 {
-	static bool randomized = false;
-	if (!randomized) {
-		srand(time(0));
-		randomized = true;
+	static const uint64_t jump[] = {
+		0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+		0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+	};
+	uint64_t res[4] = { 0, 0, 0, 0 };
+
+	for (size_t i = 0; i < 4; i++) {
+		for (int b = 0; b < 64; b++) {
+			if (jump[i] & 1ull << b) {
+				for (size_t k = 0; k < 4; k++) {
+					res[k] ^= self->_random[k];
+				}
+			}
+			random_next(self);
+		}
 	}
+
+	memcpy(self->_random, res, sizeof(res));
 }
 
-static void init_try(cl_cnf_t * cnf)
+void cl_sat_seed(cl_sat_t * self, uint64_t seed, size_t stream)
 {
-	cl_collection_t *literals = cl_cnf_literals(cnf);
-	for (int i = 0; i < cl_collection_count(literals); i++) {
-		cl_cnf_literal_assign(cl_collection_get(literals, i),
-				      (rand() % 2));
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+
+	/* spread the seed over the state with splitmix64 */
+	for (size_t i = 0; i < 4; i++) {
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		self->_random[i] = z ^ (z >> 31);
+	}
+
+	while (stream--) {
+		random_jump(self);
 	}
 }
 
-static cl_cnf_literal_t *choose_literal(cl_sat_t * self, cl_cnf_t * cnf)
+static void vector_push(cl_sat_vector_t * vector, uint32_t value)
 {
-	/* TODO: choose the literal according to some heuristics */
-	cl_collection_t *literals = cl_cnf_literals(cnf);
-	size_t ind = rand() % cl_collection_count(literals);
+	if (vector->size == vector->capacity) {
+		vector->capacity = vector->capacity ? 2 * vector->capacity : 16;
+		vector->data =
+		    realloc(vector->data, vector->capacity * sizeof(uint32_t));
+		assert(vector->data);
+	}
 
-	return cl_collection_get(literals, ind);
+	vector->data[vector->size++] = value;
 }
 
-cl_collection_t *cl_sat_solve(cl_sat_t * self, cl_cnf_t * cnf)
+static void watch(cl_sat_t * self, uint32_t lit, uint32_t cref,
+		  uint32_t blocker)
+{
+	cl_sat_watches_t *ws = &self->_watches[lit];
+	if (ws->size == ws->capacity) {
+		ws->capacity = ws->capacity ? 2 * ws->capacity : 4;
+		ws->data = realloc(ws->data, ws->capacity * sizeof(cl_sat_watch_t));
+		assert(ws->data);
+	}
+
+	ws->data[ws->size].cref = cref;
+	ws->data[ws->size].blocker = blocker;
+	ws->size++;
+}
+
+static uint8_t value(cl_sat_t * self, uint32_t lit)
+{
+	uint8_t val = self->_assigns[lit >> 1];
+	return val == VALUE_UNDEF ? val : val ^ (lit & 1);
+}
+
+/* --- VSIDS activity heap ------------------------------------------------ */
+
+static bool heap_above(cl_sat_t * self, uint32_t a, uint32_t b)
+{
+	return self->_activity[a] > self->_activity[b];
+}
+
+static void heap_up(cl_sat_t * self, size_t pos)
+{
+	uint32_t var = self->_heap[pos];
+
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 2;
+		if (!heap_above(self, var, self->_heap[parent])) {
+			break;
+		}
+
+		self->_heap[pos] = self->_heap[parent];
+		self->_heap_index[self->_heap[pos]] = pos;
+		pos = parent;
+	}
+
+	self->_heap[pos] = var;
+	self->_heap_index[var] = pos;
+}
+
+static void heap_down(cl_sat_t * self, size_t pos)
+{
+	uint32_t var = self->_heap[pos];
+
+	for (;;) {
+		size_t child = 2 * pos + 1;
+		if (child >= self->_heap_size) {
+			break;
+		}
+
+		if (child + 1 < self->_heap_size
+		    && heap_above(self, self->_heap[child + 1],
+				  self->_heap[child])) {
+			child++;
+		}
+
+		if (!heap_above(self, self->_heap[child], var)) {
+			break;
+		}
+
+		self->_heap[pos] = self->_heap[child];
+		self->_heap_index[self->_heap[pos]] = pos;
+		pos = child;
+	}
+
+	self->_heap[pos] = var;
+	self->_heap_index[var] = pos;
+}
+
+static void heap_insert(cl_sat_t * self, uint32_t var)
+{
+	if (self->_heap_index[var] != NIL) {
+		return;
+	}
+
+	self->_heap[self->_heap_size] = var;
+	self->_heap_index[var] = self->_heap_size;
+	heap_up(self, self->_heap_size++);
+}
+
+static uint32_t heap_pop(cl_sat_t * self)
+{
+	uint32_t top = self->_heap[0];
+	self->_heap_index[top] = NIL;
+
+	if (--self->_heap_size > 0) {
+		self->_heap[0] = self->_heap[self->_heap_size];
+		heap_down(self, 0);
+	}
+
+	return top;
+}
+
+static void bump(cl_sat_t * self, uint32_t var)
+{
+	if ((self->_activity[var] += self->_var_inc) > RESCALE_LIMIT) {
+		/* rescaling keeps the order, so the heap stays valid */
+		for (size_t i = 0; i < self->_nvars; i++) {
+			self->_activity[i] /= RESCALE_LIMIT;
+		}
+		self->_var_inc /= RESCALE_LIMIT;
+	}
+
+	/* activities only grow, so the variable can only move up */
+	if (self->_heap_index[var] != NIL) {
+		heap_up(self, self->_heap_index[var]);
+	}
+}
+
+static void decay(cl_sat_t * self)
+{
+	self->_var_inc /= self->_var_decay;
+}
+
+/* --- solver state -------------------------------------------------------- */
+
+static void unload(cl_sat_t * self)
+{
+	if (self->_watches) {
+		for (size_t i = 0; i < 2 * self->_nvars; i++) {
+			free(self->_watches[i].data);
+		}
+	}
+
+	if (self->_card_occs) {
+		for (size_t i = 0; i < 2 * self->_nvars; i++) {
+			free(self->_card_occs[i].data);
+		}
+	}
+
+	free(self->_assigns);
+	free(self->_levels);
+	free(self->_reasons);
+	free(self->_seen);
+	free(self->_trail);
+	free(self->_trail_lim);
+	free(self->_arena);
+	free(self->_clauses.data);
+	free(self->_learnts.data);
+	free(self->_learnt.data);
+	free(self->_assumptions.data);
+	free(self->_xors.data);
+	free(self->_columns.data);
+	free(self->_column_of);
+	free(self->_matrix);
+	free(self->_work);
+	free(self->_pivotal);
+	free(self->_cards.data);
+	free(self->_card_starts.data);
+	free(self->_card_counts.data);
+	free(self->_card_occs);
+	free(self->_explanation.data);
+	free(self->_watches);
+	free(self->_activity);
+	free(self->_heap);
+	free(self->_heap_index);
+	free(self->_phases);
+	free(self->_target);
+	free(self->_best);
+	free(self->_stamps);
+	free(self->_index.keys);
+	free(self->_index.vars);
+	cl_object_release(self->_literals);
+	cl_object_release(self->_loaded);
+	cl_object_release(self->_synced);
+	cl_object_release(self->_cnf);
+
+	self->_stats.decisions += self->_decisions;
+	self->_stats.propagations += self->_propagations;
+	self->_stats.conflicts += self->_conflicts;
+	self->_stats.restarts += self->_restarts;
+	self->_stats.reductions += self->_reductions;
+
+	clear(self);
+}
+
+static void clear(cl_sat_t * self)
+{
+	self->_cnf = NULL;
+	self->_loaded = NULL;
+	self->_synced = NULL;
+	self->_synced_added = 0;
+	self->_synced_removals = 0;
+	memset(&self->_assumptions, 0, sizeof(cl_sat_vector_t));
+	self->_literals = NULL;
+	memset(&self->_index, 0, sizeof(cl_sat_index_t));
+	self->_nvars = 0;
+	self->_var_capacity = 0;
+	self->_level_capacity = 0;
+	self->_assigns = NULL;
+	self->_levels = NULL;
+	self->_reasons = NULL;
+	self->_seen = NULL;
+	self->_trail = NULL;
+	self->_trail_size = 0;
+	self->_trail_lim = NULL;
+	self->_decision_level = 0;
+	self->_qhead = 0;
+	self->_arena = NULL;
+	self->_arena_size = 0;
+	self->_arena_capacity = 0;
+	memset(&self->_clauses, 0, sizeof(cl_sat_vector_t));
+	memset(&self->_learnts, 0, sizeof(cl_sat_vector_t));
+	memset(&self->_learnt, 0, sizeof(cl_sat_vector_t));
+	self->_xors_loaded = 0;
+	memset(&self->_xors, 0, sizeof(cl_sat_vector_t));
+	memset(&self->_columns, 0, sizeof(cl_sat_vector_t));
+	self->_column_of = NULL;
+	self->_matrix = NULL;
+	self->_work = NULL;
+	self->_pivotal = NULL;
+	self->_rows = 0;
+	self->_words = 0;
+	self->_xors_dirty = false;
+	self->_cards_loaded = 0;
+	memset(&self->_cards, 0, sizeof(cl_sat_vector_t));
+	memset(&self->_card_starts, 0, sizeof(cl_sat_vector_t));
+	memset(&self->_card_counts, 0, sizeof(cl_sat_vector_t));
+	self->_card_occs = NULL;
+	self->_card_head = 0;
+	memset(&self->_explanation, 0, sizeof(cl_sat_vector_t));
+	self->_watches = NULL;
+	self->_activity = NULL;
+	self->_heap = NULL;
+	self->_heap_index = NULL;
+	self->_heap_size = 0;
+	self->_phases = NULL;
+	self->_target = NULL;
+	self->_target_size = 0;
+	self->_best = NULL;
+	self->_best_size = 0;
+	self->_rephases = 0;
+	self->_next_rephase = 0;
+	self->_conflicts = 0;
+	self->_decisions = 0;
+	self->_propagations = 0;
+	self->_restarts = 0;
+	self->_reductions = 0;
+	self->_since_restart = 0;
+	self->_lbd_fast = 0;
+	self->_lbd_sum = 0;
+	self->_next_reduce = 0;
+	self->_stamps = NULL;
+	self->_stamp = 0;
+	self->_ok = true;
+}
+
+static void enqueue(cl_sat_t * self, uint32_t lit, uint32_t reason)
+{
+	uint32_t var = lit >> 1;
+
+	self->_assigns[var] = !(lit & 1);
+	self->_levels[var] = self->_decision_level;
+	self->_reasons[var] = reason;
+	self->_trail[self->_trail_size++] = lit;
+}
+
+static uint32_t clause_new(cl_sat_t * self, uint32_t * lits, size_t size,
+			   uint8_t flags, uint32_t lbd)
+{
+	size_t needed = self->_arena_size + CLAUSE_HEADER + size;
+	assert(needed < REASON_CARD);
+
+	if (needed > self->_arena_capacity) {
+		size_t capacity =
+		    self->_arena_capacity ? self->_arena_capacity : 1024;
+		while (capacity < needed) {
+			capacity *= 2;
+		}
+
+		self->_arena = realloc(self->_arena, capacity * sizeof(uint32_t));
+		assert(self->_arena);
+		self->_arena_capacity = capacity;
+	}
+
+	uint32_t cref = self->_arena_size;
+	self->_arena[cref] = size;
+	self->_arena[cref + 1] = flags;
+	self->_arena[cref + 2] = lbd;
+	memcpy(self->_arena + cref + CLAUSE_HEADER, lits,
+	       size * sizeof(uint32_t));
+	self->_arena_size = needed;
+
+	/* watch the first two literals */
+	watch(self, lits[0], cref, lits[1]);
+	watch(self, lits[1], cref, lits[0]);
+
+	return cref;
+}
+
+static int lit_comparator(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static size_t index_slot(cl_sat_index_t * index, void *key)
+{
+	size_t mask = index->capacity - 1;
+	size_t slot = ((uintptr_t) key >> 4) * 2654435761u & mask;
+
+	while (index->keys[slot] && index->keys[slot] != key) {
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+static uint32_t index_find(cl_sat_index_t * index, void *key)
+{
+	if (!index->capacity) {
+		return NIL;
+	}
+
+	size_t slot = index_slot(index, key);
+	return index->keys[slot] ? index->vars[slot] : NIL;
+}
+
+static void index_add(cl_sat_index_t * index, void *key, uint32_t var)
+{
+	size_t slot = index_slot(index, key);
+	index->keys[slot] = key;
+	index->vars[slot] = var;
+}
+
+/* Makes room for the decision levels up to n - 1. */
+static void reserve_levels(cl_sat_t * self, size_t n)
+{
+	if (n <= self->_level_capacity) {
+		return;
+	}
+
+	self->_trail_lim = realloc(self->_trail_lim, n * sizeof(uint32_t));
+	self->_stamps = realloc(self->_stamps, n * sizeof(uint32_t));
+	assert(self->_trail_lim && self->_stamps);
+
+	memset(self->_stamps + self->_level_capacity, 0,
+	       (n - self->_level_capacity) * sizeof(uint32_t));
+	self->_level_capacity = n;
+}
+
+/* Makes room for n variables. */
+static void reserve(cl_sat_t * self, size_t n)
+{
+	if (n <= self->_var_capacity) {
+		return;
+	}
+
+	size_t old = self->_var_capacity;
+	size_t capacity = old ? old : 64;
+	while (capacity < n) {
+		capacity *= 2;
+	}
+
+	self->_assigns = realloc(self->_assigns, capacity * sizeof(uint8_t));
+	self->_levels = realloc(self->_levels, capacity * sizeof(uint32_t));
+	self->_reasons = realloc(self->_reasons, capacity * sizeof(uint32_t));
+	self->_seen = realloc(self->_seen, capacity * sizeof(uint8_t));
+	self->_trail = realloc(self->_trail, capacity * sizeof(uint32_t));
+	self->_watches =
+	    realloc(self->_watches, 2 * capacity * sizeof(cl_sat_watches_t));
+	self->_activity = realloc(self->_activity, capacity * sizeof(double));
+	self->_heap = realloc(self->_heap, capacity * sizeof(uint32_t));
+	self->_heap_index =
+	    realloc(self->_heap_index, capacity * sizeof(uint32_t));
+	self->_phases = realloc(self->_phases, capacity * sizeof(uint8_t));
+	self->_target = realloc(self->_target, capacity * sizeof(uint8_t));
+	self->_best = realloc(self->_best, capacity * sizeof(uint8_t));
+	self->_column_of =
+	    realloc(self->_column_of, capacity * sizeof(uint32_t));
+	self->_card_occs =
+	    realloc(self->_card_occs, 2 * capacity * sizeof(cl_sat_vector_t));
+	assert(self->_assigns && self->_levels && self->_reasons
+	       && self->_seen && self->_trail && self->_watches
+	       && self->_activity && self->_heap && self->_heap_index
+	       && self->_phases && self->_target && self->_best
+	       && self->_column_of && self->_card_occs);
+
+	memset(self->_seen + old, 0, (capacity - old) * sizeof(uint8_t));
+	memset(self->_watches + 2 * old, 0,
+	       2 * (capacity - old) * sizeof(cl_sat_watches_t));
+	memset(self->_card_occs + 2 * old, 0,
+	       2 * (capacity - old) * sizeof(cl_sat_vector_t));
+	self->_var_capacity = capacity;
+
+	/* every variable may take a level of its own */
+	reserve_levels(self, capacity + self->_assumptions.size + 1);
+
+	/* keep the index at most half full */
+	cl_sat_index_t index = {
+		calloc(4 * capacity, sizeof(void *)),
+		malloc(4 * capacity * sizeof(uint32_t)),
+		4 * capacity
+	};
+	assert(index.keys && index.vars);
+
+	for (uint32_t var = 0; var < self->_nvars; var++) {
+		index_add(&index, cl_collection_get(self->_literals, var), var);
+	}
+
+	free(self->_index.keys);
+	free(self->_index.vars);
+	self->_index = index;
+}
+
+/* Returns the variable of the (non-negated) literal,
+ * introducing a new one if the literal wasn't seen before. */
+static uint32_t variable(cl_sat_t * self, cl_cnf_literal_t * literal)
+{
+	uint32_t var = index_find(&self->_index, literal);
+	if (var != NIL) {
+		return var;
+	}
+
+	var = self->_nvars;
+	reserve(self, var + 1);
+	self->_nvars++;
+
+	cl_collection_add(self->_literals, literal);
+	index_add(&self->_index, literal, var);
+
+	self->_assigns[var] = VALUE_UNDEF;
+	self->_levels[var] = 0;
+	self->_reasons[var] = NIL;
+	self->_activity[var] = 0;
+	self->_phases[var] = DEFAULT_PHASE;
+	self->_target[var] = VALUE_UNDEF;
+	self->_best[var] = VALUE_UNDEF;
+	self->_heap_index[var] = NIL;
+	self->_column_of[var] = NIL;
+	heap_insert(self, var);
+
+	return var;
+}
+
+static uint32_t literal(cl_sat_t * self, cl_cnf_literal_t * literal)
+{
+	cl_cnf_literal_t *pos = literal->_negation ? literal->_dual : literal;
+	return 2 * variable(self, pos) + literal->_negation;
+}
+
+static uint32_t propagate(cl_sat_t * self);
+
+/* Translates the clause and adds it at the root level. */
+static void add(cl_sat_t * self, cl_collection_t * clause)
+{
+	assert(self->_decision_level == 0);
+
+	cl_sat_vector_t *lits = &self->_learnt;
+	lits->size = 0;
+	for (size_t j = 0; j < cl_collection_count(clause); j++) {
+		vector_push(lits, literal(self, cl_collection_get(clause, j)));
+	}
+
+	/* drop false literals and satisfied or tautological clauses */
+	if (lits->size > 1) {
+		qsort(lits->data, lits->size, sizeof(uint32_t),
+		      &lit_comparator);
+	}
+	size_t size = 0;
+	bool satisfied = false;
+	for (size_t j = 0; j < lits->size && !satisfied; j++) {
+		uint32_t lit = lits->data[j];
+		satisfied = value(self, lit) == VALUE_TRUE
+		    || (size && lits->data[size - 1] == (lit ^ 1));
+
+		if (value(self, lit) == VALUE_UNDEF) {
+			lits->data[size++] = lit;
+		}
+	}
+
+	if (satisfied) {
+		return;
+	}
+
+	if (size == 0) {
+		self->_ok = false;
+	} else if (size == 1) {
+		enqueue(self, lits->data[0], NIL);
+		self->_ok = propagate(self) == NIL;
+	} else {
+		vector_push(&self->_clauses,
+			    clause_new(self, lits->data, size, 0, 0));
+	}
+}
+
+/* Translates the XOR constraint into a row of variables,
+ * giving the new variables a column of the matrix. */
+static void add_xor(cl_sat_t * self, cl_collection_t * xor)
+{
+	size_t start = self->_xors.size;
+	size_t size = cl_collection_count(xor);
+	uint32_t parity = 1;
+
+	vector_push(&self->_xors, size);
+	vector_push(&self->_xors, 0);
+	for (size_t j = 0; j < size; j++) {
+		uint32_t lit = literal(self, cl_collection_get(xor, j));
+		uint32_t var = lit >> 1;
+
+		parity ^= lit & 1;
+		if (self->_column_of[var] == NIL) {
+			self->_column_of[var] = self->_columns.size;
+			vector_push(&self->_columns, var);
+		}
+		vector_push(&self->_xors, var);
+	}
+
+	self->_xors.data[start + 1] = parity;
+	self->_xors_dirty = true;
+}
+
+/* Translates the cardinality constraint at the root level,
+ * leaving out the literals assigned already. */
+static void add_card(cl_sat_t * self, cl_collection_t * card, size_t bound)
 {
-	randomize();
-	init_try(cnf);
+	cl_sat_vector_t *lits = &self->_learnt;
+	lits->size = 0;
 
-	/* if we have a solution - return it imediatly */
-	if (cl_cnf_evaluate(cnf)) {
-		return cl_cnf_literals(cnf);
+	for (size_t j = 0; j < cl_collection_count(card); j++) {
+		uint32_t lit = literal(self, cl_collection_get(card, j));
+		if (value(self, lit) == VALUE_UNDEF) {
+			vector_push(lits, lit);
+		} else if (value(self, lit) == VALUE_TRUE && bound-- == 0) {
+			self->_ok = false;
+			return;
+		}
 	}
 
-	/* otherwise search for the solution */
-	size_t numflips = 0;
-	while (numflips < self->_maxflips) {
-		/* flip one literal */
-		cl_cnf_literal_t *literal = choose_literal(self, cnf);
-		cl_cnf_literal_assign(literal, !cl_cnf_literal_value(literal));
-		numflips++;
+	if (lits->size <= bound) {
+		return;
+	}
 
-		/* return the solution if found */
-		if (cl_cnf_evaluate(cnf)) {
-			return cl_cnf_literals(cnf);
+	if (bound == 0) {
+		for (size_t j = 0; j < lits->size; j++) {
+			enqueue(self, lits->data[j] ^ 1, NIL);
 		}
+		self->_ok = propagate(self) == NIL;
+		return;
+	}
+
+	uint32_t c = self->_card_starts.size;
+	assert(c < (ROOT_CONFLICT & ~REASON_CARD));
+	vector_push(&self->_card_starts, self->_cards.size);
+	vector_push(&self->_card_counts, 0);
+	vector_push(&self->_cards, bound);
+	vector_push(&self->_cards, lits->size);
+	for (size_t j = 0; j < lits->size; j++) {
+		vector_push(&self->_cards, lits->data[j]);
+		vector_push(&self->_card_occs[lits->data[j]], c);
+	}
+}
+
+static void row_swap(uint64_t * a, uint64_t * b, size_t words)
+{
+	for (size_t k = 0; k < words; k++) {
+		uint64_t word = a[k];
+		a[k] = b[k];
+		b[k] = word;
+	}
+}
+
+static void row_add(uint64_t * a, const uint64_t * b, size_t words)
+{
+	for (size_t k = 0; k < words; k++) {
+		a[k] ^= b[k];
 	}
+}
+
+/* Gauss-Jordan elimination of the rows of the matrix, pivoting on the
+ * columns for which pivotal is true, or on all of them for NULL.
+ * Returns the rank, the rows past it have no pivotal column left. */
+static size_t eliminate(cl_sat_t * self, uint64_t * m, size_t rows,
+			const bool *pivotal)
+{
+	size_t words = self->_words, rank = 0;
 
-	return NULL;
+	for (size_t col = 0; col < self->_columns.size && rank < rows; col++) {
+		if (pivotal && !pivotal[col]) {
+			continue;
+		}
+
+		size_t w = col / 64;
+		uint64_t bit = (uint64_t) 1 << (col % 64);
+		size_t pivot = rank;
+		while (pivot < rows && !(m[pivot * words + w] & bit)) {
+			pivot++;
+		}
+
+		if (pivot == rows) {
+			continue;
+		}
+
+		uint64_t *row = m + rank * words;
+		row_swap(row, m + pivot * words, words);
+		for (size_t r = 0; r < rows; r++) {
+			if (r != rank && (m[r * words + w] & bit)) {
+				row_add(m + r * words, row, words);
+			}
+		}
+		rank++;
+	}
+
+	return rank;
+}
+
+/* Packs the XOR constraints into the matrix, reduced once up front,
+ * so that the dependent rows are dropped and an inconsistency is found early. */
+static void build_matrix(cl_sat_t * self)
+{
+	size_t ncols = self->_columns.size, rows = 0;
+	size_t words = self->_words = ncols / 64 + 1;
+
+	for (size_t i = 0; i < self->_xors.size; i += 2 + self->_xors.data[i]) {
+		rows++;
+	}
+
+	free(self->_matrix);
+	free(self->_work);
+	self->_matrix = calloc(rows * words, sizeof(uint64_t));
+	self->_work = malloc(rows * words * sizeof(uint64_t));
+	self->_pivotal = realloc(self->_pivotal, (ncols + 1) * sizeof(bool));
+	assert(!rows || (self->_matrix && self->_work));
+	assert(self->_pivotal);
+
+	uint64_t *row = self->_matrix;
+	for (size_t i = 0; i < self->_xors.size; row += words) {
+		uint32_t size = self->_xors.data[i];
+		uint32_t parity = self->_xors.data[i + 1];
+		uint32_t *vars = self->_xors.data + i + 2;
+
+		row[ncols / 64] |= (uint64_t) parity << (ncols % 64);
+		for (uint32_t j = 0; j < size; j++) {
+			uint32_t col = self->_column_of[vars[j]];
+			row[col / 64] ^= (uint64_t) 1 << (col % 64);
+		}
+		i += 2 + size;
+	}
+
+	size_t rank = eliminate(self, self->_matrix, rows, NULL);
+	for (size_t r = rank; r < rows; r++) {
+		/* 0 = 1 */
+		if (self->_matrix[r * words + ncols / 64]) {
+			self->_ok = false;
+		}
+	}
+
+	self->_rows = rank;
+	self->_xors_dirty = false;
+}
+
+/* Starts over with the formula, keeping only the phases. */
+static void reset(cl_sat_t * self, cl_cnf_t * cnf)
+{
+	cl_collection_t *literals = self->_literals;
+	cl_sat_index_t index = self->_index;
+	uint8_t *phases = self->_phases;
+	uint8_t *best = self->_best;
+
+	self->_literals = NULL;
+	self->_phases = self->_best = NULL;
+	memset(&self->_index, 0, sizeof(cl_sat_index_t));
+	unload(self);
+
+	self->_cnf = cl_object_retain(cnf);
+	self->_loaded = cl_collection_new(0, CL_OBJECT_TYPE_COLLECTION,
+					  CL_COLLECTION_FLAG_UNIQUE |
+					  CL_COLLECTION_FLAG_AUTORESIZE);
+	self->_literals = cl_collection_new(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					    CL_COLLECTION_FLAG_AUTORESIZE);
+	self->_var_inc = 1.0;
+	self->_next_rephase = self->_rephase_interval;
+	self->_next_reduce = self->_reduce_interval;
+
+	cl_collection_t *used = cl_cnf_literals(cnf);
+	for (size_t i = 0; i < cl_collection_count(used); i++) {
+		cl_cnf_literal_t *lit = cl_collection_get(used, i);
+		uint32_t var = variable(self, lit);
+		uint32_t old = index_find(&index, lit);
+
+		if (old != NIL) {
+			self->_phases[var] = phases[old];
+			self->_best[var] = best[old];
+		}
+	}
+
+	free(index.keys);
+	free(index.vars);
+	free(phases);
+	free(best);
+	cl_object_release(literals);
+}
+
+static void backjump(cl_sat_t * self, size_t level);
+
+/* Brings the solver up to date with the formula.
+ * The clauses added since the last call are translated,
+ * while removing any clause makes the solver start over. */
+static void sync(cl_sat_t * self, cl_cnf_t * cnf)
+{
+	cl_cnf_compact(cnf);
+	cl_collection_t *set = cnf->_set;
+
+	/* the set is only looked through if it changed since the last call */
+	bool removed = self->_cnf != cnf || self->_synced != set
+	    || self->_synced_removals != cnf->_removals;
+	bool added = removed || self->_synced_added != cnf->_added;
+
+	bool reload = self->_cnf != cnf;
+	if (!reload && removed) {
+		size_t known = 0;
+		for (size_t i = 0; i < cl_collection_count(set); i++) {
+			known += cl_collection_find(self->_loaded, 0,
+						    cl_collection_get(set, i))
+			    != SIZE_MAX;
+		}
+		reload = known < cl_collection_count(self->_loaded);
+	}
+
+	if (reload || cl_collection_count(cnf->_xors) < self->_xors_loaded
+	    || cl_collection_count(cnf->_cards) < self->_cards_loaded) {
+		reset(self, cnf);
+		added = true;
+	}
+
+	backjump(self, 0);
+	for (size_t i = 0; added && i < cl_collection_count(set); i++) {
+		cl_collection_t *clause = cl_collection_get(set, i);
+		if (cl_collection_find(self->_loaded, 0, clause) != SIZE_MAX) {
+			continue;
+		}
+
+		cl_collection_add(self->_loaded, clause);
+		if (self->_ok) {
+			add(self, clause);
+		}
+	}
+
+	cl_object_retain(set);
+	cl_object_release(self->_synced);
+	self->_synced = set;
+	self->_synced_added = cnf->_added;
+	self->_synced_removals = cnf->_removals;
+
+	cl_collection_t *xors = cnf->_xors;
+	for (; self->_xors_loaded < cl_collection_count(xors);
+	     self->_xors_loaded++) {
+		add_xor(self, cl_collection_get(xors, self->_xors_loaded));
+	}
+
+	if (self->_xors_dirty && self->_ok) {
+		build_matrix(self);
+	}
+
+	cl_collection_t *cards = cnf->_cards;
+	for (; self->_cards_loaded < cl_collection_count(cards);
+	     self->_cards_loaded++) {
+		if (self->_ok) {
+			add_card(self,
+				 cl_collection_get(cards, self->_cards_loaded),
+				 cnf->_bounds[self->_cards_loaded]);
+		}
+	}
+}
+
+/* --- search -------------------------------------------------------------- */
+
+static uint32_t propagate(cl_sat_t * self)
+{
+	uint32_t conflict = NIL;
+
+	while (self->_qhead < self->_trail_size) {
+		uint32_t false_lit = self->_trail[self->_qhead++] ^ 1;
+		self->_propagations++;
+		cl_sat_watches_t *ws = &self->_watches[false_lit];
+		size_t i = 0, j = 0;
+
+		while (i < ws->size) {
+			cl_sat_watch_t w = ws->data[i++];
+
+			if (value(self, w.blocker) == VALUE_TRUE) {
+				ws->data[j++] = w;
+				continue;
+			}
+
+			/* make sure the false literal is the second one */
+			uint32_t size = self->_arena[w.cref];
+			uint32_t *lits = self->_arena + w.cref + CLAUSE_HEADER;
+			if (lits[0] == false_lit) {
+				lits[0] = lits[1];
+				lits[1] = false_lit;
+			}
+
+			uint32_t first = lits[0];
+			w.blocker = first;
+			if (value(self, first) == VALUE_TRUE) {
+				ws->data[j++] = w;
+				continue;
+			}
+
+			/* look for a new literal to watch */
+			bool found = false;
+			for (uint32_t k = 2; k < size; k++) {
+				if (value(self, lits[k]) != VALUE_FALSE) {
+					lits[1] = lits[k];
+					lits[k] = false_lit;
+					watch(self, lits[1], w.cref, first);
+					found = true;
+					break;
+				}
+			}
+
+			if (found) {
+				continue;
+			}
+
+			/* the clause is unit or conflicting */
+			ws->data[j++] = w;
+			if (value(self, first) == VALUE_FALSE) {
+				conflict = w.cref;
+				self->_qhead = self->_trail_size;
+				while (i < ws->size) {
+					ws->data[j++] = ws->data[i++];
+				}
+			} else {
+				enqueue(self, first, w.cref);
+			}
+		}
+
+		ws->size = j;
+	}
+
+	return conflict;
+}
+
+/* Returns the literals of a reason or a conflict, the first being the
+ * implied literal, if any.
+ * A cardinality constraint is read as the clause over its true literals,
+ * written out in _explanation: the implied literal follows from them,
+ * or they are one too many. */
+static uint32_t *antecedent(cl_sat_t * self, uint32_t reason, uint32_t lit,
+			   uint32_t * size)
+{
+	if (!(reason & REASON_CARD)) {
+		*size = self->_arena[reason];
+		return self->_arena + reason + CLAUSE_HEADER;
+	}
+
+	uint32_t *card = self->_cards.data
+	    + self->_card_starts.data[reason & ~REASON_CARD];
+	cl_sat_vector_t *clause = &self->_explanation;
+
+	clause->size = 0;
+	if (lit != NIL) {
+		vector_push(clause, lit);
+	}
+	for (uint32_t k = 0; k < card[1]; k++) {
+		if (value(self, card[2 + k]) == VALUE_TRUE) {
+			vector_push(clause, card[2 + k] ^ 1);
+		}
+	}
+
+	*size = clause->size;
+	return clause->data;
+}
+
+static bool redundant(cl_sat_t * self, uint32_t lit)
+{
+	uint32_t reason = self->_reasons[lit >> 1];
+	if (reason == NIL) {
+		return false;
+	}
+
+	uint32_t size;
+	uint32_t *lits = antecedent(self, reason, lit ^ 1, &size);
+	for (uint32_t k = 1; k < size; k++) {
+		uint32_t var = lits[k] >> 1;
+		if (!self->_seen[var] && self->_levels[var] > 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Literal block distance: the number of decision levels among the literals. */
+static uint32_t lbd(cl_sat_t * self, uint32_t * lits, size_t size)
+{
+	if (++self->_stamp == 0) {
+		memset(self->_stamps, 0,
+		       self->_level_capacity * sizeof(uint32_t));
+		self->_stamp = 1;
+	}
+
+	uint32_t res = 0;
+	for (size_t k = 0; k < size; k++) {
+		uint32_t level = self->_levels[lits[k] >> 1];
+		if (self->_stamps[level] != self->_stamp) {
+			self->_stamps[level] = self->_stamp;
+			res++;
+		}
+	}
+
+	return res;
+}
+
+/* Moves the literal of the highest level among lits[from ..] to lits[from]. */
+static void highest_first(cl_sat_t * self, uint32_t * lits, size_t size,
+			  size_t from)
+{
+	size_t max = from;
+	for (size_t k = from + 1; k < size; k++) {
+		if (self->_levels[lits[k] >> 1] > self->_levels[lits[max] >> 1]) {
+			max = k;
+		}
+	}
+
+	uint32_t lit = lits[max];
+	lits[max] = lits[from];
+	lits[from] = lit;
+}
+
+/* Returns the index of the lowest set bit of the nonzero word,
+ * looking the isolated bit up by its de Bruijn product. */
+static size_t lowest_bit(uint64_t bits)
+{
+	static const uint8_t table[64] = {
+		0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+		62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+	};
+
+	assert(bits);
+	return table[((bits & -bits) * 0x03f79d71b4cb0a89ull) >> 58];
+}
+
+/* Gauss-Jordan elimination of the XOR constraints under the current
+ * assignment, pivoting on the unassigned variables only.
+ * A row left with a single unassigned variable implies its value,
+ * and a row left with none may be in conflict. The rows remain sums
+ * of the original constraints, so the assigned variables of such a row
+ * explain the implication or the conflict, and the explanation is added
+ * as a learnt clause. Returns the conflicting clause, or NIL. */
+static uint32_t gauss(cl_sat_t * self)
+{
+	size_t rows = self->_rows, words = self->_words;
+	size_t ncols = self->_columns.size;
+	uint64_t *m = self->_work;
+	cl_sat_vector_t *lits = &self->_learnt;
+
+	memcpy(m, self->_matrix, rows * words * sizeof(uint64_t));
+	for (size_t col = 0; col < ncols; col++) {
+		self->_pivotal[col] =
+		    self->_assigns[self->_columns.data[col]] == VALUE_UNDEF;
+	}
+	eliminate(self, m, rows, self->_pivotal);
+
+	for (size_t r = 0; r < rows; r++) {
+		uint64_t *row = m + r * words;
+		uint32_t parity = row[ncols / 64] >> (ncols % 64) & 1;
+		uint32_t unit = NIL;
+		size_t undef = 0;
+
+		/* the variable the row implies is the first literal */
+		lits->size = 0;
+		vector_push(lits, NIL);
+		for (size_t w = 0; w < words && undef < 2; w++) {
+			uint64_t bits = row[w];
+			if (w == ncols / 64) {
+				bits &= ((uint64_t) 1 << (ncols % 64)) - 1;
+			}
+
+			for (; bits && undef < 2; bits &= bits - 1) {
+				size_t col = 64 * w + lowest_bit(bits);
+				uint32_t var = self->_columns.data[col];
+				if (self->_assigns[var] == VALUE_UNDEF) {
+					unit = var;
+					undef++;
+				} else {
+					parity ^= self->_assigns[var];
+					vector_push(lits, 2 * var
+						    + self->_assigns[var]);
+				}
+			}
+		}
+
+		if (undef > 1 || (undef == 0 && parity == 0)) {
+			continue;
+		}
+
+		if (self->_decision_level == 0) {
+			if (undef == 0) {
+				return ROOT_CONFLICT;
+			}
+
+			enqueue(self, 2 * unit + !parity, NIL);
+			continue;
+		}
+
+		/* the literals of the highest levels get watched */
+		uint32_t *data = lits->data;
+		size_t size = lits->size;
+		if (undef == 0) {
+			data++;
+			size--;
+			highest_first(self, data, size, 0);
+		} else {
+			data[0] = 2 * unit + !parity;
+		}
+		assert(size >= 2);
+		highest_first(self, data, size, 1);
+
+		uint32_t cref = clause_new(self, data, size, CLAUSE_LEARNT,
+					   lbd(self, data, size));
+		vector_push(&self->_learnts, cref);
+
+		if (undef == 0) {
+			return cref;
+		}
+		enqueue(self, data[0], cref);
+	}
+
+	return NIL;
+}
+
+/* Counts the true literals of the cardinality constraints along the trail.
+ * A constraint reaching its bound makes the rest of its literals false,
+ * and a constraint going over its bound is in conflict.
+ * Returns the conflict, or NIL. */
+static uint32_t propagate_cards(cl_sat_t * self)
+{
+	uint32_t conflict = NIL;
+
+	if (!self->_card_starts.size) {
+		self->_card_head = self->_trail_size;
+		return NIL;
+	}
+
+	while (conflict == NIL && self->_card_head < self->_trail_size) {
+		uint32_t lit = self->_trail[self->_card_head++];
+		cl_sat_vector_t *occs = &self->_card_occs[lit];
+
+		/* all the constraints are counted, even after a conflict */
+		for (size_t i = 0; i < occs->size; i++) {
+			uint32_t c = occs->data[i];
+			uint32_t count = ++self->_card_counts.data[c];
+			uint32_t *card = self->_cards.data
+			    + self->_card_starts.data[c];
+			uint32_t *lits = card + 2;
+
+			if (conflict != NIL || count < card[0]) {
+				continue;
+			}
+
+			if (count == card[0]) {
+				for (uint32_t k = 0; k < card[1]; k++) {
+					if (value(self, lits[k]) == VALUE_UNDEF) {
+						enqueue(self, lits[k] ^ 1,
+							self->_decision_level ?
+							REASON_CARD | c : NIL);
+					}
+				}
+				continue;
+			}
+
+			conflict = self->_decision_level ?
+			    REASON_CARD | c : ROOT_CONFLICT;
+		}
+	}
+
+	return conflict;
+}
+
+/* Unit propagation to a fixpoint of the clauses,
+ * the cardinality and the XOR constraints. */
+static uint32_t propagate_all(cl_sat_t * self)
+{
+	for (;;) {
+		uint32_t conflict = propagate(self);
+		if (conflict != NIL) {
+			return conflict;
+		}
+
+		size_t trail = self->_trail_size;
+		conflict = propagate_cards(self);
+		if (conflict != NIL) {
+			return conflict;
+		}
+
+		if (self->_trail_size != trail) {
+			continue;
+		}
+
+		if (!self->_rows) {
+			return NIL;
+		}
+
+		conflict = gauss(self);
+		if (conflict != NIL || self->_trail_size == trail) {
+			return conflict;
+		}
+	}
+}
+
+/* Marks a learnt clause taking part in a conflict as used,
+ * for two reductions in tier2 and for one in the local tier. */
+static void use(cl_sat_t * self, uint32_t cref)
+{
+	uint32_t *header = self->_arena + cref;
+	if (!(header[1] & CLAUSE_LEARNT) || header[2] <= self->_tier1_lbd) {
+		return;
+	}
+
+	uint32_t glue = lbd(self, header + CLAUSE_HEADER, header[0]);
+	if (glue < header[2]) {
+		header[2] = glue;
+	}
+
+	uint32_t used = header[2] <= self->_tier2_lbd ? 2 : 1;
+	header[1] = (header[1] & ((1 << CLAUSE_USED_SHIFT) - 1))
+	    | used << CLAUSE_USED_SHIFT;
+}
+
+/* First UIP conflict analysis.
+ * Leaves the learnt clause in _learnt, with the asserting literal first
+ * and a literal of the backjump level second,
+ * and returns the level to backjump to. */
+static size_t analyze(cl_sat_t * self, uint32_t conflict)
+{
+	cl_sat_vector_t *learnt = &self->_learnt;
+	size_t pending = 0;
+	uint32_t p = NIL;
+	size_t index = self->_trail_size;
+
+	learnt->size = 0;
+	vector_push(learnt, NIL);
+
+	do {
+		if (p != NIL) {
+			conflict = self->_reasons[p >> 1];
+		}
+
+		assert(conflict != NIL);
+		if (!(conflict & REASON_CARD)) {
+			use(self, conflict);
+		}
+
+		uint32_t size;
+		uint32_t *lits = antecedent(self, conflict, p, &size);
+
+		for (uint32_t k = (p == NIL ? 0 : 1); k < size; k++) {
+			uint32_t var = lits[k] >> 1;
+			if (self->_seen[var] || self->_levels[var] == 0) {
+				continue;
+			}
+
+			bump(self, var);
+			self->_seen[var] = 1;
+			if (self->_levels[var] >= self->_decision_level) {
+				pending++;
+			} else {
+				vector_push(learnt, lits[k]);
+			}
+		}
+
+		/* next literal of the current level to look at */
+		while (!self->_seen[self->_trail[--index] >> 1]) ;
+		p = self->_trail[index];
+		self->_seen[p >> 1] = 0;
+	} while (--pending > 0);
+
+	learnt->data[0] = p ^ 1;
+
+	/* move the literals implied by the others past the end */
+	size_t size = 1;
+	for (size_t k = 1; k < learnt->size; k++) {
+		uint32_t lit = learnt->data[k];
+		if (!redundant(self, lit)) {
+			learnt->data[k] = learnt->data[size];
+			learnt->data[size++] = lit;
+		}
+	}
+
+	for (size_t k = 1; k < learnt->size; k++) {
+		self->_seen[learnt->data[k] >> 1] = 0;
+	}
+	learnt->size = size;
+
+	/* find the backjump level */
+	if (size == 1) {
+		return 0;
+	}
+
+	size_t max = 1;
+	for (size_t k = 2; k < size; k++) {
+		if (self->_levels[learnt->data[k] >> 1] >
+		    self->_levels[learnt->data[max] >> 1]) {
+			max = k;
+		}
+	}
+
+	uint32_t lit = learnt->data[max];
+	learnt->data[max] = learnt->data[1];
+	learnt->data[1] = lit;
+
+	return self->_levels[lit >> 1];
+}
+
+/* Collects the assumptions responsible for the assumption p being false,
+ * p included, in _learnt. */
+static void analyze_final(cl_sat_t * self, uint32_t p)
+{
+	cl_sat_vector_t *failed = &self->_learnt;
+	failed->size = 0;
+	vector_push(failed, p);
+
+	if (self->_decision_level == 0) {
+		return;
+	}
+
+	self->_seen[p >> 1] = 1;
+	for (size_t i = self->_trail_size; i > self->_trail_lim[0]; i--) {
+		uint32_t lit = self->_trail[i - 1];
+		uint32_t var = lit >> 1;
+		if (!self->_seen[var]) {
+			continue;
+		}
+
+		uint32_t reason = self->_reasons[var];
+		if (reason == NIL) {
+			/* all the decisions up to here are assumptions */
+			vector_push(failed, lit);
+		} else {
+			uint32_t size;
+			uint32_t *lits = antecedent(self, reason, lit, &size);
+			for (uint32_t k = 1; k < size; k++) {
+				if (self->_levels[lits[k] >> 1] > 0) {
+					self->_seen[lits[k] >> 1] = 1;
+				}
+			}
+		}
+
+		self->_seen[var] = 0;
+	}
+
+	self->_seen[p >> 1] = 0;
+}
+
+/* Remembers the assignment if it is the largest seen so far. */
+static void remember(cl_sat_t * self, uint8_t * phases, size_t * size)
+{
+	if (self->_trail_size <= *size) {
+		return;
+	}
+
+	for (size_t i = 0; i < self->_trail_size; i++) {
+		uint32_t var = self->_trail[i] >> 1;
+		phases[var] = self->_assigns[var];
+	}
+
+	*size = self->_trail_size;
+}
+
+static void backjump(cl_sat_t * self, size_t level)
+{
+	if (self->_decision_level <= level) {
+		return;
+	}
+
+	remember(self, self->_target, &self->_target_size);
+	remember(self, self->_best, &self->_best_size);
+
+	for (size_t i = self->_trail_size; i > self->_trail_lim[level]; i--) {
+		uint32_t var = self->_trail[i - 1] >> 1;
+
+		/* uncount the literals counted by the cardinality constraints */
+		if (i <= self->_card_head) {
+			cl_sat_vector_t *occs = &self->_card_occs[self->_trail[i - 1]];
+			for (size_t k = 0; k < occs->size; k++) {
+				self->_card_counts.data[occs->data[k]]--;
+			}
+		}
+
+		self->_phases[var] = self->_assigns[var];
+		self->_assigns[var] = VALUE_UNDEF;
+		self->_reasons[var] = NIL;
+		heap_insert(self, var);
+	}
+
+	self->_trail_size = self->_qhead = self->_trail_lim[level];
+	if (self->_card_head > self->_trail_size) {
+		self->_card_head = self->_trail_size;
+	}
+	self->_decision_level = level;
+}
+
+static uint32_t pick_random(cl_sat_t * self)
+{
+	size_t start = random_below(self, self->_nvars);
+
+	for (size_t i = 0; i < self->_nvars; i++) {
+		uint32_t var = (start + i) % self->_nvars;
+		if (self->_assigns[var] == VALUE_UNDEF) {
+			return var;
+		}
+	}
+
+	return NIL;
+}
+
+static uint32_t pick_branch(cl_sat_t * self)
+{
+	if (self->_trail_size == self->_nvars) {
+		return NIL;
+	}
+
+	if (self->_heuristic == CL_SAT_HEURISTIC_RANDOM) {
+		return pick_random(self);
+	}
+
+	/* assigned variables are removed lazily */
+	while (self->_heap_size > 0) {
+		uint32_t var = heap_pop(self);
+		if (self->_assigns[var] == VALUE_UNDEF) {
+			return var;
+		}
+	}
+
+	return NIL;
+}
+
+/* --- budgets ------------------------------------------------------------- */
+
+/* Microseconds of a monotonic clock. */
+static size_t now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (size_t) ts.tv_sec * 1000000 + (size_t) ts.tv_nsec / 1000;
+}
+
+/* Bytes held by the solver, the literal objects aside. */
+static size_t memory(cl_sat_t * self)
+{
+	size_t res = sizeof(cl_sat_t);
+
+	/* the arrays indexed by variables, literals and levels */
+	res += self->_var_capacity * (5 * sizeof(uint8_t)
+				      + 6 * sizeof(uint32_t) + sizeof(double)
+				      + 2 * sizeof(cl_sat_watches_t)
+				      + 2 * sizeof(cl_sat_vector_t)
+				      + 4 * (sizeof(void *) + sizeof(uint32_t)));
+	res += self->_level_capacity * 2 * sizeof(uint32_t);
+
+	for (size_t i = 0; i < 2 * self->_nvars; i++) {
+		res += self->_watches[i].capacity * sizeof(cl_sat_watch_t);
+		res += self->_card_occs[i].capacity * sizeof(uint32_t);
+	}
+
+	/* the clauses and the constraints */
+	cl_sat_vector_t *vectors[] = {
+		&self->_clauses, &self->_learnts, &self->_learnt,
+		&self->_assumptions, &self->_xors, &self->_columns,
+		&self->_cards, &self->_card_starts, &self->_card_counts,
+		&self->_explanation
+	};
+	for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		res += vectors[i]->capacity * sizeof(uint32_t);
+	}
+
+	res += self->_arena_capacity * sizeof(uint32_t);
+	res += 2 * self->_rows * self->_words * sizeof(uint64_t);
+
+	return res;
+}
+
+#ifndef CL_SAT_NO_STATISTICS
+/* Keeps the largest memory held seen so far. */
+static void peak(cl_sat_t * self)
+{
+	size_t bytes = memory(self);
+	if (bytes > self->_stats.peak_memory) {
+		self->_stats.peak_memory = bytes;
+	}
+}
+#endif
+
+/* Starts counting the budgets of a call. */
+static void start(cl_sat_t * self)
+{
+	self->_exhausted = CL_SAT_BUDGET_NONE;
+	self->_started = now();
+	self->_ticks = 0;
+	self->_next_progress = self->_progress_period;
+
+	self->_start.conflicts = self->_conflicts;
+	self->_start.decisions = self->_decisions;
+	self->_start.propagations = self->_propagations;
+	self->_start.restarts = self->_restarts;
+}
+
+/* Checks the time and the memory held, and reports the progress when due.
+ * Returns the budget which ran out, or NONE. */
+static cl_sat_budget_t checkpoint(cl_sat_t * self)
+{
+	size_t *limits = self->_limits;
+	size_t elapsed = (now() - self->_started) / 1000;
+
+	if (limits[CL_SAT_BUDGET_TIME] && elapsed >= limits[CL_SAT_BUDGET_TIME]) {
+		return CL_SAT_BUDGET_TIME;
+	}
+
+	if (limits[CL_SAT_BUDGET_MEMORY]
+	    && self->_ticks % (BUDGET_CHECK_INTERVAL * MEMORY_CHECK_INTERVAL) == 0
+	    && memory(self) >= limits[CL_SAT_BUDGET_MEMORY]) {
+		return CL_SAT_BUDGET_MEMORY;
+	}
+
+	if (!self->_progress || elapsed < self->_next_progress) {
+		return CL_SAT_BUDGET_NONE;
+	}
+
+	cl_sat_progress_t progress = {
+		elapsed,
+		self->_conflicts - self->_start.conflicts,
+		self->_decisions - self->_start.decisions,
+		self->_propagations - self->_start.propagations,
+		self->_restarts - self->_start.restarts,
+		self->_learnts.size,
+		memory(self)
+	};
+	self->_next_progress = elapsed + self->_progress_period;
+
+	return self->_progress(self, &progress, self->_progress_data) ?
+	    CL_SAT_BUDGET_NONE : CL_SAT_BUDGET_INTERRUPT;
+}
+
+/* Checks the interrupt flag and the counters,
+ * and every BUDGET_CHECK_INTERVAL calls the rest of the budgets.
+ * Returns true if the call is to be stopped, with the budget in _exhausted. */
+static bool exhausted(cl_sat_t * self)
+{
+	size_t *limits = self->_limits;
+	cl_sat_budget_t res = CL_SAT_BUDGET_NONE;
+
+	if (self->_interrupted
+	    || (self->_parent && self->_parent->_interrupted)) {
+		res = CL_SAT_BUDGET_INTERRUPT;
+	} else if (limits[CL_SAT_BUDGET_CONFLICTS]
+		   && self->_conflicts - self->_start.conflicts >=
+		   limits[CL_SAT_BUDGET_CONFLICTS]) {
+		res = CL_SAT_BUDGET_CONFLICTS;
+	} else if (limits[CL_SAT_BUDGET_PROPAGATIONS]
+		   && self->_propagations - self->_start.propagations >=
+		   limits[CL_SAT_BUDGET_PROPAGATIONS]) {
+		res = CL_SAT_BUDGET_PROPAGATIONS;
+	} else if (++self->_ticks % BUDGET_CHECK_INTERVAL == 0) {
+		res = checkpoint(self);
+	}
+
+	self->_exhausted = res;
+	return res != CL_SAT_BUDGET_NONE;
+}
+
+/* --- restarts and clause database reduction ----------------------------- */
+
+/* The Luby sequence 1, 1, 2, 1, 1, 2, 4, ... for a 0 based index. */
+static size_t luby(size_t index)
+{
+	size_t size = 1, exponent = 0;
+
+	while (size < index + 1) {
+		exponent++;
+		size = 2 * size + 1;
+	}
+
+	while (size - 1 != index) {
+		size = (size - 1) / 2;
+		exponent--;
+		index = index % size;
+	}
+
+	return (size_t) 1 << exponent;
+}
+
+static bool restart_due(cl_sat_t * self, uint32_t glue)
+{
+	self->_since_restart++;
+	self->_lbd_sum += glue;
+	self->_lbd_fast += GLUCOSE_FAST_ALPHA * (glue - self->_lbd_fast);
+
+	switch (self->_restart) {
+	case CL_SAT_RESTART_LUBY:
+		return self->_since_restart >=
+		    luby(self->_restarts) * self->_luby_unit;
+	case CL_SAT_RESTART_GLUCOSE:
+		return self->_since_restart >= GLUCOSE_MIN_CONFLICTS
+		    && self->_lbd_fast > self->_restart_margin
+		    * self->_lbd_sum / self->_conflicts;
+	default:
+		return false;
+	}
+}
+
+static void restart(cl_sat_t * self)
+{
+	backjump(self, 0);
+	self->_since_restart = 0;
+	self->_restarts++;
+}
+
+/* Copies the live clauses of the vector into the current arena,
+ * leaving the new reference behind in the old one. */
+static void relocate(cl_sat_t * self, uint32_t * old, cl_sat_vector_t * vector)
+{
+	size_t j = 0;
+
+	for (size_t i = 0; i < vector->size; i++) {
+		uint32_t *header = old + vector->data[i];
+		if (header[1] & CLAUSE_DELETED) {
+			continue;
+		}
+
+		uint32_t cref = clause_new(self, header + CLAUSE_HEADER,
+					   header[0], header[1], header[2]);
+		header[1] |= CLAUSE_MOVED;
+		header[2] = cref;
+		vector->data[j++] = cref;
+	}
+
+	vector->size = j;
+}
+
+/* Compacts the arena, dropping the deleted clauses,
+ * and rebuilds the watchers. */
+static void collect(cl_sat_t * self)
+{
+	uint32_t *old = self->_arena;
+
+	self->_arena = NULL;
+	self->_arena_size = self->_arena_capacity = 0;
+	for (size_t i = 0; i < 2 * self->_nvars; i++) {
+		self->_watches[i].size = 0;
+	}
+
+	relocate(self, old, &self->_clauses);
+	relocate(self, old, &self->_learnts);
+
+	for (size_t i = 0; i < self->_trail_size; i++) {
+		uint32_t var = self->_trail[i] >> 1;
+		uint32_t reason = self->_reasons[var];
+		if (reason != NIL && !(reason & REASON_CARD)) {
+			assert(old[reason + 1] & CLAUSE_MOVED);
+			self->_reasons[var] = old[reason + 2];
+		}
+	}
+
+	free(old);
+}
+
+static bool locked(cl_sat_t * self, uint32_t cref)
+{
+	uint32_t lit = self->_arena[cref + CLAUSE_HEADER];
+	return value(self, lit) == VALUE_TRUE
+	    && self->_reasons[lit >> 1] == cref;
+}
+
+static int candidate_comparator(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x < y) - (x > y);
+}
+
+/* Deletes the worse half of the learnt clauses which are neither in the
+ * core tier, nor used since the last reduction, nor reasons for an assignment. */
+static void reduce(cl_sat_t * self)
+{
+	cl_sat_vector_t *learnts = &self->_learnts;
+	uint64_t *candidates = malloc(learnts->size * sizeof(uint64_t));
+	size_t count = 0;
+	assert(candidates || !learnts->size);
+
+	for (size_t i = 0; i < learnts->size; i++) {
+		uint32_t cref = learnts->data[i];
+		uint32_t *header = self->_arena + cref;
+		uint32_t used = header[1] >> CLAUSE_USED_SHIFT;
+
+		if (used) {
+			header[1] -= 1 << CLAUSE_USED_SHIFT;
+			continue;
+		}
+
+		if (header[2] > self->_tier1_lbd && !locked(self, cref)) {
+			candidates[count++] = (uint64_t) header[2] << 32 | cref;
+		}
+	}
+
+	/* the highest LBD first */
+	qsort(candidates, count, sizeof(uint64_t), &candidate_comparator);
+	for (size_t i = 0; i < count / 2; i++) {
+		self->_arena[(uint32_t) candidates[i] + 1] |= CLAUSE_DELETED;
+	}
+
+	/* the database is the largest right before a reduction */
+	STAT(peak(self));
+	STAT(self->_stats.deleted += count / 2);
+
+	free(candidates);
+	collect(self);
+
+	self->_reductions++;
+	self->_next_reduce = self->_conflicts + self->_reduce_interval
+	    + REDUCE_INCREMENT * self->_reductions;
+}
+
+/* --- local search -------------------------------------------------------- */
+
+static bool walk_true(uint8_t * values, uint32_t lit)
+{
+	return values[lit >> 1] ^ (lit & 1);
+}
+
+static void walk_unsat(cl_sat_vector_t * unsat, uint32_t * where, uint32_t c)
+{
+	where[c] = unsat->size;
+	vector_push(unsat, c);
+}
+
+static void walk_sat(cl_sat_vector_t * unsat, uint32_t * where, uint32_t c)
+{
+	uint32_t last = unsat->data[--unsat->size];
+	unsat->data[where[c]] = last;
+	where[last] = where[c];
+	where[c] = NIL;
+}
+
+/* WalkSAT style local search over the original clauses,
+ * starting from the saved phases and keeping the root level fixed.
+ * The phases are overwritten by the assignment with the fewest unsatisfied clauses.
+ * Returns true if that assignment satisfies the formula. */
+static bool walk(cl_sat_t * self, size_t maxflips)
+{
+	size_t n = self->_nvars;
+	cl_sat_vector_t *clauses = &self->_clauses;
+
+	uint8_t *values = malloc(n * sizeof(uint8_t));
+	bool *fixed = malloc(n * sizeof(bool));
+	uint32_t *counts = malloc(clauses->size * sizeof(uint32_t));
+	uint32_t *where = malloc(clauses->size * sizeof(uint32_t));
+	cl_sat_vector_t *occs = calloc(2 * n, sizeof(cl_sat_vector_t));
+	cl_sat_vector_t unsat = { NULL, 0, 0 };
+	assert(values && fixed && occs && (!clauses->size || (counts && where)));
+
+	for (size_t v = 0; v < n; v++) {
+		fixed[v] = self->_assigns[v] != VALUE_UNDEF
+		    && self->_levels[v] == 0;
+		values[v] = fixed[v] ? self->_assigns[v] : self->_phases[v];
+	}
+
+	for (uint32_t c = 0; c < clauses->size; c++) {
+		uint32_t cref = clauses->data[c];
+		uint32_t *lits = self->_arena + cref + CLAUSE_HEADER;
+
+		counts[c] = 0;
+		where[c] = NIL;
+		for (uint32_t k = 0; k < self->_arena[cref]; k++) {
+			counts[c] += walk_true(values, lits[k]);
+			if (!fixed[lits[k] >> 1]) {
+				vector_push(&occs[lits[k]], c);
+			}
+		}
+
+		if (!counts[c]) {
+			walk_unsat(&unsat, where, c);
+		}
+	}
+
+	size_t best = unsat.size;
+	if (n) {
+		memcpy(self->_phases, values, n * sizeof(uint8_t));
+	}
+
+	for (size_t flips = 0; flips < maxflips && unsat.size
+	     && !exhausted(self); flips++) {
+		STAT(self->_stats.flips++);
+		uint32_t c = unsat.data[random_below(self, unsat.size)];
+		uint32_t cref = clauses->data[c];
+		uint32_t size = self->_arena[cref];
+		uint32_t *lits = self->_arena + cref + CLAUSE_HEADER;
+
+		/* the literal breaking the fewest clauses, or a random one */
+		uint32_t pick = NIL;
+		size_t min = SIZE_MAX;
+		for (uint32_t k = 0; k < size && min; k++) {
+			if (fixed[lits[k] >> 1]) {
+				continue;
+			}
+
+			size_t breaks = 0;
+			cl_sat_vector_t *occ = &occs[lits[k] ^ 1];
+			for (size_t i = 0; i < occ->size; i++) {
+				breaks += counts[occ->data[i]] == 1;
+			}
+
+			if (breaks < min) {
+				min = breaks;
+				pick = lits[k];
+			}
+		}
+
+		assert(pick != NIL);
+		if (min && random_below(self, 100) < WALK_NOISE) {
+			do {
+				pick = lits[random_below(self, size)];
+			} while (fixed[pick >> 1]);
+		}
+
+		/* flip, making the picked literal true */
+		values[pick >> 1] ^= 1;
+		cl_sat_vector_t *occ = &occs[pick];
+		for (size_t i = 0; i < occ->size; i++) {
+			if (counts[occ->data[i]]++ == 0) {
+				walk_sat(&unsat, where, occ->data[i]);
+			}
+		}
+
+		occ = &occs[pick ^ 1];
+		for (size_t i = 0; i < occ->size; i++) {
+			if (--counts[occ->data[i]] == 0) {
+				walk_unsat(&unsat, where, occ->data[i]);
+			}
+		}
+
+		if (unsat.size < best) {
+			best = unsat.size;
+			memcpy(self->_phases, values, n * sizeof(uint8_t));
+		}
+	}
+
+	for (size_t i = 0; i < 2 * n; i++) {
+		free(occs[i].data);
+	}
+
+	free(occs);
+	free(unsat.data);
+	free(where);
+	free(counts);
+	free(fixed);
+	free(values);
+
+	return best == 0;
+}
+
+/* Replaces the saved phases, cycling through
+ * original, best, inverted, best, random, best, local search, best. */
+static void rephase(cl_sat_t * self)
+{
+	size_t n = self->_nvars;
+
+	switch (self->_rephases++ % 8) {
+	case 0:
+		memset(self->_phases, DEFAULT_PHASE, n * sizeof(uint8_t));
+		break;
+	case 2:
+		memset(self->_phases, !DEFAULT_PHASE, n * sizeof(uint8_t));
+		break;
+	case 4:
+		for (size_t v = 0; v < n; v++) {
+			self->_phases[v] = random_next(self) >> 63;
+		}
+		break;
+	case 6:
+		walk(self, self->_maxflips ? self->_maxflips :
+		     DEFAULT_WALK_FLIPS);
+		break;
+	default:
+		for (size_t v = 0; v < n; v++) {
+			if (self->_best[v] != VALUE_UNDEF) {
+				self->_phases[v] = self->_best[v];
+			}
+		}
+		self->_best_size = 0;
+		break;
+	}
+
+	/* start looking for a new target */
+	memset(self->_target, VALUE_UNDEF, n * sizeof(uint8_t));
+	self->_target_size = 0;
+	self->_next_rephase =
+	    self->_conflicts + self->_rephase_interval * (self->_rephases + 1);
+}
+
+static bool search(cl_sat_t * self)
+{
+	if (!self->_ok) {
+		return false;
+	}
+
+	for (;;) {
+		if (exhausted(self)) {
+			return false;
+		}
+
+		uint32_t conflict = propagate_all(self);
+
+		if (conflict != NIL) {
+			if (self->_decision_level == 0) {
+				return self->_ok = false;
+			}
+
+			cl_sat_vector_t *learnt = &self->_learnt;
+			size_t level = analyze(self, conflict);
+			uint32_t glue = lbd(self, learnt->data, learnt->size);
+			backjump(self, level);
+
+			if (learnt->size == 1) {
+				enqueue(self, learnt->data[0], NIL);
+			} else {
+				uint32_t cref = clause_new(self, learnt->data,
+							   learnt->size,
+							   CLAUSE_LEARNT, glue);
+				vector_push(&self->_learnts, cref);
+				enqueue(self, learnt->data[0], cref);
+			}
+
+			decay(self);
+			self->_conflicts++;
+			STAT(self->_stats.learnt++);
+
+			if (restart_due(self, glue)) {
+				restart(self);
+			}
+
+			if (self->_conflicts >= self->_next_reduce) {
+				reduce(self);
+			}
+
+			if (self->_conflicts >= self->_next_rephase) {
+				rephase(self);
+			}
+			continue;
+		}
+
+		/* the assumptions are decided first, one per level */
+		uint32_t next = NIL;
+		while (next == NIL
+		       && self->_decision_level < self->_assumptions.size) {
+			uint32_t p =
+			    self->_assumptions.data[self->_decision_level];
+
+			if (value(self, p) == VALUE_TRUE) {
+				self->_trail_lim[self->_decision_level++] =
+				    self->_trail_size;
+			} else if (value(self, p) == VALUE_FALSE) {
+				analyze_final(self, p);
+				return false;
+			} else {
+				next = p;
+			}
+		}
+
+		if (next == NIL) {
+			uint32_t var = pick_branch(self);
+			if (var == NIL) {
+				return true;
+			}
+
+			/* prefer the target phase over the saved one */
+			uint8_t phase = self->_target[var] != VALUE_UNDEF ?
+			    self->_target[var] : self->_phases[var];
+			next = 2 * var + !phase;
+		}
+
+		self->_trail_lim[self->_decision_level++] = self->_trail_size;
+		self->_decisions++;
+		enqueue(self, next, NIL);
+	}
+}
+
+/* Brings the solver up to date with the formula and the assumptions,
+ * and starts counting the budgets of the call. */
+static void prepare(cl_sat_t * self, cl_cnf_t * cnf,
+		    cl_collection_t * assumptions)
+{
+	STAT(size_t time = now());
+	STAT(self->_stats.solves++);
+	sync(self, cnf);
+	STAT(self->_stats.load_time += now() - time);
+	start(self);
+
+	size_t n = assumptions ? cl_collection_count(assumptions) : 0;
+	self->_assumptions.size = 0;
+	for (size_t i = 0; i < n; i++) {
+		vector_push(&self->_assumptions,
+			    literal(self, cl_collection_get(assumptions, i)));
+	}
+	reserve_levels(self, self->_var_capacity + n + 1);
+
+	cl_object_release(self->_failed);
+	self->_failed = cl_collection_new(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					  CL_COLLECTION_FLAG_AUTORESIZE);
+}
+
+/* Searches for a model of the prepared formula, keeping it as the phases.
+ * It touches no objects, so solvers of different formulas may run at once. */
+static bool run(cl_sat_t * self)
+{
+	/* try the local search first, otherwise search systematically.
+	 * The local search knows nothing of the XOR and cardinality constraints. */
+	bool sat = self->_ok;
+	bool walked = false;
+	if (sat && !self->_assumptions.size && self->_maxflips
+	    && !self->_xors.size && !self->_cards.size) {
+		STAT(size_t time = now());
+		walked = walk(self, self->_maxflips);
+		STAT(self->_stats.walk_time += now() - time);
+	}
+
+	if (sat && !walked) {
+		STAT(size_t time = now());
+		sat = !self->_exhausted && search(self);
+		STAT(self->_stats.search_time += now() - time);
+
+		/* keep the model as the phases for the next call */
+		if (sat && self->_nvars) {
+			memcpy(self->_phases, self->_assigns, self->_nvars);
+		}
+	}
+
+	return sat;
+}
+
+/* Ends the call, assigning the model found to the literals of the formula,
+ * or reporting the assumptions found in the final conflict. */
+static cl_collection_t *finish(cl_sat_t * self, cl_cnf_t * cnf,
+			       cl_collection_t * assumptions, bool sat)
+{
+	if (!sat && self->_ok && !self->_exhausted && self->_assumptions.size) {
+		cl_sat_vector_t *failed = &self->_learnt;
+		for (size_t i = 0; i < failed->size; i++) {
+			uint32_t lit = failed->data[i];
+			self->_seen[lit >> 1] |= 1 << (lit & 1);
+		}
+
+		for (size_t i = 0; i < self->_assumptions.size; i++) {
+			uint32_t lit = self->_assumptions.data[i];
+			if (self->_seen[lit >> 1] & 1 << (lit & 1)) {
+				cl_collection_add(self->_failed,
+						  cl_collection_get
+						  (assumptions, i));
+			}
+		}
+
+		for (size_t i = 0; i < failed->size; i++) {
+			self->_seen[failed->data[i] >> 1] = 0;
+		}
+	}
+
+	backjump(self, 0);
+	self->_interrupted = 0;
+	STAT(peak(self));
+	if (!sat) {
+		return NULL;
+	}
+
+	cl_collection_t *literals = cl_cnf_literals(cnf);
+	for (size_t i = 0; i < cl_collection_count(literals); i++) {
+		cl_cnf_literal_t *lit = cl_collection_get(literals, i);
+		cl_cnf_literal_assign(lit, self->_phases[variable(self, lit)]
+				      == VALUE_TRUE);
+	}
+
+	/* and to the variables of the assumptions, which may not be in it */
+	size_t n = assumptions ? cl_collection_count(assumptions) : 0;
+	for (size_t i = 0; i < n; i++) {
+		cl_cnf_literal_t *lit = cl_collection_get(assumptions, i);
+		cl_cnf_literal_t *pos = lit->_negation ? lit->_dual : lit;
+		cl_cnf_literal_assign(pos, self->_phases[variable(self, pos)]
+				      == VALUE_TRUE);
+	}
+
+	/* and to the literals eliminated by simplification */
+	cl_cnf_extend(cnf);
+
+	return literals;
+}
+
+cl_collection_t *cl_sat_solve_assuming(cl_sat_t * self, cl_cnf_t * cnf,
+				       cl_collection_t * assumptions)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+	assert(cl_object_type_check(cnf, CL_OBJECT_TYPE_CNF));
+
+	prepare(self, cnf, assumptions);
+	return finish(self, cnf, assumptions, run(self));
+}
+
+cl_collection_t *cl_sat_solve(cl_sat_t * self, cl_cnf_t * cnf)
+{
+	return cl_sat_solve_assuming(self, cnf, NULL);
+}
+
+/* The solvers of the components, the first one found unsatisfiable
+ * interrupting all the others. */
+typedef struct components_s {
+	cl_sat_t **solvers;
+	bool *sat;
+	size_t count;
+} components_t;
+
+static void component_task(void *data, size_t index)
+{
+	components_t *c = data;
+	cl_sat_t *solver = c->solvers[index];
+
+	c->sat[index] = run(solver);
+	if (!c->sat[index] && solver->_exhausted == CL_SAT_BUDGET_NONE) {
+		for (size_t i = 0; i < c->count; i++) {
+			c->solvers[i]->_interrupted = i != index;
+		}
+	}
+}
+
+/* Adds the statistics of the solver of a component to the ones of the call. */
+static void component_stats(cl_sat_t * self, cl_sat_t * solver)
+{
+	cl_sat_stats_t stats;
+	cl_sat_stats(solver, &stats);
+
+	self->_stats.decisions += stats.decisions;
+	self->_stats.propagations += stats.propagations;
+	self->_stats.conflicts += stats.conflicts;
+	self->_stats.flips += stats.flips;
+	self->_stats.restarts += stats.restarts;
+	self->_stats.reductions += stats.reductions;
+	self->_stats.learnt += stats.learnt;
+	self->_stats.deleted += stats.deleted;
+	self->_stats.peak_memory += stats.peak_memory;
+	self->_stats.load_time += stats.load_time;
+	self->_stats.walk_time += stats.walk_time;
+	self->_stats.search_time += stats.search_time;
+}
+
+cl_collection_t *cl_sat_solve_components(cl_sat_t * self, cl_cnf_t * cnf,
+					 size_t nthreads)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+	assert(cl_object_type_check(cnf, CL_OBJECT_TYPE_CNF));
+
+	cl_collection_t *parts = cl_cnf_components(cnf);
+	size_t count = cl_collection_count(parts);
+	if (count < 2) {
+		return cl_sat_solve(self, cnf);
+	}
+
+	components_t c;
+	c.solvers = malloc(count * sizeof(cl_sat_t *));
+	c.sat = malloc(count * sizeof(bool));
+	c.count = count;
+	assert(c.solvers && c.sat);
+
+	/* the solvers take the settings of this one, each with a stream
+	 * of random numbers of its own, and are loaded one by one */
+	for (size_t i = 0; i < count; i++) {
+		cl_sat_t *solver = c.solvers[i] = cl_sat_new();
+		cl_sat_t *previous = i ? c.solvers[i - 1] : self;
+		solver->_parent = self;
+		solver->_maxflips = self->_maxflips;
+		solver->_heuristic = self->_heuristic;
+		solver->_restart = self->_restart;
+		memcpy(solver->_limits, self->_limits, sizeof(self->_limits));
+		memcpy(solver->_random, previous->_random,
+		       sizeof(self->_random));
+		random_jump(solver);
+
+		prepare(solver, cl_collection_get(parts, i), NULL);
+	}
+
+	cl_thread_run(nthreads, count, &component_task, &c);
+
+	/* an unsatisfiable component makes the formula unsatisfiable,
+	 * otherwise a budget which ran out leaves it undecided */
+	bool sat = true;
+	self->_exhausted = CL_SAT_BUDGET_NONE;
+	for (size_t i = 0; i < count; i++) {
+		if (!c.sat[i]) {
+			sat = false;
+			self->_exhausted = c.solvers[i]->_exhausted;
+			if (self->_exhausted == CL_SAT_BUDGET_NONE) {
+				break;
+			}
+		}
+	}
+
+	STAT(self->_stats.solves++);
+	for (size_t i = 0; i < count; i++) {
+		cl_sat_t *solver = c.solvers[i];
+		finish(solver, cl_collection_get(parts, i), NULL, c.sat[i]);
+		STAT(component_stats(self, solver));
+		cl_object_release(solver);
+	}
+
+	free(c.solvers);
+	free(c.sat);
+
+	/* the call is over, with no assumptions to have failed */
+	self->_interrupted = 0;
+	cl_object_release(self->_failed);
+	self->_failed = NULL;
+	if (!sat) {
+		return NULL;
+	}
+
+	/* the eliminated literals are recovered from the whole formula */
+	cl_cnf_extend(cnf);
+	return cl_cnf_literals(cnf);
+}
+
+cl_collection_t *cl_sat_failed(cl_sat_t * self)
+{
+	assert(cl_object_type_check(self, CL_OBJECT_TYPE_SAT));
+
+	cl_collection_t *res = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	for (size_t i = 0; self->_failed
+	     && i < cl_collection_count(self->_failed); i++) {
+		cl_collection_add(res, cl_collection_get(self->_failed, i));
+	}
+
+	return res;
 }
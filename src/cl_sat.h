@@ -30,19 +30,203 @@
  * The flags can be combined by using the bitwise OR operator. */
 typedef uint8_t cl_sat_flags_t;
 
+/** SAT decision heuristic type. */
+typedef uint8_t cl_sat_heuristic_t;
+
+/** RANDOM decision heuristic.
+ * The next variable to branch on is picked uniformly at random. */
+#define CL_SAT_HEURISTIC_RANDOM 0x00
+
+/** VSIDS decision heuristic (default).
+ * The next variable to branch on is the one with the highest activity,
+ * bumped each time the variable takes part in a conflict
+ * and decayed exponentially over time. */
+#define CL_SAT_HEURISTIC_VSIDS 0x01
+
+/** SAT restart policy type. */
+typedef uint8_t cl_sat_restart_t;
+
+/** NONE restart policy.
+ * The search is never restarted. */
+#define CL_SAT_RESTART_NONE 0x00
+
+/** LUBY restart policy.
+ * The search is restarted after a number of conflicts
+ * following the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...). */
+#define CL_SAT_RESTART_LUBY 0x01
+
+/** GLUCOSE restart policy (default).
+ * The search is restarted when the moving average of the
+ * literal block distance of the recently learnt clauses
+ * grows above the average over all learnt clauses. */
+#define CL_SAT_RESTART_GLUCOSE 0x02
+
+/** SAT budget type, naming a limit on a single call of the solver. */
+typedef uint8_t cl_sat_budget_t;
+
+/** NONE budget.
+ * Reported when no budget ran out and the result of the call is definite. */
+#define CL_SAT_BUDGET_NONE 0x00
+
+/** TIME budget, in milliseconds of wall-clock time. */
+#define CL_SAT_BUDGET_TIME 0x01
+
+/** CONFLICTS budget, in conflicts of the search. */
+#define CL_SAT_BUDGET_CONFLICTS 0x02
+
+/** PROPAGATIONS budget, in literals propagated by the search. */
+#define CL_SAT_BUDGET_PROPAGATIONS 0x03
+
+/** MEMORY budget, in bytes held by the solver. */
+#define CL_SAT_BUDGET_MEMORY 0x04
+
+/** INTERRUPT budget.
+ * Reported when the call was stopped by @ref cl_sat_interrupt,
+ * or by the progress callback. It can't be set. */
+#define CL_SAT_BUDGET_INTERRUPT 0x05
+
+/** Progress of a running call of the solver,
+ * with the counters taken since the start of the call. */
+typedef struct cl_sat_progress_s cl_sat_progress_t;
+struct cl_sat_progress_s {
+	size_t elapsed;
+	size_t conflicts;
+	size_t decisions;
+	size_t propagations;
+	size_t restarts;
+	size_t learnts;
+	size_t memory;
+};
+
+/** Statistics of the solver, accumulated over all its calls.
+ * The times are in microseconds of wall-clock time:
+ * of translating the formulas into the solver, of the local search tried first,
+ * and of the conflict driven search.
+ * When compiled with CL_SAT_NO_STATISTICS defined (configure --disable-statistics),
+ * only the counters the search needs anyway are kept: decisions, propagations,
+ * conflicts, restarts and reductions. The rest are left 0. */
+typedef struct cl_sat_stats_s cl_sat_stats_t;
+struct cl_sat_stats_s {
+	size_t solves;
+	size_t decisions;
+	size_t propagations;
+	size_t conflicts;
+	size_t flips;
+	size_t restarts;
+	size_t reductions;
+	size_t learnt;
+	size_t deleted;
+	size_t peak_memory;
+	size_t load_time;
+	size_t walk_time;
+	size_t search_time;
+};
+
 /** Object type representing the SAT solver. */
 typedef struct cl_sat_s cl_sat_t;
 
+/** Progress callback type.
+ * Called periodically from the running solver, with the user provided data.
+ * @return false to stop the call, which is then reported as interrupted. */
+typedef bool(*cl_sat_progress_callback_t) (cl_sat_t * self,
+					   const cl_sat_progress_t * progress,
+					   void *data);
+
 /** Initializes a new SAT solver. */
 cl_sat_t *cl_sat_new();
 
+/** Sets the heuristic used to pick the next decision variable. */
+void cl_sat_heuristic_set(cl_sat_t * self, cl_sat_heuristic_t heuristic);
+
+/** Sets the policy used to decide when to restart the search. */
+void cl_sat_restart_set(cl_sat_t * self, cl_sat_restart_t restart);
+
+/** Seeds the random number generator of the solver.
+ * The solver is deterministic for a given seed, which is fixed by default.
+ * @param seed The seed.
+ * @param stream The stream of the generator to be used:
+ * solvers with the same seed and different streams get independent,
+ * non-overlapping, sequences of random numbers. */
+void cl_sat_seed(cl_sat_t * self, uint64_t seed, size_t stream);
+
+/** Sets a limit on every following call of the solver.
+ * A call running out of a budget gives up and returns NULL,
+ * and the budget is reported by @ref cl_sat_exhausted.
+ * The budgets are checked every few conflicts and decisions,
+ * so a call may slightly overrun them.
+ * @param budget The budget to be set, one of the CL_SAT_BUDGET_* flags but NONE and INTERRUPT.
+ * @param limit The limit in the units of the budget, or 0 for no limit (default). */
+void cl_sat_budget_set(cl_sat_t * self, cl_sat_budget_t budget, size_t limit);
+
+/** Sets the callback reporting the progress of the running solver.
+ * @param callback The callback, or NULL for none (default).
+ * @param data Passed to the callback as is.
+ * @param period The time between two calls of the callback, in milliseconds. */
+void cl_sat_progress_set(cl_sat_t * self, cl_sat_progress_callback_t callback,
+			 void *data, size_t period);
+
+/** Stops the running call of the solver as soon as possible,
+ * or the next one if none is running.
+ * The call returns NULL and reports @ref CL_SAT_BUDGET_INTERRUPT.
+ * It only sets a flag, so it is safe to call from a signal handler
+ * or from another thread. */
+void cl_sat_interrupt(cl_sat_t * self);
+
+/** Fills in the statistics of the solver. */
+void cl_sat_stats(cl_sat_t * self, cl_sat_stats_t * stats);
+
+/** Writes the statistics of the solver into the stream,
+ * as a JSON object with the fields of @ref cl_sat_stats_t as keys. */
+void cl_sat_stats_write(cl_sat_t * self, cl_object_stream_t * stream);
+
+/** Returns the budget which ran out in the last call of the solver,
+ * or @ref CL_SAT_BUDGET_NONE if it returned a definite answer.
+ * When a budget ran out, NULL was returned, but the formula may be satisfiable. */
+cl_sat_budget_t cl_sat_exhausted(cl_sat_t * self);
+
 /** Runs the solver for the provided CNF formula.
+ * If the maximum number of flips is set, a local search is tried first,
+ * after which the solver falls back to a complete conflict driven search.
+ * Same as @ref cl_sat_solve_assuming with no assumptions.
  * @return A set of all the literlas in the formula,
  * as returned by the @ref cl_cnf_literals function, 
  * with their proper assignment which satifies the formula.
- * Or NULL if such assignment was not fund. */
+ * Or NULL if the formula is not satisfiable, or a budget ran out. */
 cl_collection_t * cl_sat_solve(cl_sat_t * self, cl_cnf_t *cnf);
 
+/** Runs the solver for the provided CNF formula, assuming the provided literals are true.
+ * The solver is incremental: the learnt clauses, the activities and the phases
+ * are kept between calls for the same formula, and the clauses added to it
+ * in the meantime are picked up by the next call.
+ * Removing clauses from the formula makes the solver start over,
+ * while the clauses must not be changed once added to the formula.
+ * @param assumptions A collection of literals assumed to be true, or NULL.
+ * @return Same as @ref cl_sat_solve. The assumptions hold in the model,
+ * the ones over literals not in the formula as well, which are not in the set returned.
+ * If NULL is returned, the assumptions responsible are reported by @ref cl_sat_failed. */
+cl_collection_t *cl_sat_solve_assuming(cl_sat_t * self, cl_cnf_t * cnf,
+				       cl_collection_t * assumptions);
+
+/** Runs the solver for each of the components of the CNF formula,
+ * as split by @ref cl_cnf_components, on a pool of threads.
+ * Each component gets a solver of its own, with the settings of this one,
+ * but the progress callback, and an independent stream of random numbers.
+ * The first component found unsatisfiable interrupts the others,
+ * and so does @ref cl_sat_interrupt of this solver all of them.
+ * The statistics of the component solvers are added to the ones of this one.
+ * A formula of a single component is solved by @ref cl_sat_solve.
+ * @param nthreads The number of threads, or 0 for one per processor.
+ * @return Same as @ref cl_sat_solve, with the models of the components merged.
+ * If a budget ran out in one of the components, it is reported by @ref cl_sat_exhausted. */
+cl_collection_t *cl_sat_solve_components(cl_sat_t * self, cl_cnf_t * cnf,
+					 size_t nthreads);
+
+/** Returns a new, autoreleased, collection of the assumptions
+ * which made the last call to @ref cl_sat_solve_assuming unsatisfiable.
+ * The collection is empty if the formula is unsatisfiable on its own,
+ * or the last call found a solution. */
+cl_collection_t *cl_sat_failed(cl_sat_t * self);
+
 /** Returns a new, autoreleased, SAT solver */
 #define cl_sat(...) cl_object_autorelease(cl_sat_new(__VA_ARGS__))
 
@@ -19,11 +19,168 @@
 #ifndef CL_SAT_REP_H
 #define CL_SAT_REP_H
 
+#include <signal.h>
+#include "cl_sat.h"
 #include "cl_object_rep.h"
+#include "cl_collection.h"
+#include "cl_cnf.h"
 
+/** A watcher of a clause, with a blocking literal
+ * which, if true, makes visiting the clause unnecessary. */
+typedef struct cl_sat_watch_s {
+	uint32_t cref;
+	uint32_t blocker;
+} cl_sat_watch_t;
+
+/** Growable list of watchers for one literal. */
+typedef struct cl_sat_watches_s {
+	cl_sat_watch_t *data;
+	size_t size;
+	size_t capacity;
+} cl_sat_watches_t;
+
+/** Growable list of 32-bit words (literals, variables or clause references). */
+typedef struct cl_sat_vector_s {
+	uint32_t *data;
+	size_t size;
+	size_t capacity;
+} cl_sat_vector_t;
+
+/** Open addressing hash table mapping literal objects to variables. */
+typedef struct cl_sat_index_s {
+	void **keys;
+	uint32_t *vars;
+	size_t capacity;
+} cl_sat_index_t;
+
+/* Internally the variables are numbered 0 .. _nvars - 1,
+ * in the order of the literals in the _literals array,
+ * and a literal is encoded as 2 * variable + 1 if negated.
+ * The clauses are stored back to back in the _arena
+ * and referenced by their offset in it. */
 struct cl_sat_s {
 	cl_object_info_t _obj_info;
 	size_t _maxflips;
+	uint8_t _heuristic;
+	size_t _rephase_interval;
+	uint8_t _restart;
+	size_t _luby_unit;
+	double _restart_margin;
+	uint32_t _tier1_lbd;
+	uint32_t _tier2_lbd;
+	size_t _reduce_interval;
+	size_t _conflicts;
+	size_t _decisions;
+	size_t _propagations;
+	size_t _restarts;
+	size_t _reductions;
+	uint64_t _random[4];
+
+	/* statistics, the counters above added in when the state is reset */
+	cl_sat_stats_t _stats;
+
+	/* limits of a call, indexed by the budget and 0 if unlimited,
+	 * the counters and the time at its start, and the interrupt flag,
+	 * along with the solver whose call this one is a part of, if any,
+	 * its flag stopping this one too */
+	size_t _limits[CL_SAT_BUDGET_INTERRUPT];
+	cl_sat_progress_t _start;
+	size_t _started;
+	size_t _ticks;
+	cl_sat_progress_callback_t _progress;
+	void *_progress_data;
+	size_t _progress_period;
+	size_t _next_progress;
+	cl_sat_budget_t _exhausted;
+	volatile sig_atomic_t _interrupted;
+	cl_sat_t *_parent;
+
+	/* the formula being solved and its clauses translated so far,
+	 * along with its set of clauses at the last call and the counts
+	 * of the clauses added to it and removed from it by then */
+	cl_cnf_t *_cnf;
+	cl_collection_t *_loaded;
+	cl_collection_t *_synced;
+	size_t _synced_added;
+	size_t _synced_removals;
+	cl_sat_vector_t _assumptions;
+	cl_collection_t *_failed;
+
+	/* variables */
+	cl_collection_t *_literals;
+	cl_sat_index_t _index;
+	size_t _nvars;
+	size_t _var_capacity;
+	size_t _level_capacity;
+	uint8_t *_assigns;
+	uint32_t *_levels;
+	uint32_t *_reasons;
+	uint8_t *_seen;
+
+	/* trail */
+	uint32_t *_trail;
+	size_t _trail_size;
+	uint32_t *_trail_lim;
+	size_t _decision_level;
+	size_t _qhead;
+
+	/* clauses */
+	uint32_t *_arena;
+	size_t _arena_size;
+	size_t _arena_capacity;
+	cl_sat_vector_t _clauses;
+	cl_sat_vector_t _learnts;
+	cl_sat_watches_t *_watches;
+	cl_sat_vector_t _learnt;
+	bool _ok;
+
+	/* XOR constraints as rows of variables, prefixed by size and parity,
+	 * and their bit matrix over the columns, with the parity in the last bit */
+	size_t _xors_loaded;
+	cl_sat_vector_t _xors;
+	cl_sat_vector_t _columns;
+	uint32_t *_column_of;
+	uint64_t *_matrix;
+	uint64_t *_work;
+	bool *_pivotal;
+	size_t _rows;
+	size_t _words;
+	bool _xors_dirty;
+
+	/* cardinality constraints as [bound, size, literals ...] starting at
+	 * _card_starts, with the true literals counted up to _card_head on the trail */
+	size_t _cards_loaded;
+	cl_sat_vector_t _cards;
+	cl_sat_vector_t _card_starts;
+	cl_sat_vector_t _card_counts;
+	cl_sat_vector_t *_card_occs;
+	size_t _card_head;
+	cl_sat_vector_t _explanation;
+
+	/* VSIDS */
+	double *_activity;
+	double _var_inc;
+	double _var_decay;
+	uint32_t *_heap;
+	uint32_t *_heap_index;
+	size_t _heap_size;
+
+	/* phases */
+	uint8_t *_phases;
+	uint8_t *_target;
+	size_t _target_size;
+	uint8_t *_best;
+	size_t _best_size;
+	size_t _rephases;
+	size_t _next_rephase;
+
+	/* restarts and clause database reduction */
+	size_t _since_restart;
+	double _lbd_fast;
+	double _lbd_sum;
+	size_t _next_reduce;
+	uint32_t *_stamps;
+	uint32_t _stamp;
 };
 
 #endif				/* CL_SAT_REP_H */
@@ -0,0 +1,161 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "cl_thread.h"
+
+typedef struct run_s {
+	pthread_mutex_t lock;
+	size_t next;
+	size_t ntasks;
+	cl_thread_task_t task;
+	void *data;
+} run_t;
+
+/* The workers of the pool, started on demand and kept for later runs.
+ * A run is open to wanted workers while it is posted, and is over
+ * when the calling thread has closed it and the active workers are done. */
+static struct pool_s {
+	pthread_mutex_t lock;
+	pthread_cond_t posted;
+	pthread_cond_t done;
+	bool busy;
+	size_t started;
+	size_t wanted;
+	size_t joined;
+	size_t active;
+	size_t generation;
+	run_t *run;
+} pool = {
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+	PTHREAD_COND_INITIALIZER, false, 0, 0, 0, 0, 0, NULL
+};
+
+static void work(run_t * run)
+{
+	while (true) {
+		pthread_mutex_lock(&run->lock);
+		size_t index = run->next < run->ntasks ? run->next++ : SIZE_MAX;
+		pthread_mutex_unlock(&run->lock);
+
+		if (index == SIZE_MAX) {
+			return;
+		}
+		run->task(run->data, index);
+	}
+}
+
+static void *worker(void *arg)
+{
+	size_t seen = 0;
+
+	pthread_mutex_lock(&pool.lock);
+	while (true) {
+		while (!pool.run || pool.joined >= pool.wanted
+		       || seen == pool.generation) {
+			pthread_cond_wait(&pool.posted, &pool.lock);
+		}
+
+		run_t *run = pool.run;
+		seen = pool.generation;
+		pool.joined++;
+		pool.active++;
+		pthread_mutex_unlock(&pool.lock);
+
+		work(run);
+
+		pthread_mutex_lock(&pool.lock);
+		if (!--pool.active) {
+			pthread_cond_signal(&pool.done);
+		}
+	}
+
+	return NULL;
+}
+
+/* Starts the workers missing for the run, returning how many there are. */
+static size_t workers(size_t count)
+{
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	pthread_t thread;
+	while (pool.started < count
+	       && !pthread_create(&thread, &attr, &worker, NULL)) {
+		pool.started++;
+	}
+
+	pthread_attr_destroy(&attr);
+	return pool.started < count ? pool.started : count;
+}
+
+size_t cl_thread_count()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? count : 1;
+}
+
+void cl_thread_run(size_t nthreads, size_t ntasks, cl_thread_task_t task,
+		   void *data)
+{
+	nthreads = nthreads ? nthreads : cl_thread_count();
+	nthreads = nthreads < ntasks ? nthreads : ntasks;
+
+	run_t run;
+	pthread_mutex_init(&run.lock, NULL);
+	run.next = 0;
+	run.ntasks = ntasks;
+	run.task = task;
+	run.data = data;
+
+	/* a run from a task, or from another thread while the pool is busy,
+	 * is left to the calling thread, as are the workers which
+	 * could not be started */
+	pthread_mutex_lock(&pool.lock);
+	bool posted = !pool.busy && nthreads > 1;
+	if (posted) {
+		pool.busy = true;
+		pool.wanted = workers(nthreads - 1);
+		pool.joined = 0;
+		pool.generation++;
+		pool.run = &run;
+		pthread_cond_broadcast(&pool.posted);
+	}
+	pthread_mutex_unlock(&pool.lock);
+
+	work(&run);
+
+	if (posted) {
+		pthread_mutex_lock(&pool.lock);
+		pool.run = NULL;
+		while (pool.active) {
+			pthread_cond_wait(&pool.done, &pool.lock);
+		}
+		pool.busy = false;
+		pthread_mutex_unlock(&pool.lock);
+	}
+
+	pthread_mutex_destroy(&run.lock);
+}
@@ -0,0 +1,43 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CL_THREAD_H
+#define CL_THREAD_H
+
+#include <stdlib.h>
+
+/* A pool of worker threads, running a batch of independent tasks.
+ * The workers are started on demand and wait for the next batch in between.
+ * The objects are not thread safe, so the tasks should work on plain data,
+ * and must not retain, release or autorelease any objects. */
+
+/* The task, called with the data and the index of the task. */
+typedef void (*cl_thread_task_t) (void *data, size_t index);
+
+/* Returns the number of processors online, at least 1. */
+size_t cl_thread_count();
+
+/* Runs the tasks 0 .. ntasks - 1 on up to nthreads threads, the calling one included,
+ * or on one thread per processor if nthreads is 0. Each worker picks the next task
+ * not started yet. Returns when all the tasks are done.
+ * While the pool runs a batch, the batches of other calls, including the ones
+ * from its tasks, run on their calling threads alone. */
+void cl_thread_run(size_t nthreads, size_t ntasks, cl_thread_task_t task,
+		   void *data);
+
+#endif				/* CL_THREAD_H */
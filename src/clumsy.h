@@ -24,5 +24,7 @@
 #include "cl_collection.h"
 #include "cl_cnf.h"
 #include "cl_sat.h"
+#include "cl_bdd.h"
+#include "cl_parser.h"
 
 #endif				/* CLUMSY_H */
@@ -0,0 +1,198 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <check.h>
+#include <stdlib.h>
+#include "../clumsy.h"
+#include "../cl_bdd_rep.h"
+
+static bool value(cl_proposition_t * proposition)
+{
+	cl_proposition_context_t *ctx = cl_proposition_get_context(proposition);
+	return *((bool *)ctx->argv[0]);
+}
+
+void setup()
+{
+	cl_object_pool_push();
+}
+
+void teardown()
+{
+	cl_object_pool_pop();
+}
+
+START_TEST(test_bdd)
+{
+	bool data[3] = { false, false, false };
+	cl_proposition_t *p = cl_proposition(&value, &data[0]);
+	cl_proposition_t *pdup = cl_proposition(&value, &data[0]);
+	cl_proposition_t *q = cl_proposition(&value, &data[1]);
+	cl_proposition_t *r = cl_proposition(&value, &data[2]);
+
+	cl_bdd_t *bdd = cl_bdd();
+
+	/* constants */
+	cl_bdd_node_t f = cl_bdd_construct(bdd, cl_proposition_true());
+	fail_unless(f == CL_BDD_TRUE);
+	fail_unless(cl_bdd_valid(bdd, f));
+	f = cl_bdd_construct(bdd, cl_proposition_false());
+	fail_unless(f == CL_BDD_FALSE);
+	fail_if(cl_bdd_satisfiable(bdd, f));
+
+	/* P v ~P is valid, P ^ ~P is not satisfiable */
+	f = cl_bdd_construct(bdd, cl_proposition_or(p, cl_proposition_not(p)));
+	fail_unless(cl_bdd_valid(bdd, f));
+	f = cl_bdd_construct(bdd,
+			     cl_proposition_and(p, cl_proposition_not(pdup)));
+	fail_if(cl_bdd_satisfiable(bdd, f));
+	fail_unless(cl_bdd_variables(bdd) == 1);
+
+	/* (P => Q) <=> (~Q => ~P) */
+	cl_bdd_node_t g = cl_bdd_construct(bdd, cl_proposition_imply(p, q));
+	f = cl_bdd_construct(bdd,
+			     cl_proposition_imply(cl_proposition_not(q),
+						  cl_proposition_not(p)));
+	fail_unless(cl_bdd_equivalent(bdd, f, g));
+	fail_unless(cl_bdd_size(bdd, f) == 4);
+	fail_unless(cl_bdd_count(bdd, f) == 3);
+	cl_bdd_deref(bdd, f);
+	cl_bdd_deref(bdd, g);
+
+	/* ~((P xor Q xor R) v ~(P ^ R)) has the single model P ^ ~Q ^ R */
+	cl_proposition_t *prop =
+	    cl_proposition_nor(cl_proposition_xor(p, cl_proposition_xor(q, r)),
+			       cl_proposition_nand(p, r));
+	f = cl_bdd_construct(bdd, prop);
+	fail_unless(cl_bdd_variables(bdd) == 3);
+	fail_unless(cl_bdd_count(bdd, f) == 1);
+	for (int i = 0; i < 8; i++) {
+		data[0] = i & 0x01;
+		data[1] = i & 0x02;
+		data[2] = i & 0x04;
+
+		fail_unless(cl_bdd_eval(bdd, f) == cl_proposition_eval(prop));
+	}
+	cl_bdd_deref(bdd, f);
+
+	/* the garbage should be collected */
+	cl_bdd_gc(bdd);
+	fail_unless(cl_bdd_live(bdd) == 0);
+}
+
+END_TEST START_TEST(test_reorder)
+{
+	bool data[12];
+	cl_proposition_t *x[6];
+	cl_proposition_t *y[6];
+	cl_bdd_t *bdd = cl_bdd();
+
+	/* the worst order for (x0 ^ y0) v (x1 ^ y1) v ... 
+	 * is when all the x variables come before the y variables */
+	for (int i = 0; i < 6; i++) {
+		x[i] = cl_proposition(&value, &data[i]);
+		cl_bdd_deref(bdd, cl_bdd_variable(bdd, x[i]));
+	}
+
+	cl_proposition_t *prop = cl_proposition_false();
+	for (int i = 0; i < 6; i++) {
+		y[i] = cl_proposition(&value, &data[6 + i]);
+		cl_bdd_deref(bdd, cl_bdd_variable(bdd, y[i]));
+		prop = cl_proposition_or(prop, cl_proposition_and(x[i], y[i]));
+	}
+
+	cl_bdd_node_t f = cl_bdd_construct(bdd, prop);
+	cl_bdd_gc(bdd);
+	size_t before = cl_bdd_size(bdd, f);
+	double count = cl_bdd_count(bdd, f);
+
+	cl_bdd_reorder(bdd);
+
+	/* the interleaved order needs only 2 nodes per pair */
+	fail_unless(cl_bdd_size(bdd, f) < before);
+	fail_unless(cl_bdd_size(bdd, f) == 14);
+	fail_unless(cl_bdd_live(bdd) == 12);
+	fail_unless(cl_bdd_count(bdd, f) == count);
+
+	/* the same function is still represented by the same node */
+	cl_bdd_node_t g = cl_bdd_construct(bdd, prop);
+	fail_unless(cl_bdd_equivalent(bdd, f, g));
+
+	for (int i = 0; i < 4096; i += 7) {
+		for (int j = 0; j < 12; j++) {
+			data[j] = i & (1 << j);
+		}
+
+		fail_unless(cl_bdd_eval(bdd, f) == cl_proposition_eval(prop));
+	}
+
+	cl_bdd_deref(bdd, f);
+	cl_bdd_deref(bdd, g);
+}
+
+END_TEST START_TEST(test_cache)
+{
+	bool data[12];
+	cl_bdd_t *bdd = cl_bdd();
+
+	/* the parity of 12 variables, and its complement */
+	cl_proposition_t *prop = cl_proposition_false();
+	for (int i = 0; i < 12; i++) {
+		prop = cl_proposition_xor(prop, cl_proposition(&value, &data[i]));
+	}
+
+	cl_bdd_node_t f = cl_bdd_construct(bdd, prop);
+	cl_bdd_node_t g = cl_bdd_construct(bdd, cl_proposition_not(prop));
+
+	/* their conjunction reduces to FALSE, which is cached as well */
+	cl_bdd_node_t h = cl_bdd_ite(bdd, f, g, CL_BDD_FALSE);
+	fail_unless(h == CL_BDD_FALSE);
+	size_t hits = bdd->_cache_hits;
+	h = cl_bdd_ite(bdd, f, g, CL_BDD_FALSE);
+	fail_unless(h == CL_BDD_FALSE);
+	fail_unless(bdd->_cache_hits == hits + 1);
+
+	cl_bdd_deref(bdd, f);
+	cl_bdd_deref(bdd, g);
+}
+
+END_TEST Suite *test_suite(void)
+{
+	Suite *s = suite_create("TEST BDD");
+
+	TCase *tc_core = tcase_create("TEST_BDD");
+	tcase_add_checked_fixture(tc_core, setup, teardown);
+	tcase_add_test(tc_core, test_bdd);
+	tcase_add_test(tc_core, test_reorder);
+	tcase_add_test(tc_core, test_cache);
+	suite_add_tcase(s, tc_core);
+
+	return s;
+}
+
+int main(void)
+{
+	int number_failed;
+	Suite *s = test_suite();
+	SRunner *sr = srunner_create(s);
+	srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -19,8 +19,10 @@
 #include <check.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "../clumsy.h"
 #include "../cl_cnf_rep.h"
+#include "../cl_collection_rep.h"
 
 static bool is_grater_than(cl_proposition_t * proposition)
 {
@@ -33,28 +35,27 @@ static bool is_grater_than(cl_proposition_t * proposition)
 
 static void check_cnf(cl_cnf_t * cnf)
 {
-	/* get a set of all the literals: {P, ~Q, ~R, M} */
+	/* get a set of all the literals: {P, ~Q, M},
+	 * R occurring in a tautology only */
 	cl_collection_t *literals = cl_object_retain(cl_cnf_literals(cnf));
 	fail_if(literals == NULL);
-	fail_unless(cl_collection_count(literals) == 4);
+	fail_unless(cl_collection_count(literals) == 3);
 
 	/* The formula should be true only for assignments
 	 * for which P, ~Q and M are all true */
 	cl_cnf_literal_t *l0 = cl_collection_get(literals, 0);
 	cl_cnf_literal_t *l1 = cl_collection_get(literals, 1);
 	cl_cnf_literal_t *l2 = cl_collection_get(literals, 2);
-	cl_cnf_literal_t *l3 = cl_collection_get(literals, 3);
 	int count = 0;
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < 8; i++) {
 		cl_cnf_literal_assign(l0, i & 0x01);
 		cl_cnf_literal_assign(l1, i & 0x02);
 		cl_cnf_literal_assign(l2, i & 0x04);
-		cl_cnf_literal_assign(l3, i & 0x08);
 
 		count += cl_cnf_evaluate(cnf) ? 1 : 0;
 	}
 
-	fail_unless(count == 2);
+	fail_unless(count == 1);
 	cl_object_release(literals);
 }
 
@@ -92,7 +93,7 @@ START_TEST(test_cnf)
 		    (cnf,
 		     cl_cnf_clause(1, cl_cnf_literal_not(cl_cnf_literal()))));
 
-	/* add ~R v ~~R */
+	/* ~R v ~~R is a tautology, which is left out */
 	cl_collection_t *clause =
 	    cl_collection_new(2, CL_OBJECT_TYPE_CNF_LITERAL, 0);
 	cl_collection_add(clause, cl_cnf_literal_not(cl_cnf_literal()));
@@ -100,13 +101,22 @@ START_TEST(test_cnf)
 			  cl_cnf_literal_not(cl_collection_check(clause)));
 	cl_collection_flag_set(clause, CL_COLLECTION_FLAG_UNIQUE);
 	fail_unless(cl_collection_count(clause) == 2);
-	fail_unless(cl_cnf_add(cnf, clause));
+	fail_unless(!cl_cnf_add(cnf, clause));
 	cl_object_release(clause);
 
 	/* add ~P v M */
 	fail_unless(cl_cnf_add
 		    (cnf, cl_cnf_clause(2, cl_cnf_literal_not(p), m)));
 
+	/* a clause of the same literals is added only once */
+	fail_unless(!cl_cnf_add(cnf, cl_cnf_clause(2, m, cl_cnf_literal_not(p))));
+
+	/* negations are represented by their duals: {P, Q, M} */
+	cl_collection_t *literals = cl_cnf_literals(cnf);
+	fail_unless(cl_collection_count(literals) == 3);
+	fail_unless(cl_collection_find(literals, 0, p) != SIZE_MAX);
+	fail_unless(cl_collection_find(literals, 0, m) != SIZE_MAX);
+
 	/* test automatic value assign */
 	cl_cnf_literal_t *notp = cl_cnf_literal_not(p);
 	cl_cnf_literal_assign(p, true);
@@ -115,6 +125,17 @@ START_TEST(test_cnf)
 	cl_cnf_literal_assign(p, false);
 	fail_unless(cl_cnf_literal_value(p) == false);
 	fail_unless(cl_cnf_literal_value(notp) == true);
+	fail_unless(!cl_cnf_literal_assign(notp, false));
+
+	/* a negation outliving its literal keeps its value */
+	cl_cnf_literal_t *q = cl_cnf_literal_new();
+	cl_cnf_literal_t *notq = cl_object_retain(cl_cnf_literal_not(q));
+	cl_cnf_literal_assign(q, true);
+	cl_object_release(q);
+	fail_unless(cl_cnf_literal_value(notq) == false);
+	fail_unless(cl_cnf_literal_assign(notq, true));
+	fail_unless(cl_cnf_literal_value(notq) == true);
+	cl_object_release(notq);
 
 	cl_object_release(p);
 	cl_object_release(m);
@@ -188,6 +209,871 @@ END_TEST START_TEST(test_printer)
 	free(expected);
 }
 
+END_TEST static cl_cnf_t *copy(cl_cnf_t * cnf)
+{
+	cl_cnf_t *res = cl_cnf();
+	for (size_t i = 0; i < cl_collection_count(cnf->_set); i++) {
+		cl_cnf_add(res, cl_collection_get(cnf->_set, i));
+	}
+
+	return res;
+}
+
+START_TEST(test_simplify)
+{
+	cl_cnf_literal_t *a = cl_cnf_literal();
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_cnf_literal_t *c = cl_cnf_literal();
+	cl_cnf_literal_t *d = cl_cnf_literal();
+	cl_collection_t *all = cl_cnf_clause(4, a, b, c, d);
+
+	/* subsumption: (A v B) ^ (A v B v C) => (A v B) */
+	cl_cnf_t *cnf = cl_cnf();
+	cl_collection_t *ab = cl_cnf_clause(2, a, b);
+	cl_cnf_add(cnf, ab);
+	cl_cnf_add(cnf, cl_cnf_clause(3, a, b, c));
+	fail_unless(cl_cnf_simplify(cnf, all));
+	fail_unless(cl_collection_count(cnf->_set) == 1);
+	fail_unless(cl_collection_get(cnf->_set, 0) == ab);
+
+	/* self-subsumption: (A v B) ^ (~A v B v C) => (A v B) ^ (B v C) */
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, ab);
+	cl_cnf_add(cnf, cl_cnf_clause(3, cl_cnf_literal_not(a), b, c));
+	fail_unless(cl_cnf_simplify(cnf, all));
+	fail_unless(cl_collection_count(cnf->_set) == 2);
+	cl_collection_t *bc = cl_collection_get(cnf->_set, 0);
+	if (bc == ab) {
+		bc = cl_collection_get(cnf->_set, 1);
+	}
+	fail_unless(cl_collection_count(bc) == 2);
+	fail_unless(cl_collection_find(bc, 0, b) != SIZE_MAX);
+	fail_unless(cl_collection_find(bc, 0, c) != SIZE_MAX);
+
+	/* units: A ^ (~A v B) ^ (~B v C v D) => A ^ B ^ (C v D) */
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(1, a));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(a), b));
+	cl_cnf_add(cnf, cl_cnf_clause(3, cl_cnf_literal_not(b), c, d));
+	fail_unless(cl_cnf_simplify(cnf, all));
+	fail_unless(cl_collection_count(cnf->_set) == 3);
+
+	/* A ^ (~A v B) ^ ~B is unsatisfiable */
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(1, a));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(a), b));
+	cl_cnf_add(cnf, cl_cnf_clause(1, cl_cnf_literal_not(b)));
+	fail_unless(!cl_cnf_simplify(cnf, NULL));
+	fail_unless(cl_sat_solve(cl_sat(), cnf) == NULL);
+
+	/* a chain of implications A => X1 => ... => Xn => B
+	 * is eliminated down to (~A v B), with the model extended back */
+	cnf = cl_cnf();
+	cl_cnf_literal_t *prev = a;
+	for (int i = 0; i < 50; i++) {
+		cl_cnf_literal_t *next = cl_cnf_literal();
+		cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(prev), next));
+		prev = next;
+	}
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(prev), b));
+	cl_cnf_t *original = copy(cnf);
+
+	fail_unless(cl_cnf_simplify(cnf, cl_cnf_clause(2, a, b)));
+	fail_unless(cl_collection_count(cnf->_set) == 1);
+	fail_unless(cl_collection_count(cl_collection_get(cnf->_set, 0)) == 2);
+	fail_unless(cl_collection_count(cl_cnf_literals(cnf)) == 52);
+
+	cl_collection_t *solution = cl_sat_solve(cl_sat(), cnf);
+	fail_unless(solution && cl_collection_count(solution) == 52);
+	fail_unless(cl_cnf_evaluate(original));
+
+	/* the model is extended whatever the assignment of A and B */
+	cl_cnf_literal_assign(a, true);
+	cl_cnf_literal_assign(b, true);
+	cl_cnf_extend(cnf);
+	fail_unless(cl_cnf_evaluate(original));
+}
+
+END_TEST START_TEST(test_simplify_random)
+{
+	srand(17);
+	size_t nvars = 30, satisfiable = 0, before = 0, after = 0;
+	cl_cnf_literal_t *vars[nvars];
+	for (size_t i = 0; i < nvars; i++) {
+		vars[i] = cl_cnf_literal();
+	}
+
+	for (int round = 0; round < 100; round++) {
+		cl_cnf_t *cnf = cl_cnf();
+		for (int i = 0; i < 60 + rand() % 60; i++) {
+			cl_collection_t *clause = cl_cnf_clause(0);
+			for (int j = 0; j < 2 + rand() % 2; j++) {
+				cl_cnf_literal_t *lit = vars[rand() % nvars];
+				cl_collection_add(clause, rand() % 2 ? lit :
+						  cl_cnf_literal_not(lit));
+			}
+			cl_cnf_add(cnf, clause);
+		}
+
+		cl_cnf_t *original = copy(cnf);
+		bool expected = cl_sat_solve(cl_sat(), original);
+
+		before += cl_collection_count(cnf->_set);
+		cl_cnf_simplify(cnf, NULL);
+		after += cl_collection_count(cnf->_set);
+
+		fail_unless((bool) cl_sat_solve(cl_sat(), cnf) == expected);
+		fail_unless(!expected || cl_cnf_evaluate(original));
+		satisfiable += expected;
+	}
+
+	fail_unless(satisfiable > 0 && satisfiable < 100);
+	fail_unless(after < before);
+}
+
+END_TEST START_TEST(test_probe)
+{
+	cl_cnf_literal_t *a = cl_cnf_literal();
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_cnf_literal_t *c = cl_cnf_literal();
+	cl_cnf_literal_t *d = cl_cnf_literal();
+
+	/* an equivalence chain A <=> X1 <=> ... <=> Xn <=> B
+	 * is substituted down to A <=> B, with the model extended back */
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_literal_t *prev = a;
+	for (int i = 0; i < 50; i++) {
+		cl_cnf_literal_t *next = cl_cnf_literal();
+		cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(prev), next));
+		cl_cnf_add(cnf, cl_cnf_clause(2, prev, cl_cnf_literal_not(next)));
+		prev = i % 2 ? next : cl_cnf_literal_not(next);
+	}
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(prev), b));
+	cl_cnf_add(cnf, cl_cnf_clause(2, prev, cl_cnf_literal_not(b)));
+	cl_cnf_add(cnf, cl_cnf_clause(3, prev, c, d));
+	cl_cnf_t *original = copy(cnf);
+
+	fail_unless(cl_cnf_probe(cnf, cl_cnf_clause(2, a, b)));
+	fail_unless(cl_collection_count(cnf->_set) == 3);
+	fail_unless(cl_collection_count(cl_cnf_literals(cnf)) == 54);
+
+	cl_collection_t *solution = cl_sat_solve(cl_sat(), cnf);
+	fail_unless(solution && cl_collection_count(solution) == 54);
+	fail_unless(cl_cnf_evaluate(original));
+
+	/* A literal equivalent to its negation */
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(a), b));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(b), c));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(c), cl_cnf_literal_not(a)));
+	cl_cnf_add(cnf, cl_cnf_clause(2, a, b));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(b), a));
+	fail_unless(!cl_cnf_probe(cnf, NULL));
+
+	/* failed literal: (~A v B) ^ (~A v C) ^ (~B v ~C v D) ^ (~B v ~D) => ~A,
+	 * and D follows from both phases of C in (C v D) ^ (~C v D) */
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(a), b));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(a), c));
+	cl_cnf_add(cnf, cl_cnf_clause(3, cl_cnf_literal_not(b),
+				      cl_cnf_literal_not(c), d));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(b),
+				      cl_cnf_literal_not(d)));
+	fail_unless(cl_cnf_probe(cnf, cl_cnf_clause(4, a, b, c, d)));
+
+	bool unit = false;
+	for (size_t i = 0; i < cl_collection_count(cnf->_set); i++) {
+		cl_collection_t *clause = cl_collection_get(cnf->_set, i);
+		unit |= cl_collection_count(clause) == 1
+		    && cl_collection_get(clause, 0) == cl_cnf_literal_not(a);
+	}
+	fail_unless(unit);
+
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, c, d));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(c), d));
+	cl_cnf_add(cnf, cl_cnf_clause(3, a, b, cl_cnf_literal_not(d)));
+	fail_unless(cl_cnf_probe(cnf, cl_cnf_clause(4, a, b, c, d)));
+	fail_unless(cl_collection_count(cnf->_set) == 2);
+}
+
+END_TEST START_TEST(test_probe_random)
+{
+	srand(23);
+	size_t nvars = 30, satisfiable = 0;
+	cl_cnf_literal_t *vars[nvars];
+	for (size_t i = 0; i < nvars; i++) {
+		vars[i] = cl_cnf_literal();
+	}
+
+	for (int round = 0; round < 100; round++) {
+		cl_cnf_t *cnf = cl_cnf();
+		for (int i = 0; i < 40 + rand() % 60; i++) {
+			cl_collection_t *clause = cl_cnf_clause(0);
+			for (int j = 0; j < 2 + rand() % 2; j++) {
+				cl_cnf_literal_t *lit = vars[rand() % nvars];
+				cl_collection_add(clause, rand() % 2 ? lit :
+						  cl_cnf_literal_not(lit));
+			}
+			cl_cnf_add(cnf, clause);
+		}
+
+		cl_cnf_t *original = copy(cnf);
+		bool expected = cl_sat_solve(cl_sat(), original);
+
+		cl_cnf_probe(cnf, NULL);
+		cl_cnf_simplify(cnf, NULL);
+
+		fail_unless((bool) cl_sat_solve(cl_sat(), cnf) == expected);
+		fail_unless(!expected || cl_cnf_evaluate(original));
+		satisfiable += expected;
+	}
+
+	fail_unless(satisfiable > 0 && satisfiable < 100);
+}
+
+END_TEST START_TEST(test_xor)
+{
+	cl_cnf_literal_t *a = cl_cnf_literal();
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_cnf_literal_t *c = cl_cnf_literal();
+
+	/* A + ~B + C + C = A + B + 1 */
+	cl_cnf_t *cnf = cl_cnf();
+	cl_collection_t *literals =
+	    cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+			  CL_COLLECTION_FLAG_AUTORESIZE);
+	cl_collection_add(literals, a);
+	cl_collection_add(literals, cl_cnf_literal_not(b));
+	cl_collection_add(literals, c);
+	cl_collection_add(literals, c);
+	fail_unless(cl_cnf_add_xor(cnf, literals));
+	fail_unless(cl_collection_count(cnf->_xors) == 1);
+	fail_unless(cl_collection_count(cl_cnf_literals(cnf)) == 2);
+
+	for (int i = 0; i < 4; i++) {
+		cl_cnf_literal_assign(a, i & 1);
+		cl_cnf_literal_assign(b, i & 2);
+		fail_unless(cl_cnf_evaluate(cnf) == ((i & 1) == !!(i & 2)));
+	}
+
+	/* A + ~A is always true */
+	fail_unless(!cl_cnf_add_xor(cnf, cl_cnf_clause(2, a,
+						       cl_cnf_literal_not(a))));
+
+	/* (P <=> Q) + ~R */
+	int data[3][2] = { {1, 0}, {2, 0}, {3, 0} };
+	cl_proposition_t *p = cl_proposition(&is_grater_than, data[0]);
+	cl_proposition_t *q = cl_proposition(&is_grater_than, data[1]);
+	cl_proposition_t *r = cl_proposition(&is_grater_than, data[2]);
+	cl_collection_t *atoms = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					       CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf();
+	fail_unless(cl_cnf_add_proposition_xor
+		    (cnf, cl_proposition_xor(cl_proposition_equivalent(p, q),
+					     cl_proposition_not(r)), atoms));
+	fail_unless(cl_collection_count(atoms) == 3);
+	fail_unless(!cl_cnf_add_proposition_xor
+		    (cnf, cl_proposition_and(p, q), atoms));
+
+	for (int i = 0; i < 8; i++) {
+		for (int j = 0; j < 3; j++) {
+			cl_cnf_literal_assign(cl_collection_get(atoms, j),
+					      i >> j & 1);
+		}
+		fail_unless(cl_cnf_evaluate(cnf) == ((i & 1) + (i >> 1 & 1)
+						     + (i >> 2 & 1)) % 2);
+	}
+
+	/* the atoms bound already are reused */
+	fail_unless(cl_cnf_add_proposition_xor(cnf, cl_proposition_xor(q, r),
+					       atoms));
+	fail_unless(cl_collection_count(atoms) == 3);
+
+	/* the 4 clauses of A + B + C = 1 */
+	cnf = cl_cnf();
+	cl_cnf_literal_t *na = cl_cnf_literal_not(a);
+	cl_cnf_literal_t *nb = cl_cnf_literal_not(b);
+	cl_cnf_literal_t *nc = cl_cnf_literal_not(c);
+	cl_collection_t *abc = cl_cnf_clause(3, a, b, c);
+	cl_cnf_add(cnf, abc);
+	cl_cnf_add(cnf, cl_cnf_clause(3, a, nb, nc));
+	cl_cnf_add(cnf, cl_cnf_clause(3, na, b, nc));
+	cl_cnf_add(cnf, cl_cnf_clause(3, na, nb, c));
+	cl_cnf_add(cnf, cl_cnf_clause(2, a, b));
+	cl_cnf_t *original = copy(cnf);
+
+	fail_unless(cl_cnf_detect_xors(cnf) == 1);
+	fail_unless(cl_collection_count(cnf->_set) == 1);
+	fail_unless(cl_collection_count(cnf->_xors) == 1);
+
+	for (int i = 0; i < 8; i++) {
+		cl_cnf_literal_assign(a, i & 1);
+		cl_cnf_literal_assign(b, i & 2);
+		cl_cnf_literal_assign(c, i & 4);
+		fail_unless(cl_cnf_evaluate(cnf) == cl_cnf_evaluate(original));
+	}
+
+	/* an incomplete set of clauses is left alone */
+	cnf = copy(original);
+	cl_cnf_remove(cnf, abc);
+	fail_unless(cl_cnf_detect_xors(cnf) == 0);
+}
+
+END_TEST START_TEST(test_cards)
+{
+	cl_cnf_literal_t *vars[4];
+	cl_collection_t *literals =
+	    cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+			  CL_COLLECTION_FLAG_AUTORESIZE);
+	for (int i = 0; i < 4; i++) {
+		vars[i] = cl_cnf_literal();
+		cl_collection_add(literals, vars[i]);
+	}
+
+	cl_cnf_t *at_most = cl_cnf();
+	cl_cnf_t *at_least = cl_cnf();
+	fail_unless(cl_cnf_add_at_most(at_most, literals, 2));
+	fail_unless(cl_cnf_add_at_least(at_least, literals, 3));
+	fail_unless(cl_collection_count(cl_cnf_literals(at_most)) == 4);
+
+	for (int i = 0; i < 16; i++) {
+		int count = 0;
+		for (int j = 0; j < 4; j++) {
+			cl_cnf_literal_assign(vars[j], i >> j & 1);
+			count += i >> j & 1;
+		}
+		fail_unless(cl_cnf_evaluate(at_most) == (count <= 2));
+		fail_unless(cl_cnf_evaluate(at_least) == (count >= 3));
+	}
+
+	/* the bounds no assignment can exceed */
+	fail_unless(!cl_cnf_add_at_most(at_most, literals, 4));
+	fail_unless(!cl_cnf_add_at_least(at_most, literals, 0));
+	fail_unless(cl_collection_count(at_most->_cards) == 1);
+
+	/* A + ~A + B <= 1 leaves B false */
+	cl_cnf_t *cnf = cl_cnf();
+	fail_unless(cl_cnf_add_at_most(cnf, cl_cnf_clause(3, vars[0],
+							  cl_cnf_literal_not
+							  (vars[0]), vars[1]),
+				       1));
+	for (int i = 0; i < 4; i++) {
+		cl_cnf_literal_assign(vars[0], i & 1);
+		cl_cnf_literal_assign(vars[1], i & 2);
+		fail_unless(cl_cnf_evaluate(cnf) == !(i & 2));
+	}
+
+	/* A + ~A <= 0 can't be satisfied */
+	cnf = cl_cnf();
+	cl_cnf_add_at_most(cnf, cl_cnf_clause(2, vars[0],
+					      cl_cnf_literal_not(vars[0])), 0);
+	fail_unless(cl_collection_count(cnf->_set) == 1);
+	fail_unless(cl_collection_count(cl_collection_get(cnf->_set, 0)) == 0);
+
+	/* the encodings replace the constraints by clauses */
+	cl_cnf_encoding_t encodings[] = {
+		CL_CNF_ENCODING_SEQUENTIAL, CL_CNF_ENCODING_TOTALIZER
+	};
+	for (int i = 0; i < 2; i++) {
+		cnf = cl_cnf();
+		cl_cnf_add_at_most(cnf, literals, 2);
+		fail_unless(cl_cnf_encode_cards(cnf, encodings[i]) > 0);
+		fail_unless(cl_collection_count(cnf->_cards) == 0);
+		fail_unless(cl_collection_count(cl_cnf_literals(cnf)) > 4);
+	}
+}
+
+END_TEST START_TEST(test_generators)
+{
+	cl_collection_t *vars1 = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					       CL_COLLECTION_FLAG_AUTORESIZE);
+	cl_collection_t *vars2 = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					       CL_COLLECTION_FLAG_AUTORESIZE);
+
+	cl_cnf_t *cnf = cl_cnf_random(50, 4.26, 3, 7, vars1);
+	fail_unless(cl_collection_count(vars1) == 50);
+	fail_unless(cl_collection_count(cnf->_set) == 213);
+	for (size_t i = 0; i < 213; i++) {
+		fail_unless(cl_collection_count
+			    (cl_collection_get(cnf->_set, i)) == 3);
+	}
+
+	/* the same seed gives the same formula, and another seed a different one */
+	cl_cnf_t *cnf1 = cl_cnf_random(10, 1, 3, 7, vars2);
+	cl_cnf_t *cnf2 = cl_cnf_random(10, 1, 3, 7, vars2);
+	cl_cnf_t *cnf3 = cl_cnf_random(10, 1, 3, 8, vars2);
+	srand(1);
+	bool different = false;
+	for (int i = 0; i < 100; i++) {
+		for (size_t j = 0; j < 10; j++) {
+			bool value = rand() % 2;
+			for (size_t k = 0; k < 3; k++) {
+				cl_cnf_literal_assign(cl_collection_get
+						      (vars2, k * 10 + j),
+						      value);
+			}
+		}
+		fail_unless(cl_cnf_evaluate(cnf1) == cl_cnf_evaluate(cnf2));
+		different |= cl_cnf_evaluate(cnf1) != cl_cnf_evaluate(cnf3);
+	}
+	fail_unless(different);
+
+	/* planted formulas are satisfied by the assignment left behind */
+	for (uint64_t seed = 0; seed < 10; seed++) {
+		fail_unless(cl_cnf_evaluate(cl_cnf_planted(100, 6, 3, seed,
+							   NULL)));
+	}
+	fail_unless(cl_sat_solve(cl_sat(), cl_cnf_planted(100, 6, 3, 1, NULL))
+		    != NULL);
+
+	/* pigeons * 1 + holes * pigeons * (pigeons - 1) / 2 clauses */
+	cnf = cl_cnf_pigeonhole(5, 4, NULL);
+	fail_unless(cl_collection_count(cnf->_set) == 45);
+	fail_unless(cl_sat_solve(cl_sat(), cnf) == NULL);
+	fail_unless(cl_sat_solve(cl_sat(), cl_cnf_pigeonhole(4, 4, NULL)));
+
+	/* nodes * (1 + colors * (colors - 1) / 2) + edges * colors clauses */
+	cnf = cl_cnf_coloring(20, 30, 3, 1, NULL);
+	fail_unless(cl_collection_count(cnf->_set) == 170);
+	fail_unless(cl_sat_solve(cl_sat(), cnf) != NULL);
+	fail_unless(cl_sat_solve(cl_sat(), cl_cnf_coloring(20, 400, 3, 1,
+							   NULL)) == NULL);
+
+	/* two chains of nvars - 1 XORs of 4 clauses, and a unit clause */
+	cnf = cl_cnf_parity(10, true, 1, vars1);
+	fail_unless(cl_collection_count(cnf->_set) == 74);
+	fail_unless(cl_sat_solve(cl_sat(), cnf) != NULL);
+	cnf = cl_cnf_parity(10, false, 1, NULL);
+	fail_unless(cl_sat_solve(cl_sat(), copy(cnf)) == NULL);
+	fail_unless(cl_cnf_detect_xors(cnf) == 18);
+	fail_unless(cl_sat_solve(cl_sat(), cnf) == NULL);
+}
+
+END_TEST START_TEST(test_count_models)
+{
+	cl_cnf_literal_t *a = cl_cnf_literal();
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, a, b));
+	fail_unless(cl_cnf_count_models(cnf, NULL, NULL) == 3);
+	fail_unless(cl_cnf_count_models(cl_cnf_pigeonhole(3, 2, NULL), NULL,
+					NULL) == 0);
+
+	/* the models agree with the evaluation of every assignment,
+	 * with some of the variables constant over the blocks of words */
+	size_t sizes[] = { 3, 7, 13, 15 };
+	uint64_t table[(1 << 15) / 64];
+	for (size_t s = 0; s < 4; s++) {
+		size_t n = sizes[s];
+		cl_collection_t *vars =
+		    cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+				  CL_COLLECTION_FLAG_AUTORESIZE);
+		cnf = cl_cnf_random(n, 1.5, 3, s, vars);
+
+		cl_collection_t *xor = cl_collection(0,
+						     CL_OBJECT_TYPE_CNF_LITERAL,
+						     CL_COLLECTION_FLAG_AUTORESIZE);
+		cl_collection_t *card =
+		    cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+				  CL_COLLECTION_FLAG_AUTORESIZE);
+		for (size_t i = 0; i < n; i++) {
+			cl_cnf_literal_t *lit = cl_collection_get(vars, i);
+			cl_collection_add(i % 2 ? xor : card, i % 3 ? lit :
+					  cl_cnf_literal_not(lit));
+		}
+		cl_collection_add(card, cl_collection_get(vars, n - 1));
+		cl_cnf_add_xor(cnf, xor);
+		cl_cnf_add_at_most(cnf, card, cl_collection_count(card) / 2);
+
+		/* the values of the literals are left alone */
+		cl_cnf_literal_assign(cl_collection_get(vars, 0), true);
+		uint64_t models = cl_cnf_count_models(cnf, vars, table);
+		fail_unless(cl_cnf_literal_value(cl_collection_get(vars, 0)));
+
+		uint64_t count = 0;
+		for (size_t i = 0; i < (size_t)1 << n; i++) {
+			for (size_t j = 0; j < n; j++) {
+				cl_cnf_literal_assign(cl_collection_get(vars, j),
+						      i >> j & 1);
+			}
+			bool value = cl_cnf_evaluate(cnf);
+			fail_unless((table[i / 64] >> (i % 64) & 1) == value);
+			count += value;
+		}
+		fail_unless(models == count);
+		fail_unless(models > 0);
+	}
+}
+
+END_TEST START_TEST(test_evaluate_batch)
+{
+	/* more than 64 variables take more than a word per assignment */
+	cl_collection_t *vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	cl_cnf_t *cnf = cl_cnf_random(100, 0.2, 3, 1, vars);
+	cl_collection_t *xor = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	for (size_t i = 0; i < 100; i += 7) {
+		cl_collection_add(xor, cl_collection_get(vars, i));
+	}
+	cl_cnf_add_xor(cnf, xor);
+	cl_cnf_add_at_most(cnf, xor, 8);
+
+	size_t count = 3000;
+	uint64_t *assignments = malloc(count * 2 * sizeof(uint64_t));
+	uint64_t satisfied[(3000 + 63) / 64];
+	uint64_t satisfied1[(3000 + 63) / 64];
+	size_t *unsatisfied = malloc(count * sizeof(size_t));
+	srand(1);
+	for (size_t i = 0; i < count * 2; i++) {
+		assignments[i] = (uint64_t) rand() << 48 ^
+		    (uint64_t) rand() << 24 ^ rand();
+	}
+
+	cl_cnf_literal_assign(cl_collection_get(vars, 0), true);
+	size_t models = cl_cnf_evaluate_batch(cnf, vars, assignments, count,
+					      satisfied, unsatisfied, 4);
+	fail_unless(cl_cnf_literal_value(cl_collection_get(vars, 0)));
+	fail_unless(cl_cnf_evaluate_batch(cnf, vars, assignments, count,
+					  satisfied1, NULL, 1) == models);
+	fail_unless(models > 0 && models < count);
+
+	size_t expected = 0;
+	for (size_t r = 0; r < count; r++) {
+		for (size_t j = 0; j < 100; j++) {
+			cl_cnf_literal_assign(cl_collection_get(vars, j),
+					      assignments[r * 2 + j / 64] >>
+					      (j % 64) & 1);
+		}
+
+		/* count the falsified clauses and constraints one by one */
+		size_t falsified = 0;
+		for (size_t i = 0; i < cl_collection_count(cnf->_set); i++) {
+			cl_cnf_t *single = cl_cnf();
+			cl_cnf_add(single, cl_collection_get(cnf->_set, i));
+			falsified += !cl_cnf_evaluate(single);
+		}
+		cl_cnf_t *single = cl_cnf();
+		cl_cnf_add_xor(single, xor);
+		falsified += !cl_cnf_evaluate(single);
+		single = cl_cnf();
+		cl_cnf_add_at_most(single, xor, 8);
+		falsified += !cl_cnf_evaluate(single);
+
+		bool value = cl_cnf_evaluate(cnf);
+		fail_unless((satisfied[r / 64] >> (r % 64) & 1) == value);
+		fail_unless((satisfied1[r / 64] >> (r % 64) & 1) == value);
+		fail_unless(unsatisfied[r] == falsified);
+		expected += value;
+	}
+	fail_unless(models == expected);
+
+	free(assignments);
+	free(unsatisfied);
+}
+
+END_TEST static void check_occurrences(cl_cnf_t * cnf, cl_collection_t * vars)
+{
+	cl_cnf_compact(cnf);
+	for (size_t i = 0; i < cl_collection_count(vars); i++) {
+		for (int n = 0; n < 2; n++) {
+			cl_cnf_literal_t *lit = cl_collection_get(vars, i);
+			lit = n ? cl_cnf_literal_not(lit) : lit;
+
+			size_t count = 0;
+			for (size_t j = 0; j < cl_collection_count(cnf->_set); j++) {
+				cl_collection_t *clause =
+				    cl_collection_get(cnf->_set, j);
+				count += cl_collection_find(clause, 0, lit)
+				    != SIZE_MAX;
+			}
+
+			fail_unless(cl_cnf_occurrences(cnf, lit) == count);
+			for (size_t j = 0; j < count; j++) {
+				cl_collection_t *clause =
+				    cl_cnf_occurrence(cnf, lit, j);
+				fail_unless(cl_collection_find(cnf->_set, 0,
+							       clause) !=
+					    SIZE_MAX);
+				fail_unless(cl_collection_find(clause, 0, lit)
+					    != SIZE_MAX);
+			}
+			fail_unless(cl_cnf_occurrence(cnf, lit, count) == NULL);
+		}
+	}
+}
+
+START_TEST(test_occurrences)
+{
+	cl_collection_t *vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	cl_cnf_t *cnf = cl_cnf_random(200, 4, 3, 1, vars);
+	check_occurrences(cnf, vars);
+
+	/* the index follows the clauses added */
+	cl_cnf_literal_t *a = cl_collection_get(vars, 0);
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_collection_add(vars, b);
+	size_t count = cl_cnf_occurrences(cnf, a);
+	cl_collection_t *clause = cl_cnf_clause(2, a, b);
+	cl_cnf_add(cnf, clause);
+	fail_unless(cl_cnf_occurrences(cnf, a) == count + 1);
+	fail_unless(cl_cnf_occurrences(cnf, b) == 1);
+	fail_unless(cl_cnf_occurrence(cnf, b, 0) == clause);
+	fail_unless(!cl_cnf_add(cnf, clause));
+	fail_unless(cl_cnf_occurrences(cnf, a) == count + 1);
+	check_occurrences(cnf, vars);
+
+	/* and is rebuilt when they get replaced */
+	fail_unless(cl_cnf_simplify(cnf, vars));
+	check_occurrences(cnf, vars);
+
+	/* the clauses replaced by the XORs are removed from it */
+	vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+			     CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf_parity(10, true, 1, vars);
+	fail_unless(cl_cnf_occurrences(cnf, cl_collection_get(vars, 0)) > 0);
+	fail_unless(cl_cnf_detect_xors(cnf) == 18);
+	fail_unless(cl_cnf_occurrences(cnf, cl_collection_get(vars, 0)) == 0);
+	check_occurrences(cnf, vars);
+}
+
+END_TEST static bool has_literal(cl_collection_t * clause, void *data)
+{
+	return cl_collection_find(clause, 0, data) != SIZE_MAX;
+}
+
+START_TEST(test_remove)
+{
+	cl_collection_t *vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	cl_cnf_t *cnf = cl_cnf_random(100, 4, 3, 1, vars);
+	cl_cnf_literal_t *a = cl_collection_get(vars, 0);
+	cl_cnf_literal_t *b = cl_collection_get(vars, 1);
+
+	/* only the clauses of the formula get removed, and only once */
+	cl_collection_t *clause = cl_cnf_clause(2, a, b);
+	fail_unless(!cl_cnf_remove(cnf, clause));
+	fail_unless(cl_cnf_add(cnf, clause));
+	size_t count = cl_cnf_occurrences(cnf, a);
+	fail_unless(cl_cnf_remove(cnf, clause));
+	fail_unless(!cl_cnf_remove(cnf, clause));
+	fail_unless(cl_cnf_occurrences(cnf, a) == count - 1);
+
+	/* a removed clause can be added back */
+	fail_unless(cl_cnf_add(cnf, clause));
+	fail_unless(!cl_cnf_add(cnf, clause));
+	fail_unless(cl_cnf_occurrences(cnf, a) == count);
+	fail_unless(cl_collection_find(cnf->_set, 0, clause) != SIZE_MAX);
+
+	/* in any order */
+	cl_collection_t *removed = cl_collection(150, CL_OBJECT_TYPE_COLLECTION, 0);
+	for (size_t i = 0; i < 150; i++) {
+		cl_collection_add(removed, cl_collection_get(cnf->_set, i));
+		fail_unless(cl_cnf_remove(cnf, cl_collection_get(removed, i)));
+	}
+	for (size_t i = 0; i < 300; i++) {
+		size_t j = (i * 7) % 150;
+		fail_unless(cl_cnf_add(cnf, cl_collection_get(removed, j)) ==
+			    (i < 150));
+	}
+	fail_unless(cnf->_removed.count == 0);
+	check_occurrences(cnf, vars);
+
+	fail_unless(cl_cnf_remove_if(cnf, &has_literal, a) == count);
+	fail_unless(cl_cnf_occurrences(cnf, a) == 0);
+	fail_unless(cl_cnf_remove_if(cnf, &has_literal, a) == 0);
+	check_occurrences(cnf, vars);
+
+	/* the formula follows the removed clauses */
+	cl_collection_t *holes = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					       CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf_pigeonhole(5, 4, holes);
+	fail_unless(cl_sat_solve(cl_sat(), cnf) == NULL);
+	clause = cl_cnf_occurrence(cnf, cl_collection_get(holes, 0), 0);
+	fail_unless(cl_cnf_remove(cnf, clause));
+	fail_unless(cl_sat_solve(cl_sat(), cnf) != NULL);
+	fail_unless(cl_cnf_add(cnf, clause));
+	fail_unless(cl_sat_solve(cl_sat(), cnf) == NULL);
+
+	/* and keeps its storage bounded across many updates */
+	cnf = cl_cnf_random(100, 4, 3, 1, NULL);
+	size_t capacity = cnf->_set->_capacity;
+	for (size_t i = 0; i < 10000; i++) {
+		cl_collection_t *c = cl_cnf_clause(2, a, b);
+		cl_cnf_add(cnf, c);
+		fail_unless(cl_cnf_remove(cnf, c));
+	}
+	fail_unless(cnf->_set->_capacity <= 2 * capacity);
+	fail_unless(cnf->_removed.count < cl_collection_count(cnf->_set));
+	cl_cnf_compact(cnf);
+	fail_unless(cl_collection_count(cnf->_set) == 400);
+	fail_unless(cnf->_removed.count == 0);
+}
+
+END_TEST START_TEST(test_duplicates)
+{
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_literal_t *a = cl_cnf_literal();
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_cnf_literal_t *c = cl_cnf_literal();
+
+	/* the clauses are told apart by their literals, in any order */
+	cl_collection_t *abc = cl_cnf_clause(3, a, b, cl_cnf_literal_not(c));
+	cl_collection_t *cba = cl_cnf_clause(3, cl_cnf_literal_not(c), b, a);
+	fail_unless(cl_cnf_add(cnf, abc));
+	fail_unless(!cl_cnf_add(cnf, cba));
+	fail_unless(cl_cnf_add(cnf, cl_cnf_clause(2, a, b)));
+	fail_unless(!cl_cnf_add(cnf, cl_cnf_clause(2, b, a)));
+	fail_unless(cl_cnf_add(cnf, cl_cnf_clause(0)));
+	fail_unless(!cl_cnf_add(cnf, cl_cnf_clause(0)));
+	fail_unless(cl_cnf_add(cnf, cl_cnf_clause(3, a, b, c)));
+	fail_unless(cl_collection_count(cnf->_set) == 4);
+
+	/* tautologies are left out */
+	fail_unless(!cl_cnf_add(cnf, cl_cnf_clause(3, a, cl_cnf_literal_not(a),
+						   c)));
+	fail_unless(cl_collection_count(cnf->_set) == 4);
+
+	/* a removed clause leaves the place to another one */
+	fail_unless(cl_cnf_remove(cnf, abc));
+	fail_unless(cl_cnf_add(cnf, cba));
+	fail_unless(!cl_cnf_add(cnf, abc));
+	cl_cnf_compact(cnf);
+	fail_unless(cl_collection_count(cnf->_set) == 4);
+
+	/* the generated encodings carry no duplicates */
+	cnf = cl_cnf_coloring(10, 200, 3, 1, NULL);
+	cl_collection_t *set = cnf->_set;
+	for (size_t i = 0; i < cl_collection_count(set); i++) {
+		cl_collection_t *x = cl_collection_get(set, i);
+		for (size_t j = 0; j < i; j++) {
+			cl_collection_t *y = cl_collection_get(set, j);
+			fail_unless(cl_collection_count(x) !=
+				    cl_collection_count(y)
+				    || memcmp(x->_buffer, y->_buffer,
+					      x->_count * sizeof(void *)));
+		}
+	}
+	fail_unless(cl_collection_count(set) < 10 * 4 + 200 * 3);
+
+	/* neither do the simplified formulas, with all the variables frozen */
+	cl_collection_t *vars = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	cnf = cl_cnf_random(50, 2, 3, 1, vars);
+	fail_unless(cl_cnf_simplify(cnf, vars));
+	fail_unless(cl_collection_count(cnf->_set) > 0);
+	cl_collection_t *clause = cl_collection_get(cnf->_set, 0);
+	cl_collection_t *same = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	for (size_t i = cl_collection_count(clause); i > 0; i--) {
+		cl_collection_add(same, cl_collection_get(clause, i - 1));
+	}
+	fail_unless(!cl_cnf_add(cnf, same));
+}
+
+END_TEST START_TEST(test_components)
+{
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_literal_t *vars[8];
+	for (size_t i = 0; i < 8; i++) {
+		vars[i] = cl_cnf_literal();
+	}
+
+	/* {0, 1, 2} by the clauses, {3, 4} by an XOR, {5, 6} by a cardinality
+	 * constraint, and 7 by nothing but a tautology */
+	cl_cnf_add(cnf, cl_cnf_clause(2, vars[0], cl_cnf_literal_not(vars[1])));
+	cl_cnf_add(cnf, cl_cnf_clause(2, vars[2], vars[1]));
+	cl_cnf_add(cnf, cl_cnf_clause(1, vars[3]));
+	cl_cnf_add_xor(cnf, cl_cnf_clause(2, vars[3], vars[4]));
+	cl_cnf_add_at_most(cnf, cl_cnf_clause(2, vars[5], vars[6]), 1);
+	cl_cnf_add(cnf, cl_cnf_clause(2, vars[7], cl_cnf_literal_not(vars[7])));
+
+	cl_collection_t *components = cl_cnf_components(cnf);
+	fail_unless(cl_collection_count(components) == 3);
+
+	cl_cnf_t *first = cl_collection_get(components, 0);
+	fail_unless(cl_collection_count(first->_set) == 2);
+	fail_unless(cl_collection_count(cl_cnf_literals(first)) == 3);
+
+	cl_cnf_t *second = cl_collection_get(components, 1);
+	fail_unless(cl_collection_count(second->_set) == 1);
+	fail_unless(cl_collection_count(second->_xors) == 1);
+	fail_unless(cl_collection_count(cl_cnf_literals(second)) == 2);
+
+	cl_cnf_t *third = cl_collection_get(components, 2);
+	fail_unless(cl_collection_count(third->_set) == 0);
+	fail_unless(cl_collection_count(third->_cards) == 1);
+	fail_unless(third->_bounds[0] == 1);
+
+	/* the constraints without literals go first */
+	cl_cnf_add(cnf, cl_cnf_clause(0));
+	components = cl_cnf_components(cnf);
+	fail_unless(cl_collection_count(components) == 4);
+	first = cl_collection_get(components, 0);
+	fail_unless(cl_collection_count(first->_set) == 1);
+	fail_unless(cl_collection_count(cl_cnf_literals(first)) == 0);
+
+	/* the components of a random formula share no variables,
+	 * and make up all of its clauses */
+	cnf = cl_cnf_random(200, 0.1, 3, 1, NULL);
+	components = cl_cnf_components(cnf);
+	fail_unless(cl_collection_count(components) > 1);
+
+	size_t clauses = 0, variables = 0;
+	cl_collection_t *all = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					     CL_COLLECTION_FLAG_UNIQUE |
+					     CL_COLLECTION_FLAG_AUTORESIZE);
+	for (size_t i = 0; i < cl_collection_count(components); i++) {
+		cl_cnf_t *component = cl_collection_get(components, i);
+		cl_collection_t *literals = cl_cnf_literals(component);
+		clauses += cl_collection_count(component->_set);
+		variables += cl_collection_count(literals);
+		for (size_t j = 0; j < cl_collection_count(literals); j++) {
+			cl_collection_add(all, cl_collection_get(literals, j));
+		}
+	}
+	fail_unless(clauses == cl_collection_count(cnf->_set));
+	fail_unless(variables == cl_collection_count(all));
+	fail_unless(variables == cl_collection_count(cl_cnf_literals(cnf)));
+}
+
+END_TEST START_TEST(test_evaluate)
+{
+	/* CNF: (P v ~Q) */
+	cl_cnf_literal_t *p = cl_cnf_literal();
+	cl_cnf_literal_t *q = cl_cnf_literal_new();
+	cl_cnf_literal_t *notq = cl_cnf_literal_not(q);
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, p, notq));
+	fail_unless(cl_cnf_evaluate(cnf));
+
+	/* the clauses added after an evaluation are picked up */
+	cl_collection_t *unit = cl_cnf_clause(1, p);
+	cl_cnf_add(cnf, unit);
+	fail_if(cl_cnf_evaluate(cnf));
+	cl_cnf_literal_assign(p, true);
+	fail_unless(cl_cnf_evaluate(cnf));
+
+	/* and the ones removed are left out */
+	cl_cnf_literal_assign(p, false);
+	fail_unless(cl_cnf_remove(cnf, unit));
+	fail_unless(cl_cnf_evaluate(cnf));
+	cl_cnf_literal_assign(q, true);
+	fail_if(cl_cnf_evaluate(cnf));
+
+	/* a negation outliving its literal is a literal of its own */
+	cl_object_release(q);
+	fail_if(cl_cnf_evaluate(cnf));
+	fail_unless(cl_cnf_literal_assign(notq, true));
+	fail_unless(cl_cnf_evaluate(cnf));
+
+	/* the empty clause is never satisfied */
+	cl_cnf_add(cnf, cl_cnf_clause(0));
+	fail_if(cl_cnf_evaluate(cnf));
+}
+
 END_TEST Suite *test_suite(void)
 {
 	Suite *s = suite_create("TEST CNF");
@@ -196,6 +1082,20 @@ END_TEST Suite *test_suite(void)
 	tcase_add_checked_fixture(tc_core, setup, teardown);
 	tcase_add_test(tc_core, test_cnf);
 	tcase_add_test(tc_core, test_printer);
+	tcase_add_test(tc_core, test_simplify);
+	tcase_add_test(tc_core, test_simplify_random);
+	tcase_add_test(tc_core, test_probe);
+	tcase_add_test(tc_core, test_probe_random);
+	tcase_add_test(tc_core, test_xor);
+	tcase_add_test(tc_core, test_cards);
+	tcase_add_test(tc_core, test_generators);
+	tcase_add_test(tc_core, test_count_models);
+	tcase_add_test(tc_core, test_evaluate_batch);
+	tcase_add_test(tc_core, test_occurrences);
+	tcase_add_test(tc_core, test_remove);
+	tcase_add_test(tc_core, test_duplicates);
+	tcase_add_test(tc_core, test_components);
+	tcase_add_test(tc_core, test_evaluate);
 	//tcase_add_test(tc_core, test_cnf_proposition);
 	suite_add_tcase(s, tc_core);
 
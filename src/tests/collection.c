@@ -115,6 +115,14 @@ START_TEST(test_array)
 	fail_unless(cl_collection_remove(arr, obj[0]) == 2);
 	fail_unless(cl_collection_remove(arr, obj[0]) == 0);
 	fail_unless(cl_collection_remove(arr, obj[2]) == 1);
+
+	/* removing the last reference to the object */
+	cl_object_t *last = cl_object_new(sizeof(cl_object_t),
+					  CL_OBJECT_TYPE_OBJECT, NULL, NULL);
+	cl_collection_add(arr, last);
+	cl_object_release(last);
+	fail_unless(cl_collection_remove(arr, last) == 1);
+
 	cl_collection_delete(arr, 0);
 	fail_unless(arr->_chunk_size == 3);
 	fail_unless(cl_collection_capacity(arr) == 3);
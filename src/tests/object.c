@@ -118,6 +118,40 @@ END_TEST START_TEST(test_object_management)
 	fail_unless(destructor_called);
 }
 
+END_TEST START_TEST(test_object_stream)
+{
+	cl_object_t *obj =
+	    cl_object(sizeof(cl_object_t), CL_OBJECT_TYPE_OBJECT, NULL, NULL);
+	char expected[32];
+	sprintf(expected, "%p", obj);
+
+	/* buffer stream, growing past the initial capacity */
+	cl_object_stream_t stream;
+	cl_object_stream_buffer(&stream);
+	for (int i = 0; i < 100; i++) {
+		cl_object_write(obj, &stream);
+		cl_object_stream_printf(&stream, " %d ", i);
+		cl_object_stream_puts(&stream, "|");
+	}
+
+	char *str = cl_object_stream_finish(&stream);
+	fail_unless(stream.buffer == NULL);
+	fail_unless(strncmp(str, expected, strlen(expected)) == 0);
+	fail_unless(strstr(str, " 99 |") == str + strlen(str) - 5);
+	free(str);
+
+	/* file stream */
+	FILE *file = tmpfile();
+	fail_if(file == NULL);
+	cl_object_print(obj, file);
+	rewind(file);
+
+	char buffer[32];
+	fail_unless(fgets(buffer, sizeof(buffer), file) != NULL);
+	fail_unless(strcmp(buffer, expected) == 0);
+	fclose(file);
+}
+
 END_TEST Suite *test_suite(void)
 {
 	Suite *s = suite_create("TEST OBJECT");
@@ -127,6 +161,7 @@ END_TEST Suite *test_suite(void)
 	tcase_add_test_raise_signal(tc_core, test_object_assert_size, SIGABRT);
 	tcase_add_test(tc_core, test_object_management);
 	tcase_add_test(tc_core, test_object_comparator);
+	tcase_add_test(tc_core, test_object_stream);
 	suite_add_tcase(s, tc_core);
 
 	return s;
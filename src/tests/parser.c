@@ -0,0 +1,214 @@
+/*
+ *   Copyright (C) 2011  Pece Milosev
+ *
+ *   This file is part of 'clumsy'.
+ *   'clumsy' is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   'clumsy' is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../clumsy.h"
+#include "../cl_parser_rep.h"
+
+static bool is_grater_than(cl_proposition_t * proposition)
+{
+	cl_proposition_context_t *ctx = cl_proposition_get_context(proposition);
+
+	int *data = (int *)(ctx->argv[0]);
+	return data[0] > data[1];
+}
+
+static void check_print(cl_parser_t * parser, const char *text,
+			const char *expected)
+{
+	cl_proposition_t *p = cl_parser_parse(parser, text);
+	fail_if(p == NULL);
+
+	char *str = cl_object_to_string(p);
+	fail_unless(strcmp(str, expected) == 0);
+	free(str);
+}
+
+void setup()
+{
+	cl_object_pool_push();
+}
+
+void teardown()
+{
+	cl_object_pool_pop();
+}
+
+START_TEST(test_parse)
+{
+	cl_parser_t *parser = cl_parser();
+
+	/* the printer syntax */
+	check_print(parser, "TRUE", "TRUE");
+	check_print(parser, "~FALSE", "~FALSE");
+	check_print(parser, "(P ^ Q)", "(P ^ Q)");
+	check_print(parser, "((P v ~Q) => (R <=> TRUE))",
+		    "((P v ~Q) => (R <=> TRUE))");
+	check_print(parser, "(var_1 + v2)", "(var_1 + v2)");
+
+	/* precedence and associativity
+	 * NOTE: the operands of AND and OR are ordered by depth */
+	check_print(parser, "P ^ Q v R", "(R v (P ^ Q))");
+	check_print(parser, "P v Q ^ R", "(P v (Q ^ R))");
+	check_print(parser, "P => Q => R", "(P => (Q => R))");
+	check_print(parser, "P <=> Q <=> R", "((P <=> Q) <=> R)");
+	check_print(parser, "~P ^ Q + R", "((Q ^ ~P) + R)");
+
+	/* the names are shared */
+	cl_proposition_t *p = cl_parser_parse(parser, " P ");
+	fail_unless(p == cl_parser_symbol(parser, "P"));
+	cl_proposition_context_t *ctx =
+	    cl_proposition_get_context(cl_parser_parse(parser, "(P ^ P)"));
+	fail_unless(ctx->argv[0] == p);
+	fail_unless(ctx->argv[1] == p);
+
+	/* evaluation */
+	cl_proposition_t *f = cl_parser_parse(parser, "(P => Q) ^ (Q => P)");
+	fail_unless(cl_proposition_eval(f));
+	fail_unless(cl_parser_assign(parser, "P", true));
+	fail_if(cl_proposition_eval(f));
+	fail_unless(cl_parser_assign(parser, "Q", true));
+	fail_unless(cl_proposition_eval(f));
+
+	/* bindings */
+	int data[2] = { 2, 1 };
+	cl_proposition_t *gt = cl_proposition(&is_grater_than, &data);
+	fail_unless(cl_parser_bind(parser, "GT", gt));
+	fail_if(cl_parser_bind(parser, "GT", gt));
+	fail_if(cl_parser_bind(parser, "P", gt));
+	fail_if(cl_parser_assign(parser, "GT", true));
+
+	f = cl_parser_parse(parser, "GT ^ ~R");
+	fail_unless(cl_proposition_get_context(f)->argv[0] == gt);
+	fail_unless(cl_proposition_eval(f));
+	data[0] = 0;
+	fail_if(cl_proposition_eval(f));
+}
+
+END_TEST START_TEST(test_errors)
+{
+	cl_parser_t *parser = cl_parser();
+	fail_unless(cl_parser_error(parser) == SIZE_MAX);
+
+	fail_unless(cl_parser_parse(parser, "(P ^ Q") == NULL);
+	fail_unless(cl_parser_error(parser) == 6);
+
+	fail_unless(cl_parser_parse(parser, "P Q") == NULL);
+	fail_unless(cl_parser_error(parser) == 2);
+
+	fail_unless(cl_parser_parse(parser, "P = Q") == NULL);
+	fail_unless(cl_parser_error(parser) == 2);
+
+	fail_unless(cl_parser_parse(parser, "P ^ v") == NULL);
+	fail_unless(cl_parser_error(parser) == 4);
+
+	fail_unless(cl_parser_parse(parser, "") == NULL);
+	fail_unless(cl_parser_error(parser) == 0);
+
+	fail_unless(cl_parser_parse(parser, "P; Q") == NULL);
+	fail_unless(cl_parser_error(parser) == 1);
+
+	fail_unless(cl_parser_parse_all(parser, "P\nQ R") == NULL);
+	fail_unless(cl_parser_error(parser) == 4);
+
+	fail_unless(cl_parser_parse(parser, "P") != NULL);
+	fail_unless(cl_parser_error(parser) == SIZE_MAX);
+}
+
+END_TEST START_TEST(test_parse_all)
+{
+	cl_parser_t *parser = cl_parser();
+
+	cl_collection_t *rules =
+	    cl_parser_parse_all(parser, "P ^ Q; Q v R\n\n~P;;\n(P ^\n Q)\n");
+	fail_if(rules == NULL);
+	fail_unless(cl_collection_count(rules) == 4);
+
+	char *str = cl_object_to_string(rules);
+	fail_unless(strcmp(str, "{(P ^ Q), (Q v R), ~P, (P ^ Q)}") == 0);
+	free(str);
+
+	/* a lot of rules */
+	cl_object_stream_t stream;
+	cl_object_stream_buffer(&stream);
+	for (int i = 0; i < 10000; i++) {
+		cl_object_stream_printf(&stream, "(x%d ^ ~x%d) => y%d\n", i,
+					i + 1, i % 100);
+	}
+
+	char *text = cl_object_stream_finish(&stream);
+	rules = cl_parser_parse_all(parser, text);
+	free(text);
+
+	fail_if(rules == NULL);
+	fail_unless(cl_collection_count(rules) == 10000);
+	fail_unless(parser->_count == 3 + 10001 + 100);
+}
+
+END_TEST START_TEST(test_zone)
+{
+	cl_parser_t *parser = cl_parser_new();
+	cl_proposition_t *f =
+	    cl_object_retain(cl_parser_parse(parser, "(A ^ ~B) v C"));
+	fail_unless(cl_parser_assign(parser, "C", true));
+
+	/* all the propositions are allocated from the parser's zone */
+	cl_object_t *obj = (cl_object_t *) f;
+	fail_unless(obj->_obj_info._zone == parser->_zone);
+	obj = cl_proposition_get_context(f)->argv[0];
+	fail_unless(obj->_obj_info._zone == parser->_zone);
+
+	/* and they outlive the parser */
+	cl_object_release(parser);
+	fail_unless(cl_proposition_eval(f));
+
+	char *str = cl_object_to_string(f);
+	fail_unless(strcmp(str, "(C v (A ^ ~B))") == 0);
+	free(str);
+
+	cl_object_release(f);
+}
+
+END_TEST Suite *test_suite(void)
+{
+	Suite *s = suite_create("TEST PARSER");
+
+	TCase *tc_core = tcase_create("TEST_PARSER");
+	tcase_add_checked_fixture(tc_core, setup, teardown);
+	tcase_add_test(tc_core, test_parse);
+	tcase_add_test(tc_core, test_errors);
+	tcase_add_test(tc_core, test_parse_all);
+	tcase_add_test(tc_core, test_zone);
+	suite_add_tcase(s, tc_core);
+
+	return s;
+}
+
+int main(void)
+{
+	int number_failed;
+	Suite *s = test_suite();
+	SRunner *sr = srunner_create(s);
+	srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -471,6 +471,133 @@ END_TEST START_TEST(test_printer)
 	free(str);
 }
 
+END_TEST START_TEST(test_simplify)
+{
+	int data[3][2] = { {0, 0}, {0, 0}, {0, 0} };
+	cl_proposition_t *p = cl_proposition(&is_grater_than, &data[0]);
+	cl_proposition_t *q = cl_proposition(&is_grater_than, &data[1]);
+	cl_proposition_t *r = cl_proposition(&is_grater_than, &data[2]);
+	size_t before = 0;
+	size_t after = 0;
+
+	/* ~~P ^ TRUE == P */
+	cl_proposition_t *f =
+	    cl_proposition_and(cl_proposition_not(cl_proposition_not(p)),
+			       cl_proposition_true());
+	fail_unless(cl_proposition_simplify(f, &before, &after) == p);
+	fail_unless(before == 5);
+	fail_unless(after == 1);
+
+	/* P ^ (P v Q) == P */
+	f = cl_proposition_and(p, cl_proposition_or(p, q));
+	fail_unless(cl_proposition_simplify(f, NULL, NULL) == p);
+
+	/* P ^ ~P == FALSE */
+	f = cl_proposition_and(p, cl_proposition_not(p));
+	char *str = cl_object_to_string(cl_proposition_simplify(f, NULL, NULL));
+	fail_unless(strcmp(str, "FALSE") == 0);
+	free(str);
+
+	/* (FALSE => Q) <=> R == R */
+	f = cl_proposition_equivalent(cl_proposition_imply
+				      (cl_proposition_false(), q), r);
+	fail_unless(cl_proposition_simplify(f, NULL, NULL) == r);
+
+	/* ~(P v Q) == ~P ^ ~Q */
+	f = cl_proposition_simplify(cl_proposition_nor(p, q), NULL, NULL);
+	cl_proposition_context_t *ctx = cl_proposition_get_context(f);
+	fail_unless(ctx->op == &cl_proposition_and_op);
+	fail_unless(cl_proposition_get_context(ctx->argv[0])->op ==
+		    &cl_proposition_not_op);
+	fail_unless(cl_proposition_get_context(ctx->argv[1])->op ==
+		    &cl_proposition_not_op);
+
+	/* the simplified formula should be equivalent to the original */
+	f = cl_proposition_or(cl_proposition_nand
+			      (cl_proposition_xor(p, cl_proposition_not(q)),
+			       cl_proposition_nimply(r, cl_proposition_true())),
+			      cl_proposition_nor(cl_proposition_and(q, r),
+						 cl_proposition_equivalent(p,
+									   cl_proposition_false
+									   ())));
+	cl_proposition_t *s = cl_proposition_simplify(f, &before, &after);
+	fail_unless(after < before);
+	for (int i = 0; i < 8; i++) {
+		data[0][0] = i & 0x01;
+		data[1][0] = (i & 0x02) >> 1;
+		data[2][0] = (i & 0x04) >> 2;
+
+		fail_unless(cl_proposition_eval(f) == cl_proposition_eval(s));
+	}
+}
+
+END_TEST START_TEST(test_balance)
+{
+	int data[3][2] = { {1, 0}, {1, 0}, {1, 0} };
+	cl_proposition_t *atoms[3];
+	for (int i = 0; i < 3; i++) {
+		atoms[i] = cl_proposition(&is_grater_than, &data[i]);
+	}
+
+	/* fold a long conjunction, and a long parity chain */
+	cl_proposition_t *conj = cl_proposition_true();
+	cl_proposition_t *parity = cl_proposition_false();
+	for (int i = 0; i < 10000; i++) {
+		conj = cl_proposition_and(conj, atoms[i % 3]);
+		parity = cl_proposition_xor(parity, atoms[i % 3]);
+	}
+	fail_unless(cl_proposition_depth(conj) == 10000);
+
+	cl_proposition_t *f = cl_proposition_balance(conj);
+	fail_unless(cl_proposition_depth(f) == 14);
+	fail_unless(cl_proposition_size(f) == cl_proposition_size(conj));
+	fail_unless(cl_proposition_eval(f));
+	data[1][0] = 0;
+	fail_if(cl_proposition_eval(f));
+
+	/* 3334 + 3333 + 3333 terms, only the last two have odd count */
+	cl_proposition_t *g = cl_proposition_balance(parity);
+	fail_unless(cl_proposition_depth(g) == 14);
+	for (int i = 0; i < 8; i++) {
+		data[0][0] = i & 0x01;
+		data[1][0] = (i & 0x02) >> 1;
+		data[2][0] = (i & 0x04) >> 2;
+
+		fail_unless(cl_proposition_eval(g) == (data[1][0] != data[2][0]));
+	}
+
+	/* a chain folded from the left, under 10 levels of one folded
+	 * from the right, which the stack holds all at once */
+	cl_proposition_t *nested = atoms[0];
+	for (int i = 1; i < 12; i++) {
+		nested = cl_proposition_xor(nested, atoms[i % 3]);
+	}
+	for (int i = 0; i < 10; i++) {
+		nested = cl_proposition_xor(atoms[i % 3], nested);
+	}
+
+	g = cl_proposition_balance(nested);
+	fail_unless(cl_proposition_depth(g) == 5);
+	for (int i = 0; i < 8; i++) {
+		data[0][0] = i & 0x01;
+		data[1][0] = (i & 0x02) >> 1;
+		data[2][0] = (i & 0x04) >> 2;
+
+		fail_unless(cl_proposition_eval(g) ==
+			    cl_proposition_eval(nested));
+	}
+
+	/* balanced propositions are returned as they are */
+	fail_unless(cl_proposition_balance(g) == g);
+	fail_unless(cl_proposition_balance(atoms[0]) == atoms[0]);
+
+	/* runs of negations are collapsed */
+	f = cl_proposition_not(cl_proposition_not(cl_proposition_not(atoms[0])));
+	g = cl_proposition_balance(f);
+	fail_unless(cl_proposition_depth(g) == 1);
+	fail_unless(cl_proposition_get_context(g)->argv[0] == atoms[0]);
+}
+
 END_TEST Suite *test_suite(void)
 {
 	Suite *s = suite_create("TEST PROPOSITIONS");
@@ -480,6 +607,8 @@ END_TEST Suite *test_suite(void)
 	tcase_add_test(tc_core, test_atomic_proposition);
 	tcase_add_test(tc_core, test_complex_proposition);
 	tcase_add_test(tc_core, test_printer);
+	tcase_add_test(tc_core, test_simplify);
+	tcase_add_test(tc_core, test_balance);
 	suite_add_tcase(s, tc_core);
 
 	return s;
@@ -18,8 +18,10 @@
 
 #include <check.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../clumsy.h"
 #include "../cl_sat_rep.h"
+#include "../cl_cnf_rep.h"
 
 void setup()
 {
@@ -47,6 +49,697 @@ START_TEST(test_sat)
 	fail_unless(cl_cnf_evaluate(cnf) == ((bool) sollution));
 }
 
+END_TEST static cl_cnf_t *pigeonhole(size_t holes)
+{
+	/* literal p[i][j] means pigeon i sits in hole j */
+	size_t pigeons = holes + 1;
+	cl_cnf_literal_t *p[pigeons][holes];
+	cl_cnf_t *cnf = cl_cnf();
+
+	for (size_t i = 0; i < pigeons; i++) {
+		cl_collection_t *clause = cl_cnf_clause(0);
+		for (size_t j = 0; j < holes; j++) {
+			p[i][j] = cl_cnf_literal();
+			cl_collection_add(clause, p[i][j]);
+		}
+		cl_cnf_add(cnf, clause);
+	}
+
+	for (size_t j = 0; j < holes; j++) {
+		for (size_t i = 0; i < pigeons; i++) {
+			for (size_t k = i + 1; k < pigeons; k++) {
+				cl_cnf_add(cnf,
+					   cl_cnf_clause(2,
+							 cl_cnf_literal_not
+							 (p[i][j]),
+							 cl_cnf_literal_not
+							 (p[k][j])));
+			}
+		}
+	}
+
+	return cnf;
+}
+
+static cl_cnf_t *random_cnf(size_t nvars, size_t nclauses, size_t k)
+{
+	cl_cnf_literal_t *vars[nvars];
+	for (size_t i = 0; i < nvars; i++) {
+		vars[i] = cl_cnf_literal();
+	}
+
+	cl_cnf_t *cnf = cl_cnf();
+	for (size_t i = 0; i < nclauses; i++) {
+		cl_collection_t *clause = cl_cnf_clause(0);
+		for (size_t j = 0; j < k; j++) {
+			cl_cnf_literal_t *lit = vars[rand() % nvars];
+			cl_collection_add(clause,
+					  rand() % 2 ? lit :
+					  cl_cnf_literal_not(lit));
+		}
+		cl_cnf_add(cnf, clause);
+	}
+
+	return cnf;
+}
+
+START_TEST(test_unsat)
+{
+	/* CNF: P ^ ~P */
+	cl_cnf_literal_t *p = cl_cnf_literal();
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(1, p));
+	cl_cnf_add(cnf, cl_cnf_clause(1, cl_cnf_literal_not(p)));
+
+	cl_sat_t *sat = cl_sat();
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+
+	/* CNF: (P v Q) ^ (~P v Q) ^ (P v ~Q) ^ (~P v ~Q) */
+	cl_cnf_literal_t *q = cl_cnf_literal();
+	cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, p, q));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(p), q));
+	cl_cnf_add(cnf, cl_cnf_clause(2, p, cl_cnf_literal_not(q)));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(p),
+				      cl_cnf_literal_not(q)));
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+
+	/* the pigeons don't fit */
+	fail_unless(cl_sat_solve(sat, pigeonhole(5)) == NULL);
+	cl_sat_heuristic_set(sat, CL_SAT_HEURISTIC_RANDOM);
+	fail_unless(cl_sat_solve(sat, pigeonhole(4)) == NULL);
+}
+
+END_TEST START_TEST(test_heuristic)
+{
+	cl_sat_t *vsids = cl_sat();
+	cl_sat_t *random = cl_sat();
+	cl_sat_heuristic_set(random, CL_SAT_HEURISTIC_RANDOM);
+
+	srand(42);
+	size_t satisfiable = 0;
+	for (int i = 0; i < 20; i++) {
+		/* near the threshold, about half of these are satisfiable */
+		cl_cnf_t *cnf = random_cnf(40, 170, 3);
+
+		cl_collection_t *solution = cl_sat_solve(vsids, cnf);
+		fail_unless(!solution || cl_cnf_evaluate(cnf));
+
+		cl_collection_t *other = cl_sat_solve(random, cnf);
+		fail_unless(!other || cl_cnf_evaluate(cnf));
+
+		fail_unless((bool) solution == (bool) other);
+		satisfiable += (bool) solution;
+	}
+
+	fail_unless(satisfiable > 0 && satisfiable < 20);
+
+	/* an easy, larger, formula */
+	cl_cnf_t *cnf = random_cnf(300, 900, 3);
+	fail_unless(cl_sat_solve(vsids, cnf) && cl_cnf_evaluate(cnf));
+}
+
+END_TEST START_TEST(test_phases)
+{
+	srand(7);
+	cl_cnf_t *cnf = random_cnf(200, 800, 3);
+	cl_sat_t *sat = cl_sat();
+	fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+
+	/* the model is saved as the phases, so there's nothing left to learn */
+	size_t conflicts = sat->_conflicts;
+	fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+	fail_unless(sat->_conflicts == conflicts);
+
+	/* frequent rephasing must not affect the outcome */
+	cl_sat_t *reference = cl_sat();
+	sat = cl_sat();
+	sat->_rephase_interval = 3;
+	for (int i = 0; i < 20; i++) {
+		cnf = random_cnf(50, 213, 3);
+
+		cl_collection_t *solution = cl_sat_solve(sat, cnf);
+		fail_unless(!solution || cl_cnf_evaluate(cnf));
+		fail_unless((bool) solution ==
+			    (bool) cl_sat_solve(reference, cnf));
+	}
+
+	/* an easy formula is solved by the local search alone */
+	sat = cl_sat();
+	sat->_maxflips = 100000;
+	cnf = random_cnf(100, 300, 3);
+	fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+	fail_unless(sat->_conflicts == 0);
+}
+
+END_TEST START_TEST(test_restarts)
+{
+	cl_sat_t *sat = cl_sat();
+	cl_sat_restart_set(sat, CL_SAT_RESTART_NONE);
+	fail_unless(cl_sat_solve(sat, pigeonhole(6)) == NULL);
+	fail_unless(sat->_conflicts > 0 && sat->_restarts == 0);
+
+	/* restarts and reductions don't keep the search from completing */
+	cl_sat_restart_set(sat, CL_SAT_RESTART_LUBY);
+	sat->_luby_unit = 1;
+	sat->_reduce_interval = 20;
+	fail_unless(cl_sat_solve(sat, pigeonhole(6)) == NULL);
+	fail_unless(sat->_restarts > 0 && sat->_reductions > 0);
+	fail_unless(sat->_learnts.size < sat->_conflicts);
+
+	cl_sat_t *reference = cl_sat();
+	cl_sat_restart_set(reference, CL_SAT_RESTART_NONE);
+	cl_sat_t *glucose = cl_sat();
+	glucose->_reduce_interval = 20;
+
+	srand(11);
+	for (int i = 0; i < 20; i++) {
+		cl_cnf_t *cnf = random_cnf(60, 256, 3);
+		bool expected = cl_sat_solve(reference, cnf);
+
+		fail_unless((bool) cl_sat_solve(sat, cnf) == expected);
+		fail_unless(!expected || cl_cnf_evaluate(cnf));
+
+		fail_unless((bool) cl_sat_solve(glucose, cnf) == expected);
+		fail_unless(!expected || cl_cnf_evaluate(cnf));
+	}
+}
+
+END_TEST static cl_cnf_t *with_units(cl_cnf_t * cnf, cl_collection_t * units)
+{
+	cl_cnf_t *res = cl_cnf();
+	for (size_t i = 0; i < cl_collection_count(cnf->_set); i++) {
+		cl_cnf_add(res, cl_collection_get(cnf->_set, i));
+	}
+
+	for (size_t i = 0; i < cl_collection_count(units); i++) {
+		cl_cnf_add(res, cl_cnf_clause(1, cl_collection_get(units, i)));
+	}
+
+	return res;
+}
+
+START_TEST(test_incremental)
+{
+	/* CNF: (~A v B) ^ (~B v C) */
+	cl_cnf_literal_t *a = cl_cnf_literal();
+	cl_cnf_literal_t *b = cl_cnf_literal();
+	cl_cnf_literal_t *c = cl_cnf_literal();
+	cl_cnf_literal_t *d = cl_cnf_literal();
+	cl_cnf_t *cnf = cl_cnf();
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(a), b));
+	cl_cnf_add(cnf, cl_cnf_clause(2, cl_cnf_literal_not(b), c));
+
+	cl_sat_t *sat = cl_sat();
+	cl_collection_t *assumptions =
+	    cl_cnf_clause(3, d, a, cl_cnf_literal_not(c));
+	fail_unless(cl_sat_solve_assuming(sat, cnf, assumptions) == NULL);
+
+	/* D has nothing to do with it */
+	cl_collection_t *failed = cl_sat_failed(sat);
+	fail_unless(cl_collection_count(failed) == 2);
+	fail_unless(cl_collection_find(failed, 0, a) != SIZE_MAX);
+	fail_unless(cl_collection_find(failed, 0, cl_cnf_literal_not(c))
+		    != SIZE_MAX);
+
+	/* the formula itself is fine */
+	fail_unless(cl_sat_solve(sat, cnf) != NULL);
+	fail_unless(cl_collection_count(cl_sat_failed(sat)) == 0);
+	fail_unless(cl_sat_solve_assuming(sat, cnf, cl_cnf_clause(1, a)));
+	fail_unless(cl_cnf_literal_value(c));
+
+	/* the assumptions hold, D being in no clause of the formula */
+	fail_unless(cl_sat_solve_assuming(sat, cnf, cl_cnf_clause(1, d)));
+	fail_unless(cl_cnf_literal_value(d));
+	fail_unless(cl_sat_solve_assuming(sat, cnf,
+					  cl_cnf_clause(2, a,
+							cl_cnf_literal_not
+							(d))));
+	fail_unless(!cl_cnf_literal_value(d) && cl_cnf_literal_value(c));
+
+	/* clauses added in between are picked up */
+	cl_cnf_add(cnf, cl_cnf_clause(1, cl_cnf_literal_not(c)));
+	fail_unless(cl_sat_solve_assuming(sat, cnf, cl_cnf_clause(1, a))
+		    == NULL);
+	failed = cl_sat_failed(sat);
+	fail_unless(cl_collection_count(failed) == 1);
+	fail_unless(cl_collection_get(failed, 0) == a);
+	fail_unless(cl_sat_solve(sat, cnf) && !cl_cnf_literal_value(a));
+
+	/* unsatisfiable on its own */
+	cl_collection_t *unit = cl_cnf_clause(1, c);
+	cl_cnf_add(cnf, unit);
+	fail_unless(cl_sat_solve_assuming(sat, cnf, cl_cnf_clause(1, d))
+		    == NULL);
+	fail_unless(cl_collection_count(cl_sat_failed(sat)) == 0);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+
+	/* until a clause is removed, and again once it is back */
+	fail_unless(cl_cnf_remove(cnf, unit));
+	fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+	fail_unless(cl_sat_solve(sat, cnf) != NULL);
+	fail_unless(cl_cnf_add(cnf, unit));
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+
+	/* many queries against the same formula */
+	srand(5);
+	size_t nvars = 40;
+	cl_cnf_literal_t *vars[nvars];
+	cnf = cl_cnf();
+	for (size_t i = 0; i < nvars; i++) {
+		vars[i] = cl_cnf_literal();
+	}
+
+	for (size_t i = 0; i < 150; i++) {
+		cl_collection_t *clause = cl_cnf_clause(0);
+		for (size_t j = 0; j < 3; j++) {
+			cl_cnf_literal_t *lit = vars[rand() % nvars];
+			cl_collection_add(clause, rand() % 2 ? lit :
+					  cl_cnf_literal_not(lit));
+		}
+		cl_cnf_add(cnf, clause);
+	}
+
+	sat = cl_sat();
+	size_t unsatisfiable = 0;
+	for (int i = 0; i < 50; i++) {
+		assumptions = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					    CL_COLLECTION_FLAG_AUTORESIZE);
+		for (int j = 0; j < 6; j++) {
+			cl_cnf_literal_t *lit = vars[rand() % nvars];
+			cl_collection_add(assumptions, rand() % 2 ? lit :
+					  cl_cnf_literal_not(lit));
+		}
+
+		cl_collection_t *solution =
+		    cl_sat_solve_assuming(sat, cnf, assumptions);
+		cl_cnf_t *expected = with_units(cnf, assumptions);
+		fail_unless((bool) solution ==
+			    (bool) cl_sat_solve(cl_sat(), expected));
+
+		if (solution) {
+			fail_unless(cl_sat_solve_assuming
+				    (sat, cnf, assumptions)
+				    && cl_cnf_evaluate(expected));
+		} else {
+			/* the failed assumptions alone are enough */
+			failed = cl_sat_failed(sat);
+			fail_unless(cl_collection_count(failed) > 0);
+			fail_unless(cl_sat_solve
+				    (cl_sat(), with_units(cnf, failed)) == NULL);
+			unsatisfiable++;
+		}
+	}
+
+	fail_unless(unsatisfiable > 0 && unsatisfiable < 50);
+}
+
+END_TEST START_TEST(test_xor)
+{
+	/* a random system of 3 variable XOR constraints
+	 * below the satisfiability threshold, with clauses on top */
+	srand(13);
+	size_t nvars = 200;
+	cl_cnf_literal_t *vars[nvars];
+	cl_cnf_t *cnf = cl_cnf();
+	for (size_t i = 0; i < nvars; i++) {
+		vars[i] = cl_cnf_literal();
+	}
+
+	for (size_t i = 0; i < 160; i++) {
+		cl_collection_t *xor = cl_cnf_clause(0);
+		while (cl_collection_count(xor) < 3) {
+			cl_collection_add(xor, vars[rand() % nvars]);
+		}
+
+		if (rand() % 2) {
+			cl_cnf_literal_t *lit = cl_collection_get(xor, 0);
+			cl_collection_delete(xor, 0);
+			cl_collection_add(xor, cl_cnf_literal_not(lit));
+		}
+		cl_cnf_add_xor(cnf, xor);
+	}
+
+	for (size_t i = 0; i < 40; i++) {
+		cl_cnf_add(cnf, cl_cnf_clause(2, vars[rand() % nvars],
+					      vars[rand() % nvars]));
+	}
+
+	cl_sat_t *sat = cl_sat();
+	fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+
+	/* the sum of all the constraints over a chain X1 + X2, X2 + X3, ...
+	 * contradicts X1 + Xn */
+	cnf = cl_cnf();
+	for (size_t i = 0; i + 1 < nvars; i++) {
+		cl_cnf_add_xor(cnf, cl_cnf_clause(2, vars[i], vars[i + 1]));
+	}
+	cl_cnf_add_xor(cnf, cl_cnf_clause(2, vars[0],
+					   cl_cnf_literal_not(vars[nvars - 1])));
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+
+	/* the assumptions propagate through the constraints */
+	cnf = cl_cnf();
+	for (size_t i = 0; i + 1 < nvars; i++) {
+		cl_cnf_add_xor(cnf, cl_cnf_clause(2, vars[i], vars[i + 1]));
+	}
+	fail_unless(cl_sat_solve_assuming(sat, cnf,
+					  cl_cnf_clause(1, vars[0])));
+	fail_unless(cl_cnf_evaluate(cnf) && !cl_cnf_literal_value(vars[1]));
+	fail_unless(!cl_sat_solve_assuming(sat, cnf, cl_cnf_clause(2,
+								   vars[0],
+								   cl_cnf_literal_not
+								   (vars[2]))));
+	fail_unless(cl_collection_count(cl_sat_failed(sat)) == 2);
+}
+
+END_TEST START_TEST(test_cards)
+{
+	/* 12 tasks in 4 slots of 3, some tasks kept apart */
+	srand(17);
+	cl_cnf_literal_t *tasks[12][4];
+	cl_cnf_t *cnf = cl_cnf();
+	for (size_t t = 0; t < 12; t++) {
+		cl_collection_t *slots = cl_cnf_clause(0);
+		for (size_t s = 0; s < 4; s++) {
+			tasks[t][s] = cl_cnf_literal();
+			cl_collection_add(slots, tasks[t][s]);
+		}
+		cl_cnf_add(cnf, slots);
+		cl_cnf_add_at_most(cnf, slots, 1);
+	}
+
+	for (size_t s = 0; s < 4; s++) {
+		cl_collection_t *slot = cl_cnf_clause(0);
+		for (size_t t = 0; t < 12; t++) {
+			cl_collection_add(slot, tasks[t][s]);
+		}
+		cl_cnf_add_at_most(cnf, slot, 3);
+	}
+
+	for (size_t i = 0; i < 8; i++) {
+		size_t a = rand() % 12;
+		size_t b = (a + 1 + rand() % 11) % 12;
+		for (size_t s = 0; s < 4; s++) {
+			cl_cnf_add(cnf, cl_cnf_clause(2,
+						      cl_cnf_literal_not
+						      (tasks[a][s]),
+						      cl_cnf_literal_not
+						      (tasks[b][s])));
+		}
+	}
+
+	cl_sat_t *sat = cl_sat();
+	fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+
+	/* one task too many */
+	cl_collection_t *slots = cl_cnf_clause(0);
+	for (size_t s = 0; s < 4; s++) {
+		cl_collection_add(slots, cl_cnf_literal());
+	}
+	cl_cnf_add(cnf, slots);
+	cl_cnf_add_at_most(cnf, slots, 1);
+	for (size_t s = 0; s < 4; s++) {
+		cl_collection_t *slot = cl_cnf_clause(0);
+		for (size_t t = 0; t < 12; t++) {
+			cl_collection_add(slot, tasks[t][s]);
+		}
+		cl_collection_add(slot, cl_collection_get(slots, s));
+		cl_cnf_add_at_most(cnf, slot, 3);
+	}
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+
+	/* the assumptions propagate through the constraints,
+	 * natively and encoded */
+	cl_collection_t *literals = cl_cnf_clause(0);
+	for (size_t i = 0; i < 5; i++) {
+		cl_collection_add(literals, tasks[0][i % 4]);
+	}
+	cl_collection_add(literals, tasks[1][0]);
+	cl_collection_t *two = cl_cnf_clause(2, tasks[0][0], tasks[0][1]);
+	cl_collection_t *three = cl_cnf_clause(3, tasks[0][1], tasks[0][2],
+					       tasks[1][0]);
+
+	cl_cnf_encoding_t encodings[] = {
+		CL_CNF_ENCODING_SEQUENTIAL, CL_CNF_ENCODING_TOTALIZER
+	};
+	for (int i = 0; i < 3; i++) {
+		cnf = cl_cnf();
+		cl_cnf_add_at_most(cnf, literals, 2);
+		if (i) {
+			cl_cnf_encode_cards(cnf, encodings[i - 1]);
+		}
+
+		fail_unless(cl_sat_solve_assuming(sat, cnf, two));
+		fail_unless(cl_cnf_evaluate(cnf)
+			    && !cl_cnf_literal_value(tasks[1][0]));
+		fail_unless(!cl_sat_solve_assuming(sat, cnf, three));
+		fail_unless(cl_collection_count(cl_sat_failed(sat)) == 3);
+	}
+}
+
+END_TEST static bool count_progress(cl_sat_t * sat, const cl_sat_progress_t * progress,
+			   void *data)
+{
+	size_t *calls = data;
+	fail_unless(progress->conflicts >= calls[1]);
+	calls[1] = progress->conflicts;
+
+	/* stop at the third call */
+	return ++calls[0] < 3;
+}
+
+START_TEST(test_budgets)
+{
+	/* far too many conflicts to be refuted within the budgets */
+	cl_cnf_t *cnf = pigeonhole(11);
+	cl_sat_t *sat = cl_sat();
+	cl_sat_restart_set(sat, CL_SAT_RESTART_NONE);
+
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_CONFLICTS, 100);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_CONFLICTS);
+	fail_unless(sat->_conflicts == 100);
+
+	/* the budgets are counted per call */
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(sat->_conflicts == 200);
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_CONFLICTS, 0);
+
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_PROPAGATIONS, 1000);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_PROPAGATIONS);
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_PROPAGATIONS, 0);
+
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_MEMORY, 1);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_MEMORY);
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_MEMORY, 0);
+
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_TIME, 50);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_TIME);
+
+	/* the callback sees the counters grow, and stops the call */
+	size_t calls[2] = { 0, 0 };
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_TIME, 0);
+	cl_sat_progress_set(sat, &count_progress, calls, 0);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_INTERRUPT);
+	fail_unless(calls[0] == 3);
+	cl_sat_progress_set(sat, NULL, NULL, 0);
+
+	/* an interrupt outside of a call stops the next one only */
+	cl_sat_interrupt(sat);
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_CONFLICTS, 10);
+	size_t conflicts = sat->_conflicts;
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_INTERRUPT);
+	fail_unless(sat->_conflicts == conflicts);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_CONFLICTS);
+
+	/* a definite answer within the budgets */
+	cnf = pigeonhole(3);
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_CONFLICTS, 1000);
+	fail_unless(cl_sat_solve(sat, cnf) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_NONE);
+}
+
+END_TEST START_TEST(test_seed)
+{
+	/* solvers seeded alike make the same random choices */
+	srand(5);
+	cl_cnf_t *cnf = random_cnf(100, 400, 3);
+	cl_collection_t *literals = cl_cnf_literals(cnf);
+	size_t n = cl_collection_count(literals);
+	bool values[n];
+
+	for (int i = 0; i < 2; i++) {
+		cl_sat_t *sat = cl_sat();
+		cl_sat_heuristic_set(sat, CL_SAT_HEURISTIC_RANDOM);
+		cl_sat_seed(sat, 7, 1);
+		sat->_maxflips = 100;
+		fail_unless(cl_sat_solve(sat, cnf) && cl_cnf_evaluate(cnf));
+
+		for (size_t j = 0; j < n; j++) {
+			bool value =
+			    cl_cnf_literal_value(cl_collection_get(literals, j));
+			fail_unless(i == 0 || values[j] == value);
+			values[j] = value;
+		}
+	}
+
+	/* the streams of a seed are different */
+	cl_sat_t *first = cl_sat();
+	cl_sat_t *second = cl_sat();
+	cl_sat_seed(first, 7, 0);
+	cl_sat_seed(second, 7, 1);
+	fail_unless(memcmp(first->_random, second->_random,
+			   sizeof(first->_random)));
+}
+
+END_TEST START_TEST(test_stats)
+{
+	srand(9);
+	cl_sat_t *sat = cl_sat();
+	sat->_maxflips = 500;
+	fail_unless(cl_sat_solve(sat, pigeonhole(6)) == NULL);
+	fail_unless(cl_sat_solve(sat, random_cnf(50, 200, 3)) != NULL);
+
+	cl_sat_stats_t stats;
+	cl_sat_stats(sat, &stats);
+	fail_unless(stats.conflicts > 0 && stats.decisions > 0);
+	fail_unless(stats.propagations >= stats.decisions);
+
+#ifndef CL_SAT_NO_STATISTICS
+	/* the pigeons are walked over in vain, every conflict learns a clause,
+	 * and the counters of the first formula are kept */
+	fail_unless(stats.solves == 2);
+	fail_unless(stats.flips >= 500);
+	fail_unless(stats.learnt == stats.conflicts);
+	fail_unless(stats.peak_memory > 0);
+	fail_unless(stats.conflicts > sat->_conflicts);
+#endif
+
+	cl_object_stream_t stream;
+	cl_object_stream_buffer(&stream);
+	cl_sat_stats_write(sat, &stream);
+	char *json = cl_object_stream_finish(&stream);
+	fail_unless(json[0] == '{' && strstr(json, "\"conflicts\": "));
+	free(json);
+}
+
+END_TEST static void add_all(cl_cnf_t * cnf, cl_cnf_t * part)
+{
+	for (size_t i = 0; i < cl_collection_count(part->_set); i++) {
+		cl_cnf_add(cnf, cl_collection_get(part->_set, i));
+	}
+}
+
+START_TEST(test_components)
+{
+	/* independent formulas, each one satisfiable */
+	cl_cnf_t *cnf = cl_cnf();
+	for (size_t i = 0; i < 8; i++) {
+		add_all(cnf, cl_cnf_planted(100, 4, 3, i, NULL));
+	}
+
+	cl_sat_t *sat = cl_sat();
+	cl_collection_t *model = cl_sat_solve_components(sat, cnf, 0);
+	fail_unless(model && cl_cnf_evaluate(cnf));
+	fail_unless(cl_collection_count(model) == 800);
+#ifndef CL_SAT_NO_STATISTICS
+	cl_sat_stats_t stats;
+	cl_sat_stats(sat, &stats);
+	fail_unless(stats.solves == 1 && stats.decisions > 0);
+#endif
+
+	/* on any number of threads */
+	fail_unless(cl_sat_solve_components(sat, cnf, 1) && cl_cnf_evaluate(cnf));
+	fail_unless(cl_sat_solve_components(sat, cnf, 3) && cl_cnf_evaluate(cnf));
+
+	/* a component without a model leaves the formula without one */
+	add_all(cnf, pigeonhole(6));
+	fail_unless(cl_sat_solve_components(sat, cnf, 0) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_NONE);
+	fail_unless(cl_sat_solve_components(sat, cnf, 1) == NULL);
+
+	/* and a budget running out, undecided */
+	cnf = cl_cnf();
+	add_all(cnf, cl_cnf_planted(100, 4, 3, 1, NULL));
+	add_all(cnf, pigeonhole(11));
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_CONFLICTS, 100);
+	fail_unless(cl_sat_solve_components(sat, cnf, 0) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_CONFLICTS);
+	cl_sat_budget_set(sat, CL_SAT_BUDGET_CONFLICTS, 0);
+
+	/* the XOR and the cardinality constraints are kept,
+	 * and the eliminated literals are recovered */
+	cl_cnf_t *parity = cl_cnf_parity(20, true, 1, NULL);
+	cl_cnf_t *planted = cl_cnf_planted(100, 3, 3, 2, NULL);
+	cnf = cl_cnf();
+	add_all(cnf, parity);
+	fail_unless(cl_cnf_detect_xors(cnf) > 0);
+	add_all(cnf, planted);
+	fail_unless(cl_cnf_simplify(cnf, NULL));
+
+	cl_collection_t *card = cl_collection(0, CL_OBJECT_TYPE_CNF_LITERAL,
+					      CL_COLLECTION_FLAG_AUTORESIZE);
+	for (size_t i = 0; i < 5; i++) {
+		cl_cnf_literal_t *lit = cl_cnf_literal();
+		cl_collection_add(card, lit);
+		cl_cnf_add(cnf, cl_cnf_clause(2, lit,
+					      cl_collection_get(card, 0)));
+	}
+	fail_unless(cl_cnf_add_at_most(cnf, card, 2));
+
+	fail_unless(cl_sat_solve_components(sat, cnf, 2) != NULL);
+	fail_unless(cl_cnf_evaluate(cnf) && cl_cnf_evaluate(parity)
+		    && cl_cnf_evaluate(planted));
+	size_t count = 0;
+	for (size_t i = 0; i < 5; i++) {
+		count += cl_cnf_literal_value(cl_collection_get(card, i));
+	}
+	fail_unless(count > 0 && count <= 2);
+}
+
+END_TEST START_TEST(test_components_unsat)
+{
+	/* a component with XOR constraints has a model, the other one not */
+	cl_cnf_t *cnf = cl_cnf();
+	add_all(cnf, cl_cnf_parity(20, true, 1, NULL));
+	fail_unless(cl_cnf_detect_xors(cnf) > 0);
+	add_all(cnf, pigeonhole(6));
+	fail_unless(cl_collection_count(cl_cnf_components(cnf)) == 2);
+
+	cl_sat_t *sat = cl_sat();
+	fail_unless(cl_sat_solve_components(sat, cnf, 0) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_NONE);
+	fail_unless(cl_sat_solve_components(sat, cnf, 1) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_NONE);
+
+	/* no assumptions failed in the call */
+	cl_cnf_literal_t *p = cl_cnf_literal();
+	cl_cnf_t *other = cl_cnf();
+	cl_cnf_add(other, cl_cnf_clause(1, p));
+	cl_collection_t *assumptions = cl_cnf_clause(1, cl_cnf_literal_not(p));
+	fail_unless(cl_sat_solve_assuming(sat, other, assumptions) == NULL);
+	fail_unless(cl_collection_count(cl_sat_failed(sat)) == 1);
+	fail_unless(cl_sat_solve_components(sat, cnf, 0) == NULL);
+	fail_unless(cl_collection_count(cl_sat_failed(sat)) == 0);
+
+	/* an interrupt stops the components, and only the one call */
+	cnf = cl_cnf();
+	add_all(cnf, cl_cnf_planted(100, 4, 3, 1, NULL));
+	add_all(cnf, cl_cnf_planted(100, 4, 3, 2, NULL));
+	cl_sat_interrupt(sat);
+	fail_unless(cl_sat_solve_components(sat, cnf, 0) == NULL);
+	fail_unless(cl_sat_exhausted(sat) == CL_SAT_BUDGET_INTERRUPT);
+	fail_unless(cl_sat_solve_components(sat, cnf, 0) != NULL);
+	fail_unless(cl_sat_solve(sat, cnf) != NULL);
+}
+
 END_TEST Suite *test_suite(void)
 {
 	Suite *s = suite_create("TEST SAT");
@@ -54,6 +747,18 @@ END_TEST Suite *test_suite(void)
 	TCase *tc_core = tcase_create("TEST_SAT");
 	tcase_add_checked_fixture(tc_core, setup, teardown);
 	tcase_add_test(tc_core, test_sat);
+	tcase_add_test(tc_core, test_unsat);
+	tcase_add_test(tc_core, test_heuristic);
+	tcase_add_test(tc_core, test_phases);
+	tcase_add_test(tc_core, test_restarts);
+	tcase_add_test(tc_core, test_incremental);
+	tcase_add_test(tc_core, test_xor);
+	tcase_add_test(tc_core, test_cards);
+	tcase_add_test(tc_core, test_budgets);
+	tcase_add_test(tc_core, test_seed);
+	tcase_add_test(tc_core, test_stats);
+	tcase_add_test(tc_core, test_components);
+	tcase_add_test(tc_core, test_components_unsat);
 	suite_add_tcase(s, tc_core);
 
 	return s;